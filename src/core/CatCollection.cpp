@@ -1,6 +1,7 @@
 #include "CatCollection.hpp"
 #include "UIHelper.hpp"
 #include "ResourceManager.hpp"
+#include "../entities/CatSpecies.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -12,11 +13,10 @@ CatCollection::~CatCollection() {}
 
 void CatCollection::initCollection() {
     items.clear();
-    items.push_back({CatType::PERSIAN, "波斯猫", false, 0});
-    items.push_back({CatType::SIAMESE, "暹罗猫", false, 0});
-    items.push_back({CatType::MAINE_COON, "缅因猫", false, 0});
-    items.push_back({CatType::RAGDOLL, "布偶猫", false, 0});
-    items.push_back({CatType::BENGAL, "孟加拉猫", false, 0});
+    for (size_t i = 0; i < CatSpecies::getCount(); i++) {
+        CatType type = static_cast<CatType>(i);
+        items.push_back({type, CatSpecies::get(type).name, false, 0});
+    }
 }
 
 void CatCollection::addCat(CatType type, const std::string& name) {
@@ -145,35 +145,12 @@ void CatCollection::drawObservationView(const CollectionItem& item, bool useChin
     for(int i = 0; i < 700; i += 40) DrawLine(centerX - 350 + i, centerY - 250, centerX - 350 + i, centerY + 250, Color{30, 30, 40, 255});
     for(int i = 0; i < 500; i += 40) DrawLine(centerX - 350, centerY - 250 + i, centerX + 350, centerY - 250 + i, Color{30, 30, 40, 255});
 
-    // 设置不同品种的特征颜色和细节
-    Color primary = GRAY;
-    Color secondary = DARKGRAY;
-    Color accent = BLACK;
-    Color eye = SKYBLUE;
-
-    if (item.type == CatType::PERSIAN) {
-        primary = Color{245, 240, 230, 255}; // Cream
-        secondary = Color{220, 210, 190, 255}; // Shadow
-        eye = Color{240, 230, 140, 255}; // #F0E68C
-        accent = WHITE; // Highlight
-    } else if (item.type == CatType::SIAMESE) {
-        primary = Color{235, 220, 200, 255}; // 浅米色
-        secondary = Color{80, 60, 50, 255};  // 深褐色重点色
-        eye = Color{50, 150, 255, 255}; // 蓝眼睛
-    } else if (item.type == CatType::MAINE_COON) {
-        primary = Color{100, 95, 90, 255};  // 灰色虎斑
-        secondary = Color{60, 55, 50, 255};
-        accent = Color{40, 35, 30, 255};
-        eye = Color{150, 200, 50, 255}; // 绿眼睛
-    } else if (item.type == CatType::RAGDOLL) {
-        primary = WHITE;
-        secondary = Color{200, 210, 230, 255}; // 淡蓝色调
-        eye = Color{0, 120, 255, 255}; // 深蓝眼睛
-    } else if (item.type == CatType::BENGAL) {
-        primary = Color{210, 160, 100, 255}; // 橘褐色
-        secondary = Color{120, 80, 40, 255};  // 深色豹纹
-        eye = Color{100, 180, 50, 255}; // 绿眼睛
-    }
+    // 品种的特征颜色
+    const CatSpeciesInfo& species = CatSpecies::get(item.type);
+    Color primary = species.primaryColor;
+    Color secondary = species.secondaryColor;
+    Color accent = species.accentColor;
+    Color eye = species.eyeColor;
 
     // 基础猫咪形状 (16x16 矩阵)
     int catMatrix[16][16] = {0};
@@ -287,14 +264,7 @@ void CatCollection::drawObservationView(const CollectionItem& item, bool useChin
     bool hasFont = chineseFont.texture.id != 0;
 
     // 绘制名字 (使用 DrawTextEx 支持中文)
-    std::string displayName = item.name;
-    if (!useChinese) {
-        if (item.type == CatType::PERSIAN) displayName = "Persian Cat";
-        else if (item.type == CatType::SIAMESE) displayName = "Siamese Cat";
-        else if (item.type == CatType::MAINE_COON) displayName = "Maine Coon";
-        else if (item.type == CatType::RAGDOLL) displayName = "Ragdoll Cat";
-        else if (item.type == CatType::BENGAL) displayName = "Bengal Cat";
-    }
+    std::string displayName = useChinese ? item.name : species.englishName;
 
     Vector2 namePos = { (float)centerX - MeasureTextEx(hasFont ? chineseFont : GetFontDefault(), displayName.c_str(), 40, 2).x / 2, (float)centerY + 120 };
     if (hasFont) {
@@ -303,27 +273,10 @@ void CatCollection::drawObservationView(const CollectionItem& item, bool useChin
         DrawText(displayName.c_str(), (int)namePos.x, (int)namePos.y, 40, YELLOW);
     }
     
-    const char* desc = "";
-    const char* stats = "";
+    const char* desc = useChinese ? species.name : species.englishDescription;
+    const char* stats = useChinese ? species.traits : species.englishTraits;
     const char* backHint = useChinese ? "按 [ESC] 返回列表" : "Press [ESC] to return";
 
-    if (item.type == CatType::PERSIAN) {
-        desc = useChinese ? "波斯猫" : "Persian: Noble cat with long fluffy fur and a calm personality.";
-        stats = useChinese ? "性格: 温顺 | 稀有度: *** | 速度: 较慢" : "Temper: Gentle | Rarity: *** | Speed: Slow";
-    } else if (item.type == CatType::SIAMESE) {
-        desc = useChinese ? "暹罗猫" : "Siamese: Short-haired cat from Thailand with unique points.";
-        stats = useChinese ? "性格: 好奇 | 稀有度: *** | 速度: 极快" : "Temper: Curious | Rarity: *** | Speed: Fast";
-    } else if (item.type == CatType::MAINE_COON) {
-        desc = useChinese ? "缅因猫" : "Maine Coon: Large fluffy cat known as the 'Gentle Giant'.";
-        stats = useChinese ? "性格: 友善 | 稀有度: **** | 速度: 中等" : "Temper: Friendly | Rarity: **** | Speed: Medium";
-    } else if (item.type == CatType::RAGDOLL) {
-        desc = useChinese ? "布偶猫" : "Ragdoll: Extremely docile cat that goes limp when picked up.";
-        stats = useChinese ? "性格: 慵懒 | 稀有度: **** | 速度: 较慢" : "Temper: Lazy | Rarity: **** | Speed: Slow";
-    } else if (item.type == CatType::BENGAL) {
-        desc = useChinese ? "孟加拉猫" : "Bengal: Active cat with a beautiful wild leopard pattern.";
-        stats = useChinese ? "性格: 活跃 | 稀有度: ***** | 速度: 极快" : "Temper: Active | Rarity: ***** | Speed: Very Fast";
-    }
-
     Vector2 descPos = { (float)centerX - MeasureTextEx(hasFont ? chineseFont : GetFontDefault(), desc, 22, 1).x / 2, (float)centerY + 180 };
     Vector2 statsPos = { (float)centerX - MeasureTextEx(hasFont ? chineseFont : GetFontDefault(), stats, 20, 1).x / 2, (float)centerY + 215 };
 
@@ -361,12 +314,7 @@ void CatCollection::drawCard(const CollectionItem& item, float x, float y, bool
 
     if (item.discovered) {
         // 绘制猫咪预览（像素小图标）
-        Color primary = GRAY;
-        if (item.type == CatType::PERSIAN) primary = Color{245, 240, 230, 255};
-        else if (item.type == CatType::SIAMESE) primary = Color{235, 220, 200, 255};
-        else if (item.type == CatType::MAINE_COON) primary = Color{100, 95, 90, 255};
-        else if (item.type == CatType::RAGDOLL) primary = WHITE;
-        else if (item.type == CatType::BENGAL) primary = Color{220, 150, 60, 255};
+        Color primary = CatSpecies::get(item.type).iconColor;
         
         float pulse = selected ? sin(GetTime() * 5.0f) * 2.0f : 0;
         float px = 4.0f; // 小图标像素大小
@@ -388,14 +336,7 @@ void CatCollection::drawCard(const CollectionItem& item, float x, float y, bool
         DrawRectangle(startIconX + 5 * px, startIconY + 2 * px, px - 1, px - 1, BLACK);
         
         // 绘制名字
-        std::string displayName = item.name;
-        if (!useChinese) {
-            if (item.type == CatType::PERSIAN) displayName = "Persian";
-            else if (item.type == CatType::SIAMESE) displayName = "Siamese";
-            else if (item.type == CatType::MAINE_COON) displayName = "Maine";
-            else if (item.type == CatType::RAGDOLL) displayName = "Ragdoll";
-            else if (item.type == CatType::BENGAL) displayName = "Bengal";
-        }
+        std::string displayName = useChinese ? item.name : CatSpecies::get(item.type).shortName;
         
         if (hasFont) {
             Vector2 nameSize = MeasureTextEx(chineseFont, displayName.c_str(), 16, 1);
@@ -0,0 +1,48 @@
+#ifndef FIXEDTIMESTEP_HPP
+#define FIXEDTIMESTEP_HPP
+
+// 固定步长模拟时钟：渲染帧的时间累加到蓄水池，每攒够一个步长模拟一次
+// 模拟结果与帧率无关；渲染时用 getAlpha 在上一次和当前模拟状态之间插值
+class FixedTimestep {
+public:
+    static constexpr float DEFAULT_STEP = 1.0f / 120.0f;
+    static constexpr int DEFAULT_MAX_STEPS = 8;     // 单帧最多追赶约 67ms
+
+    explicit FixedTimestep(float step = DEFAULT_STEP, int maxStepsPerFrame = DEFAULT_MAX_STEPS)
+        : step(step), maxStepsPerFrame(maxStepsPerFrame), accumulator(0.0f), droppedTime(0.0f) {}
+
+    // 累加一帧的时间，返回本帧需要执行的模拟步数
+    // 超出追赶上限的积压直接丢弃：卡顿时游戏变慢，而不是越追越卡
+    int advance(float frameTime) {
+        if (frameTime < 0.0f) frameTime = 0.0f;
+        accumulator += frameTime;
+
+        int steps = static_cast<int>(accumulator / step);
+        if (steps > maxStepsPerFrame) {
+            droppedTime += (steps - maxStepsPerFrame) * step;
+            steps = maxStepsPerFrame;
+        }
+        accumulator -= steps * step;
+        if (accumulator >= step) accumulator = step * 0.999f;
+        return steps;
+    }
+
+    // 渲染插值系数 [0, 1)：0 为上一次模拟状态，接近 1 为当前状态
+    float getAlpha() const { return accumulator / step; }
+
+    float getStep() const { return step; }
+
+    // 因追赶上限丢弃的累计时间（秒）
+    float getDroppedTime() const { return droppedTime; }
+
+    // 暂停恢复或切换场景后清空积压
+    void reset() { accumulator = 0.0f; }
+
+private:
+    float step;
+    int maxStepsPerFrame;
+    float accumulator;
+    float droppedTime;
+};
+
+#endif // FIXEDTIMESTEP_HPP
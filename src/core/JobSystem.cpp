@@ -0,0 +1,121 @@
+#include "JobSystem.hpp"
+#include <iostream>
+
+// 工作线程启动时写入自己的编号，其他线程保持 0
+static thread_local unsigned currentWorker = 0;
+
+JobSystem::JobSystem(unsigned workerCount) : batch(0), stopping(false), remainingTasks(0) {
+    if (workerCount == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 0;
+    }
+
+    for (unsigned i = 0; i <= workerCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 1; i <= workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    std::cout << "任务线程池: " << getThreadCount() << " 个线程" << std::endl;
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+unsigned JobSystem::getCurrentWorker() {
+    return currentWorker;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunction& function) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    // 只有一块或没有工作线程时不必分发
+    if (count <= grain || workers.empty()) {
+        function(0, count, currentWorker);
+        return;
+    }
+
+    // 切块后轮流放进各线程的队列
+    size_t taskCount = (count + grain - 1) / grain;
+    remainingTasks.store(taskCount, std::memory_order_relaxed);
+    for (size_t i = 0; i < taskCount; i++) {
+        size_t begin = i * grain;
+        size_t end = begin + grain < count ? begin + grain : count;
+        WorkerQueue& queue = *queues[i % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({&function, begin, end});
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch++;
+    }
+    condition.notify_all();
+
+    // 调用线程也干活，直到所有块都执行完
+    while (remainingTasks.load(std::memory_order_acquire) > 0) {
+        if (!runTask(0)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::workerLoop(unsigned worker) {
+    currentWorker = worker;
+    uint64_t seenBatch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this, seenBatch] { return stopping || batch != seenBatch; });
+            if (stopping) return;
+            seenBatch = batch;
+        }
+
+        // 队列空了但还有块在别的线程执行时短暂让出，批次结束后回去等待
+        while (remainingTasks.load(std::memory_order_acquire) > 0) {
+            if (!runTask(worker)) std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runTask(unsigned worker) {
+    Task task;
+    if (!popTask(worker, task) && !stealTask(worker, task)) return false;
+
+    (*task.function)(task.begin, task.end, worker);
+    remainingTasks.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::popTask(unsigned worker, Task& task) {
+    WorkerQueue& queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool JobSystem::stealTask(unsigned thief, Task& task) {
+    // 从下一个线程开始找，避免所有线程都去偷同一个
+    size_t queueCount = queues.size();
+    for (size_t offset = 1; offset < queueCount; offset++) {
+        WorkerQueue& queue = *queues[(thief + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// 任务线程池：每个线程一个双端队列，自己从队尾取，空闲时从其他线程的队头偷
+// parallelFor 把区间切块后轮流放进各线程的队列，调用线程也参与执行，全部完成后才返回；
+// 块的划分只取决于 count 和 grain，与线程数、谁执行无关
+class JobSystem {
+public:
+    // 处理 [begin, end)，worker 为执行线程的编号
+    using RangeFunction = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+    // workerCount 为额外启动的工作线程数，0 表示 CPU 核数减一
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    // 持有线程，禁止拷贝
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 参与执行的线程数（工作线程 + 调用线程），可用来分配每线程的缓冲区
+    unsigned getThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // 并行处理 [0, count)，每块最多 grain 个；只有一块时直接在调用线程执行
+    // 同一时间只允许一个线程调用
+    void parallelFor(size_t count, size_t grain, const RangeFunction& function);
+
+    // 当前线程的编号：工作线程为 1..N，调用 parallelFor 的线程和其他线程为 0
+    static unsigned getCurrentWorker();
+
+private:
+    struct Task {
+        const RangeFunction* function;
+        size_t begin;
+        size_t end;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned worker);
+
+    // 取一个任务执行（先自己的队列，再偷别人的），没有任务时返回 false
+    bool runTask(unsigned worker);
+    bool popTask(unsigned worker, Task& task);
+    bool stealTask(unsigned thief, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;   // 0 为调用线程
+    std::vector<std::thread> workers;
+
+    // 唤醒工作线程：batch 每次 parallelFor 加一
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint64_t batch;
+    bool stopping;
+
+    std::atomic<size_t> remainingTasks;
+};
+
+#endif // JOBSYSTEM_HPP
@@ -1,8 +1,10 @@
 #include "Meowdex.hpp"
 #include "ResourceManager.hpp"
 #include "UIHelper.hpp"
+#include "../entities/CatSpecies.hpp"
 #include "rlgl.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -268,13 +270,13 @@ void Meowdex::drawDetailView(Font font, bool hasFont) {
     if (hasFont) DrawTextEx(font, title.c_str(), {40, 40}, 30, 2, GOLD);
 
     // --- 核心展示区：放大版猫咪 ---
-    float breath = sinf(detailAnimationTimer * 3.0f) * 0.2f + catBounceY;
+    float breath = std::sin(detailAnimationTimer * 3.0f) * 0.2f + catBounceY;
     
     if (!is3DMode) {
         // --- 2D 像素风展示 ---
         float centerX = 250, centerY = 300;
         float scale = 6.0f; 
-        float pixelBounce = (sinf(detailAnimationTimer * 3.0f) * 5.0f) - (catBounceY * 20.0f);
+        float pixelBounce = (std::sin(detailAnimationTimer * 3.0f) * 5.0f) - (catBounceY * 20.0f);
         
         // 身体
         DrawRectangle(centerX - 40, centerY - 20 + pixelBounce, 80, 60, WHITE);
@@ -284,7 +286,7 @@ void Meowdex::drawDetailView(Font font, bool hasFont) {
         DrawTriangle({centerX - 35, centerY - 60 + pixelBounce * 0.5f}, {centerX - 45, centerY - 80 + pixelBounce * 0.5f}, {centerX - 20, centerY - 60 + pixelBounce * 0.5f}, WHITE);
         DrawTriangle({centerX + 15, centerY - 60 + pixelBounce * 0.5f}, {centerX + 25, centerY - 80 + pixelBounce * 0.5f}, {centerX + 5, centerY - 60 + pixelBounce * 0.5f}, WHITE);
         // 眼睛
-        if (sinf(detailAnimationTimer * 2.0f) > -0.8f) {
+        if (std::sin(detailAnimationTimer * 2.0f) > -0.8f) {
             DrawCircle(centerX - 20, centerY - 40 + pixelBounce * 0.5f, 5, BLACK);
             DrawCircle(centerX + 5, centerY - 40 + pixelBounce * 0.5f, 5, BLACK);
         }
@@ -294,15 +296,7 @@ void Meowdex::drawDetailView(Font font, bool hasFont) {
             rlPushMatrix();
                 rlRotatef(rotationAngle, 0, 1, 0); 
                 
-                Color catColor = WHITE;
-                switch(selectedType) {
-                    case CatType::SIAMESE: catColor = { 235, 200, 175, 255 }; break;
-                    case CatType::PERSIAN: catColor = WHITE; break;
-                    case CatType::MAINE_COON: catColor = { 100, 80, 60, 255 }; break;
-                    case CatType::RAGDOLL: catColor = { 245, 245, 250, 255 }; break;
-                    case CatType::BENGAL: catColor = { 210, 140, 60, 255 }; break;
-                    default: catColor = WHITE; break;
-                }
+                Color catColor = CatSpecies::get(selectedType).modelColor;
                 
                 // 绘制猫咪模型 (使用 breath 和 catBounceY)
                 DrawCube({ 0, breath, 0 }, 4.0f, 3.0f, 2.5f, catColor);
@@ -362,11 +356,11 @@ void Meowdex::drawDetailView(Font font, bool hasFont) {
 }
 
 void Meowdex::initEntries() {
-    entries[CatType::PERSIAN] = {CatType::PERSIAN, "波斯猫", 0, false, {}, "高贵优雅，毛发蓬松。虽然动作缓慢，但对猫薄荷有着惊人的执着。"};
-    entries[CatType::SIAMESE] = {CatType::SIAMESE, "暹罗猫", 0, false, {}, "聪明伶俐，好奇心强。它们擅长绕开玩家的捕捉，需要一点耐心。"};
-    entries[CatType::MAINE_COON] = {CatType::MAINE_COON, "缅因猫", 0, false, {}, "猫中巨人，性格温顺。虽然体型庞大，但跑起来却意外地轻盈。"};
-    entries[CatType::RAGDOLL] = {CatType::RAGDOLL, "布偶猫", 0, false, {}, "像布娃娃一样柔软。它们非常容易被猫薄荷吸引，是最容易捕捉的品种。"};
-    entries[CatType::BENGAL] = {CatType::BENGAL, "孟加拉猫", 0, false, {}, "充满野性活力。速度极快，对危险感知敏锐，是捕捉者的终极挑战。"};
+    for (size_t i = 0; i < CatSpecies::getCount(); i++) {
+        CatType type = static_cast<CatType>(i);
+        const CatSpeciesInfo& species = CatSpecies::get(type);
+        entries[type] = {type, species.name, 0, false, {}, species.description};
+    }
 }
 
 void Meowdex::recordCapture(const Cat& cat) {
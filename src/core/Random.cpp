@@ -0,0 +1,57 @@
+#include "Random.hpp"
+#include <random>
+
+Pcg32::Pcg32() : Pcg32(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL) {
+}
+
+Pcg32::Pcg32(uint64_t seed, uint64_t stream) : state(0), increment((stream << 1u) | 1u) {
+    // PCG 参考实现的初始化顺序
+    (*this)();
+    state += seed;
+    (*this)();
+}
+
+int Pcg32::nextInt(int minValue, int maxValue) {
+    if (maxValue <= minValue) return minValue;
+
+    uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(maxValue) - minValue + 1);
+    if (range == 0) return static_cast<int>((*this)());  // 整个 32 位范围
+
+    // 丢弃落在不完整区间的值，避免取模偏差
+    uint32_t threshold = (0u - range) % range;
+    while (true) {
+        uint32_t value = (*this)();
+        if (value >= threshold) {
+            return static_cast<int>(static_cast<int64_t>(minValue) + value % range);
+        }
+    }
+}
+
+Pcg32 Pcg32::split() {
+    // 逐个取数：同一表达式里两次调用的求值顺序不确定，会让不同编译器得到不同序列
+    uint64_t seedHigh = (*this)();
+    uint64_t seedLow = (*this)();
+    uint64_t streamHigh = (*this)();
+    uint64_t streamLow = (*this)();
+    return Pcg32((seedHigh << 32) | seedLow, (streamHigh << 32) | streamLow);
+}
+
+RandomService& RandomService::getInstance() {
+    static RandomService instance;
+    return instance;
+}
+
+RandomService::RandomService() : worldSeed(0) {
+    // 没有指定种子时只在启动时读一次系统熵
+    std::random_device device;
+    uint64_t high = device();
+    uint64_t low = device();
+    setWorldSeed((high << 32) | low);
+}
+
+void RandomService::setWorldSeed(uint64_t seed) {
+    worldSeed = seed;
+    for (size_t i = 0; i < streams.size(); i++) {
+        streams[i] = Pcg32(seed, i);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+// PCG32 随机数生成器（XSH-RR 变体）：16 字节状态，没有系统调用，相同种子和流号得到相同序列
+// 满足 UniformRandomBitGenerator，也可以直接用 gen() % n
+class Pcg32 {
+public:
+    using result_type = uint32_t;
+
+    Pcg32();
+    Pcg32(uint64_t seed, uint64_t stream);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        uint64_t oldState = state;
+        state = oldState * MULTIPLIER + increment;
+        uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+        uint32_t rotation = static_cast<uint32_t>(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31u));
+    }
+
+    // [minValue, maxValue] 内均匀分布的整数（无取模偏差），与 GetRandomValue 的区间约定一致
+    int nextInt(int minValue, int maxValue);
+
+    // [0, 1) 内的浮点数
+    float nextFloat() { return static_cast<float>((*this)() >> 8) * (1.0f / 16777216.0f); }
+
+    // [minValue, maxValue) 内的浮点数
+    float nextFloat(float minValue, float maxValue) { return minValue + (maxValue - minValue) * nextFloat(); }
+
+    // 从当前序列派生一个独立的子生成器（新种子和新流号都取自本生成器）
+    Pcg32 split();
+
+private:
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    uint64_t state;
+    uint64_t increment;    // 流号，必须为奇数
+};
+
+// 各子系统的随机流：每个子系统从自己的流取数，互不影响彼此的序列
+enum class RandomStream : uint32_t {
+    CATS,       // 猫咪外观、性格和 AI
+    SPAWNER,    // 刷新猫咪的品种、名字和出生点
+    BATTLE,     // 战斗命中、伤害、敌方决策和升级成长
+    EFFECTS,    // 屏幕震动等只影响画面的效果
+    PLAYER,     // 无图形模拟中随机游走的玩家
+    COUNT
+};
+
+// 全局随机服务：所有随机流都由一个世界种子派生，同一种子可以完整复现一局游戏
+// 只在主线程使用
+class RandomService {
+public:
+    static RandomService& getInstance();
+
+    // 重新设置世界种子，所有流回到初始状态（需在创建游戏对象之前调用）
+    void setWorldSeed(uint64_t seed);
+    uint64_t getWorldSeed() const { return worldSeed; }
+
+    // 子系统的共享流
+    Pcg32& stream(RandomStream id) { return streams[static_cast<std::size_t>(id)]; }
+
+    // 从子系统的流派生一个独立生成器，供每个对象单独持有
+    Pcg32 split(RandomStream id) { return stream(id).split(); }
+
+private:
+    RandomService();
+
+    RandomService(const RandomService&) = delete;
+    RandomService& operator=(const RandomService&) = delete;
+
+    uint64_t worldSeed;
+    std::array<Pcg32, static_cast<std::size_t>(RandomStream::COUNT)> streams;
+};
+
+#endif // RANDOM_HPP
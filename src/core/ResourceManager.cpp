@@ -55,6 +55,21 @@ Texture2D ResourceManager::getTexture(const std::string& path) {
     return loadTexture(path);
 }
 
+Image ResourceManager::loadImage(const std::string& path) {
+    return LoadImage(findValidPath(path).c_str());
+}
+
+Texture2D ResourceManager::loadTextureFromImage(const std::string& path, const Image& image) {
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        return it->second;
+    }
+    
+    Texture2D texture = LoadTextureFromImage(image);
+    textures[path] = texture;
+    return texture;
+}
+
 Sound ResourceManager::loadSound(const std::string& path) {
     // 检查是否已加载
     auto it = sounds.find(path);
@@ -16,6 +16,12 @@ public:
     // 获取已加载的纹理
     Texture2D getTexture(const std::string& path);
     
+    // 只在 CPU 上解码图片，不访问缓存，可在工作线程调用
+    Image loadImage(const std::string& path);
+    
+    // 用已解码的图片创建纹理并按 path 缓存（必须在主线程调用），已缓存时直接返回
+    Texture2D loadTextureFromImage(const std::string& path, const Image& image);
+    
     // 加载并缓存音效
     Sound loadSound(const std::string& path);
     
@@ -1,9 +1,11 @@
 #include "StartScreen.hpp"
 #include <iostream>
+#include <cmath>
 
 StartScreen::StartScreen() 
     : titleY(-50.0f), subtitleY((float)GetScreenHeight() + 50.0f), buttonY((float)GetScreenHeight() + 100.0f), timer(0.0f),
-      entranceAnim(0.0f), hoverProgress(0.0f), arrowOffset(0.0f), mouseGlowPos({0, 0}) {
+      entranceAnim(0.0f), hoverProgress(0.0f), arrowOffset(0.0f), mouseGlowPos({0, 0}),
+      loading(false), loadProgress(0.0f), displayedProgress(0.0f) {
     // 初始化背景粒子
     for (int i = 0; i < 50; i++) {
         particles.push_back({
@@ -30,6 +32,11 @@ void StartScreen::update(float deltaTime) {
     mouseGlowPos.x += (targetMouse.x - mouseGlowPos.x) * 10.0f * deltaTime;
     mouseGlowPos.y += (targetMouse.y - mouseGlowPos.y) * 10.0f * deltaTime;
     
+    // 进度条平滑追赶实际进度
+    if (loading) {
+        displayedProgress += (loadProgress - displayedProgress) * fminf(1.0f, 8.0f * deltaTime);
+    }
+    
     // 更新粒子（保留一些环境氛围）
     for (auto& p : particles) {
         p.position.x += p.velocity.x;
@@ -75,12 +82,37 @@ void StartScreen::draw() {
     UIHelper::DrawTextCentered("Catch 'em all with soul and pixel", 
                               titleYPos + 90, 22, Fade(Color{148, 163, 184, 255}, alpha));
 
-    // 6. Call-to-action 按钮
-    drawStartButton();
+    // 6. Call-to-action 按钮（加载中显示进度条）
+    if (loading) {
+        drawLoadingBar();
+    } else {
+        drawStartButton();
+    }
 
     // 7. 底部提示 (Tailwind: text-slate-500)
-    UIHelper::DrawTextCentered("Press [SPACE] or Click to begin journey", 
-                              (float)GetScreenHeight() - 60.0f, 16, Fade(Color{100, 116, 139, 255}, alpha));
+    const char* hint = loading ? "Preparing the hunting ground..." : "Press [SPACE] or Click to begin journey";
+    UIHelper::DrawTextCentered(hint, (float)GetScreenHeight() - 60.0f, 16, Fade(Color{100, 116, 139, 255}, alpha));
+}
+
+void StartScreen::drawLoadingBar() {
+    float centerX = GetScreenWidth() / 2.0f;
+    float centerY = 400 + (1.0f - entranceAnim) * 30.0f;
+    
+    // 轨道 (Tailwind: bg-slate-700 rounded-full)
+    Rectangle track = { centerX - 160.0f, centerY + 10.0f, 320.0f, 10.0f };
+    DrawRectangleRounded(track, 1.0f, 8, Color{51, 65, 85, 255});
+    
+    // 填充 (Tailwind: bg-sky-400)
+    float progress = fmaxf(0.0f, fminf(1.0f, displayedProgress));
+    if (progress > 0.0f) {
+        Rectangle fill = { track.x, track.y, track.width * progress, track.height };
+        DrawRectangleRounded(fill, 1.0f, 8, SKYBLUE);
+    }
+    
+    // 进度文字，末尾的点随时间跳动
+    int dots = static_cast<int>(timer * 3.0f) % 4;
+    const char* label = TextFormat("Loading map%.*s %d%%", dots, "...", static_cast<int>(progress * 100.0f));
+    UIHelper::DrawTextCentered(label, centerY - 20.0f, 20, Color{226, 232, 240, 255});
 }
 
 void StartScreen::drawStartButton() {
@@ -129,6 +161,8 @@ void StartScreen::drawTitle() {
 }
 
 bool StartScreen::shouldStartGame() {
+    if (loading) return false;
+    
     float centerX = GetScreenWidth() / 2.0f;
     float centerY = 400;
     
@@ -141,3 +175,23 @@ bool StartScreen::shouldStartGame() {
     bool clicked = CheckCollisionPointRec(GetMousePosition(), hitBox) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
     return clicked || IsKeyPressed(KEY_SPACE);
 }
+
+void StartScreen::beginLoading() {
+    loading = true;
+    loadProgress = 0.0f;
+    displayedProgress = 0.0f;
+}
+
+void StartScreen::finishLoading() {
+    loading = false;
+    loadProgress = 1.0f;
+    displayedProgress = 1.0f;
+}
+
+bool StartScreen::isLoading() const {
+    return loading;
+}
+
+void StartScreen::setLoadProgress(float progress) {
+    loadProgress = progress;
+}
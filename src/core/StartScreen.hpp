@@ -19,6 +19,11 @@ private:
     float arrowOffset;       // For the -> animation
     Vector2 mouseGlowPos;    // Following mouse
     
+    // 地图加载进度
+    bool loading;
+    float loadProgress;      // 0.0 to 1.0，来自地图加载器
+    float displayedProgress; // 平滑后的显示进度
+    
     struct Particle {
         Vector2 position;
         Vector2 velocity;
@@ -40,6 +45,14 @@ public:
     // 检查是否开始游戏
     bool shouldStartGame();
     
+    // 进入/退出加载状态（加载期间用进度条替换开始按钮）
+    void beginLoading();
+    void finishLoading();
+    bool isLoading() const;
+    
+    // 更新加载进度
+    void setLoadProgress(float progress);
+    
 private:
     // 绘制标题动画
     void drawTitle();
@@ -47,6 +60,9 @@ private:
     // 绘制开始按钮
     void drawStartButton();
     
+    // 绘制加载进度条
+    void drawLoadingBar();
+    
     // 绘制背景
     void drawBackground();
 };
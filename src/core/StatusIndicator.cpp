@@ -8,27 +8,25 @@ StatusIndicator::StatusIndicator()
     fleeingConfig = {"⚡", YELLOW, 1.2f, 2.0f};
     catnippedConfig = {"🌿", GREEN, 1.5f, 1.5f};
     caughtConfig = {"✨", GOLD, 1.3f, 1.8f};
+    
+    for (size_t i = 0; i < icons.size(); i++) {
+        CatStatus status = static_cast<CatStatus>(i);
+        icons[i] = StatusIcon(status, getStatusColor(status));
+    }
 }
 
 void StatusIndicator::update(float deltaTime) {
     updateAnimations(deltaTime);
     updatePulseEffect(deltaTime);
     
-    // 更新所有活跃图标
-    for (auto& icon : activeIcons) {
-        applyPulseEffect(*icon);
-        applyBounceEffect(*icon);
-        applyFadeEffect(*icon, deltaTime);
+    // 更新所有活跃图标，透明度为0的图标隐藏
+    for (auto& icon : icons) {
+        if (!icon.active) continue;
+        applyPulseEffect(icon);
+        applyBounceEffect(icon);
+        applyFadeEffect(icon, deltaTime);
+        if (icon.alpha <= 0.0f) icon.active = false;
     }
-    
-    // 移除透明度为0的图标
-    activeIcons.erase(
-        std::remove_if(activeIcons.begin(), activeIcons.end(),
-            [](const std::unique_ptr<StatusIcon>& icon) {
-                return icon->alpha <= 0.0f;
-            }),
-        activeIcons.end()
-    );
 }
 
 void StatusIndicator::draw() {
@@ -36,23 +34,22 @@ void StatusIndicator::draw() {
 }
 
 void StatusIndicator::drawAt(float x, float y, CatStatus status) {
-    if (activeIcons.empty()) return;
-    
     // 在指定位置绘制所有活跃图标
-    for (const auto& icon : activeIcons) {
-        drawIcon(*icon, x, y);
+    for (const auto& icon : icons) {
+        if (!icon.active) continue;
+        drawIcon(icon, x, y);
         y += 25; // 垂直堆叠图标
     }
 }
 
 void StatusIndicator::showStatus(float x, float y, CatStatus status) {
-    // 清除之前的图标
-    activeIcons.clear();
+    // 隐藏之前的图标，换成新的状态图标
+    for (auto& icon : icons) {
+        icon.active = false;
+    }
     
-    // 创建新的状态图标
-    StatusIcon* newIcon = createIcon(status);
-    if (newIcon) {
-        activeIcons.push_back(std::unique_ptr<StatusIcon>(newIcon));
+    if (status < CatStatus::COUNT) {
+        activateIcon(status);
         animationTimer = 0.0f;
         pulseTimer = 0.0f;
     }
@@ -60,9 +57,16 @@ void StatusIndicator::showStatus(float x, float y, CatStatus status) {
 
 void StatusIndicator::hideStatus() {
     // 开始淡出动画
-    for (auto& icon : activeIcons) {
-        icon->alpha = std::max(0.0f, icon->alpha - 0.1f);
+    for (auto& icon : icons) {
+        if (icon.active) icon.alpha = std::max(0.0f, icon.alpha - 0.1f);
+    }
+}
+
+bool StatusIndicator::isActive() const {
+    for (const auto& icon : icons) {
+        if (icon.active) return true;
     }
+    return false;
 }
 
 void StatusIndicator::setFleeingIcon(const std::string& text, Color color) {
@@ -80,13 +84,21 @@ void StatusIndicator::setCaughtIcon(const std::string& text, Color color) {
     caughtConfig.color = color;
 }
 
+void StatusIndicator::clearStatus() {
+    for (auto& icon : icons) {
+        icon.active = false;
+    }
+    animationTimer = 0.0f;
+    pulseTimer = 0.0f;
+}
+
 void StatusIndicator::resetAnimation() {
     animationTimer = 0.0f;
     pulseTimer = 0.0f;
-    for (auto& icon : activeIcons) {
-        icon->scale = 1.0f;
-        icon->rotation = 0.0f;
-        icon->alpha = 1.0f;
+    for (auto& icon : icons) {
+        icon.scale = 1.0f;
+        icon.rotation = 0.0f;
+        icon.alpha = 1.0f;
     }
 }
 
@@ -94,14 +106,16 @@ void StatusIndicator::updateAnimations(float deltaTime) {
     animationTimer += deltaTime;
     
     // 更新图标动画
-    for (auto& icon : activeIcons) {
+    for (auto& icon : icons) {
+        if (!icon.active) continue;
+        
         // 缩放动画
         float baseScale = 1.0f;
         float pulseScale = 0.1f * std::sin(animationTimer * 4.0f);
-        icon->scale = baseScale + pulseScale;
+        icon.scale = baseScale + pulseScale;
         
         // 旋转动画
-        icon->rotation += deltaTime * 30.0f; // 每秒30度
+        icon.rotation += deltaTime * 30.0f; // 每秒30度
     }
 }
 
@@ -109,18 +123,17 @@ void StatusIndicator::updatePulseEffect(float deltaTime) {
     pulseTimer += deltaTime;
 }
 
-StatusIcon* StatusIndicator::createIcon(CatStatus status) {
-    Color color = getStatusColor(status);
-    StatusIcon* icon = new StatusIcon(status, color);
+void StatusIndicator::activateIcon(CatStatus status) {
+    StatusIcon& icon = icons[static_cast<size_t>(status)];
+    icon = StatusIcon(status, getStatusColor(status));
+    icon.active = true;
     
     switch (status) {
-        case CatStatus::FLEEING: icon->scale = fleeingConfig.baseScale; break;
-        case CatStatus::CATNIPPED: icon->scale = catnippedConfig.baseScale; break;
-        case CatStatus::CAUGHT: icon->scale = caughtConfig.baseScale; break;
+        case CatStatus::FLEEING: icon.scale = fleeingConfig.baseScale; break;
+        case CatStatus::CATNIPPED: icon.scale = catnippedConfig.baseScale; break;
+        case CatStatus::CAUGHT: icon.scale = caughtConfig.baseScale; break;
         default: break;
     }
-    
-    return icon;
 }
 
 void StatusIndicator::drawIcon(const StatusIcon& icon, float x, float y) {
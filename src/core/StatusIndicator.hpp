@@ -3,14 +3,14 @@
 
 #include <raylib.h>
 #include <string>
-#include <vector>
-#include <memory>
+#include <array>
 
 enum class CatStatus {
     NORMAL,
     FLEEING,
     CATNIPPED,
-    CAUGHT
+    CAUGHT,
+    COUNT
 };
 
 struct StatusIcon {
@@ -19,14 +19,16 @@ struct StatusIcon {
     float scale;
     float rotation;
     float alpha;
+    bool active;
     
-    StatusIcon(CatStatus type, Color color) 
-        : type(type), color(color), scale(1.0f), rotation(0.0f), alpha(1.0f) {}
+    StatusIcon(CatStatus type = CatStatus::NORMAL, Color color = WHITE) 
+        : type(type), color(color), scale(1.0f), rotation(0.0f), alpha(1.0f), active(false) {}
 };
 
+// 每种状态预先留一个图标，显示和隐藏只切换 active，不分配内存（状态切换发生在并行更新中）
 class StatusIndicator {
 private:
-    std::vector<std::unique_ptr<StatusIcon>> activeIcons;
+    std::array<StatusIcon, static_cast<size_t>(CatStatus::COUNT)> icons;
     float animationTimer;
     float pulseTimer;
     
@@ -54,7 +56,8 @@ public:
     // 状态管理
     void showStatus(float x, float y, CatStatus status);
     void hideStatus();
-    bool isActive() const { return !activeIcons.empty(); }
+    void clearStatus();     // 立即清空（猫咪池回收时使用）
+    bool isActive() const;
     
     // 配置方法
     void setFleeingIcon(const std::string& text, Color color);
@@ -69,7 +72,7 @@ private:
     // 内部方法
     void updateAnimations(float deltaTime);
     void updatePulseEffect(float deltaTime);
-    StatusIcon* createIcon(CatStatus status);
+    void activateIcon(CatStatus status);
     void drawIcon(const StatusIcon& icon, float x, float y);
     Color getStatusColor(CatStatus status) const;
     std::string getStatusText(CatStatus status) const;
@@ -1,254 +1,38 @@
 #include "Cat.hpp"
-#include "core/ResourceManager.hpp"
+#include "CatSpecies.hpp"
+#include "systems/CatSystem.hpp"
+#include "systems/BehaviorTree.hpp"
+#include "systems/MapLoader.hpp"
+#include "systems/NavigationSystem.hpp"
 #include <cmath>
 #include <iostream>
-#include <memory>
-#include <random>
-
-Cat::Cat(const std::string& name, Vector2 position, CatType type)
-    : name(name), position(position), velocity({0, 0}), speed(50.0f),
-      isMoving(false), facingRight(true), breathTimer(0.0f), walkTimer(0.0f),
-      isCaught(false), currentFrame(0), frameTime(0.0f), 
-      animationSpeed(8.0f), width(40.0f), height(30.0f), 
-      legLength(10.0f), bodyFatness(1.0f), isFluffy(false),
-      sprite({0}), texturePath(""), rd(nullptr), gen(nullptr),
-      aiChangeDirectionTimer(0.0f), aiChangeDirectionInterval(2.0f + (float)(rand() % 3)),
-    type(type), smartMovePattern(0), state(CatState::NORMAL),
-    catnipTimer(0.0f), stateTimer(0.0f), color(WHITE),
-    catnipEffectTimer(0.0f), baseEffectTime(10.0f), catnipPosition({0, 0}),
-      earAngle(0.0f), eyeSize(1.0f), whiskerLength(1.0f), tailStyle(0.0f),
-      isShiny(false), personality(CatPersonality::NORMAL), personalityTimer(0.0f) {
-    
-    // 初始化随机数生成器
-    rd = std::make_unique<std::random_device>();
-    gen = std::make_unique<std::mt19937>((*rd)());
-    
-    // 初始化动画计时器
-    breathTimer = static_cast<float>(gen->operator()() % 100) / 10.0f;
-    walkTimer = 0.0f;
-    blinkTimer = 2.0f + static_cast<float>(gen->operator()() % 30) / 10.0f;
-    blinkDuration = 0.15f;
-    isBlinking = false;
-    tailWagTimer = static_cast<float>(gen->operator()() % 100) / 10.0f;
-    
-    // 随机印象属性
-    earAngle = 0.0f;
-    eyeSize = 0.9f + static_cast<float>(gen->operator()() % 3) / 10.0f;
-    whiskerLength = 0.8f + static_cast<float>(gen->operator()() % 5) / 10.0f;
-    tailStyle = 0.8f + static_cast<float>(gen->operator()() % 5) / 10.0f;
-    
-    // 随机稀有度 (5% 概率为闪光猫)
-    isShiny = (gen->operator()() % 100) < 5;
-    if (isShiny) {
-        // 闪光猫特效颜色
-        int effectType = gen->operator()() % 3;
-        if (effectType == 0) shinyEffectColor = GOLD;
-        else if (effectType == 1) shinyEffectColor = SKYBLUE;
-        else shinyEffectColor = PINK;
-    }
 
-    // 随机性格
-    int pType = gen->operator()() % 4;
-    if (pType == 1) personality = CatPersonality::COWARD;
-    else if (pType == 2) personality = CatPersonality::GREEDY;
-    else if (pType == 3) personality = CatPersonality::CURIOUS;
-    else personality = CatPersonality::NORMAL;
-
-    // 根据品种设置基础属性
-    if (type == CatType::PERSIAN) {
-        speed = 220.0f;       // 跑得比人快一点点
-        baseEffectTime = 15.0f;
-        color = ORANGE;
-    } else if (type == CatType::SIAMESE) {
-        speed = 280.0f;      // 矫健的品种
-        baseEffectTime = 8.0f;
-        color = BROWN;
-    } else if (type == CatType::MAINE_COON) {
-        speed = 240.0f;      // 体型大，速度中等偏上
-        baseEffectTime = 12.0f;
-        color = DARKGRAY;
-    } else if (type == CatType::RAGDOLL) {
-        speed = 210.0f;       // 温顺，速度略高于人
-        baseEffectTime = 18.0f;
-        color = LIGHTGRAY;
-    } else if (type == CatType::BENGAL) {
-        speed = 350.0f;      // 猎豹般的爆发力
-        baseEffectTime = 6.0f;
-        color = YELLOW;
-    } else {
-        speed = 250.0f;
-        baseEffectTime = 10.0f;
-        color = WHITE;
-    }
-    
-    // 初始化状态
-    state = CatState::NORMAL;
-    catnipEffectTimer = 0.0f;
-    catnipPosition = {0, 0};
-    
-    // 设置初始随机方向
-    changeRandomDirection();
-    
-    std::cout << "猫咪创建: " << name << " 位置(" << position.x << "," << position.y << ")" << std::endl;
-    
-    // 初始化状态指示器
-    statusIndicator = std::make_unique<StatusIndicator>();
-    
-    // 加载纹理
-    std::string spritePath = "";
-    if (type == CatType::PERSIAN) spritePath = "assets/sprites/cat_persian.png";
-    else if (type == CatType::SIAMESE) spritePath = "assets/sprites/cat_siamese.png";
-    else if (type == CatType::MAINE_COON) spritePath = "assets/sprites/cat_maine_coon.png";
-    else if (type == CatType::RAGDOLL) spritePath = "assets/sprites/cat_ragdoll.png";
-    else if (type == CatType::BENGAL) spritePath = "assets/sprites/cat_bengal.png";
-
-    if (!spritePath.empty()) {
-        sprite = ResourceManager::getInstance().loadTexture(spritePath);
-        if (sprite.id > 0) {
-            std::cout << "猫咪纹理加载成功: " << spritePath << std::endl;
-        } else {
-            // 尝试备用路径
-            spritePath = "../" + spritePath;
-            sprite = ResourceManager::getInstance().loadTexture(spritePath);
-            if (sprite.id > 0) {
-                std::cout << "猫咪纹理加载成功 (备用路径): " << spritePath << std::endl;
-            }
-        }
-    }
+// 寻路参数
+static constexpr float REPATH_INTERVAL = 1.0f;          // 最长多久重新规划一次（秒）
+static constexpr float REPATH_DISTANCE = 48.0f;         // 目标移动超过该距离立即重新规划
+static constexpr float WAYPOINT_RADIUS = 12.0f;         // 到达拐点的判定半径
+static constexpr float FLEE_TARGET_DISTANCE = 256.0f;   // 逃跑时的目标点距离
 
-    if (sprite.id == 0) {
-        std::cout << "猫咪创建: " << name << " (使用程序化绘制)" << std::endl;
-    } else {
-        std::cout << "猫咪创建: " << name << " (使用纹理: " << spritePath << ")" << std::endl;
-    }
-}
-
-Cat::Cat(const std::string& name, float x, float y, CatType type)
-    : Cat(name, {x, y}, type) {}
-
-Cat::~Cat() {
-    // 资源由 unique_ptr 自动管理
-}
-
-// 移动构造函数
-Cat::Cat(Cat&& other) noexcept
-    : name(std::move(other.name)), position(other.position), velocity(other.velocity),
-      speed(other.speed), isMoving(other.isMoving), facingRight(other.facingRight), 
-      isCaught(other.isCaught), currentFrame(other.currentFrame), frameTime(other.frameTime), 
-      animationSpeed(other.animationSpeed), width(other.width), height(other.height),
-      legLength(other.legLength), bodyFatness(other.bodyFatness), isFluffy(other.isFluffy),
-      sprite(other.sprite), texturePath(std::move(other.texturePath)),
-      rd(std::move(other.rd)), gen(std::move(other.gen)), type(other.type), state(other.state),
-      catnipEffectTimer(other.catnipEffectTimer), baseEffectTime(other.baseEffectTime),
-      catnipPosition(other.catnipPosition), catnipTimer(other.catnipTimer),
-      stateTimer(other.stateTimer), smartMovePattern(other.smartMovePattern),
-      aiChangeDirectionTimer(other.aiChangeDirectionTimer), 
-      aiChangeDirectionInterval(other.aiChangeDirectionInterval),
-      earAngle(other.earAngle), eyeSize(other.eyeSize), 
-      whiskerLength(other.whiskerLength), tailStyle(other.tailStyle),
-      statusIndicator(std::move(other.statusIndicator)), color(other.color) {
-    
-    // 将源对象的资源置空
-    other.sprite.id = 0;
-}
-
-// 移动赋值运算符
-Cat& Cat::operator=(Cat&& other) noexcept {
-    if (this != &other) {
-        // 移动数据
-        name = std::move(other.name);
-        position = other.position;
-        velocity = other.velocity;
-        speed = other.speed;
-        isMoving = other.isMoving;
-        facingRight = other.facingRight;
-        isCaught = other.isCaught;
-        currentFrame = other.currentFrame;
-        frameTime = other.frameTime;
-        animationSpeed = other.animationSpeed;
-        width = other.width;
-        height = other.height;
-        legLength = other.legLength;
-        bodyFatness = other.bodyFatness;
-        isFluffy = other.isFluffy;
-        sprite = other.sprite;
-        texturePath = std::move(other.texturePath);
-        rd = std::move(other.rd);
-        gen = std::move(other.gen);
-        type = other.type;
-        state = other.state;
-        catnipEffectTimer = other.catnipEffectTimer;
-        baseEffectTime = other.baseEffectTime;
-        catnipPosition = other.catnipPosition;
-        catnipTimer = other.catnipTimer;
-        stateTimer = other.stateTimer;
-        smartMovePattern = other.smartMovePattern;
-        aiChangeDirectionTimer = other.aiChangeDirectionTimer;
-        aiChangeDirectionInterval = other.aiChangeDirectionInterval;
-        earAngle = other.earAngle;
-        eyeSize = other.eyeSize;
-        whiskerLength = other.whiskerLength;
-        tailStyle = other.tailStyle;
-        statusIndicator = std::move(other.statusIndicator);
-        color = other.color;
-        
-        // 将源对象的资源置空
-        other.sprite.id = 0;
-    }
-    return *this;
-}
-
-void Cat::update(float deltaTime, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip, int capturedCount) {
-    if (isCaught) return;
-    
-    updateTimers(deltaTime);
-    updateState(playerPosition, catnipPosition, hasCatnip, capturedCount, deltaTime);
-    updateMovement(deltaTime);
-    updateAI(deltaTime, playerPosition);
-    updateStatusIndicator(deltaTime);
-    
-    // 更新位置
-    position.x += velocity.x * deltaTime;
-    position.y += velocity.y * deltaTime;
-    
-    // 更新转向
-    if (std::abs(velocity.x) > 0.1f) {
-        facingRight = (velocity.x > 0);
-    }
-    
-    // 更新动画计时器
-    breathTimer += deltaTime;
-    if (isMoving) {
-        walkTimer += deltaTime * (speed / 20.0f);
-    } else {
-        walkTimer = 0.0f;
-    }
-    
-    // 检查边界
-    checkBoundaries(800, 600); // 假设屏幕大小为800x600
-}
+void Cat::draw(float alpha) {
+    if (system->caught[index]) return;
 
-void Cat::draw() {
-    if (isCaught) return;
+    const Vector2 position = getRenderPosition(alpha);
+    const float width = system->sizes[index].x;
+    const float height = system->sizes[index].y;
+    const CatState state = system->states[index];
+    const bool isMoving = system->moving[index] != 0;
+    const char* name = system->names[index];
 
     // --- 核心比例调整 (参考星露谷物语：短小精悍，可爱的侧身/正脸混合) ---
     const float p = 3.0f;
     Color shadowColor = { 0, 0, 0, 50 };
-    
+
     // 颜色配置 (更符合星露谷的柔和调色盘)
-    Color bodyColor = color;
+    Color bodyColor = CatSpecies::get(system->types[index]).bodyColor;
     Color eyeColor = (state == CatState::CATNIPPED) ? PINK : Color{ 40, 40, 40, 255 };
-    
-    switch (type) {
-        case CatType::PERSIAN: bodyColor = { 245, 245, 240, 255 }; break;
-        case CatType::SIAMESE: bodyColor = { 230, 200, 180, 255 }; break;
-        case CatType::MAINE_COON: bodyColor = { 100, 80, 60, 255 }; break;
-        case CatType::RAGDOLL: bodyColor = { 240, 240, 250, 255 }; break;
-        default: break;
-    }
 
     Vector2 center = { position.x + width/2.0f, position.y + height/2.0f };
-    float dir = facingRight ? 1.0f : -1.0f;
+    float dir = system->facingRight[index] ? 1.0f : -1.0f;
     float walk = isMoving ? sinf((float)GetTime() * 10.0f) : 0.0f;
     float breath = sinf((float)GetTime() * 3.0f) * 0.4f;
 
@@ -289,126 +73,71 @@ void Cat::draw() {
     DrawRectangleRec({ center.x + 2*p, legY - walk*2, p, p }, bodyColor);
 
     // 7. UI
-    DrawText(name.c_str(), (int)(center.x - MeasureText(name.c_str(), 10)/2), (int)(position.y - 15), 10, Fade(BLACK, 0.7f));
-    
-    drawStatusIndicator();
+    DrawText(name, (int)(center.x - MeasureText(name, 10)/2), (int)(position.y - 15), 10, Fade(BLACK, 0.7f));
+
+    drawStatusIndicator(alpha);
 }
 
 void Cat::updateTimers(float deltaTime) {
     // 更新各种计时器
-    if (catnipTimer > 0) catnipTimer -= deltaTime;
-    if (stateTimer > 0) stateTimer -= deltaTime;
-    if (aiChangeDirectionTimer > 0) aiChangeDirectionTimer -= deltaTime;
-    if (catnipEffectTimer > 0) catnipEffectTimer -= deltaTime;
-    
+    if (system->stateTimers[index] > 0) system->stateTimers[index] -= deltaTime;
+    if (system->aiChangeDirectionTimers[index] > 0) system->aiChangeDirectionTimers[index] -= deltaTime;
+    if (system->catnipEffectTimers[index] > 0) system->catnipEffectTimers[index] -= deltaTime;
+
     // 更新动画计时器
-    breathTimer += deltaTime;
-    walkTimer += deltaTime;
-    tailWagTimer += deltaTime;
-    
+    CatAnimation& animation = system->animations[index];
+    animation.breathTimer += deltaTime;
+    animation.walkTimer += deltaTime;
+    animation.tailWagTimer += deltaTime;
+
     // 眨眼逻辑
-    blinkTimer -= deltaTime;
-    if (blinkTimer <= 0) {
-        if (!isBlinking) {
-            isBlinking = true;
-            blinkTimer = blinkDuration;
+    animation.blinkTimer -= deltaTime;
+    if (animation.blinkTimer <= 0) {
+        if (!animation.isBlinking) {
+            animation.isBlinking = true;
+            animation.blinkTimer = animation.blinkDuration;
         } else {
-            isBlinking = false;
-            blinkTimer = 2.0f + static_cast<float>(gen->operator()() % 40) / 10.0f; // 随机下次眨眼时间
+            animation.isBlinking = false;
+            animation.blinkTimer = 2.0f + static_cast<float>(system->rngs[index]() % 40) / 10.0f; // 随机下次眨眼时间
         }
     }
 }
 
-void Cat::updateAI(float deltaTime, Vector2 playerPos) {
-    if (isCaught) {
-        velocity = {0, 0};
-        isMoving = false;
-        return;
-    }
-
-    // 根据不同性格调整 AI 行为
-    float fleeMultiplier = 1.0f;
-    float catnipMultiplier = 1.0f;
-
-    // 性格影响基础参数
-    if (personality == CatPersonality::COWARD) {
-        fleeMultiplier *= 1.5f; // 胆小鬼跑得更快
-    }
-    if (personality == CatPersonality::GREEDY) {
-        catnipMultiplier *= 1.2f; // 贪吃的猫跑向猫薄荷更快
-    }
-
-    switch (state) {
-        case CatState::NORMAL:
-            normalAI(deltaTime, playerPos);
-            break;
-        case CatState::FLEEING:
-            fleeAI(deltaTime * fleeMultiplier);
-            break;
-        case CatState::CATNIPPED:
-            catnipAI(deltaTime * catnipMultiplier);
-            break;
-        case CatState::CAUGHT:
-            velocity = {0, 0};
-            isMoving = false;
-            break;
-        default:
-            break;
-    }
-}
+void Cat::wanderPause(float deltaTime) {
+    Pcg32& gen = system->rngs[index];
+    float& stateTimer = system->stateTimers[index];
 
-void Cat::normalAI(float deltaTime, Vector2 playerPos) {
     // 随机移动逻辑
     stateTimer -= deltaTime;
     if (stateTimer <= 0) {
-        if (gen->operator()() % 100 < 30) {
-            isMoving = true;
+        if (gen() % 100 < 30) {
+            system->moving[index] = 1;
             changeRandomDirection();
         } else {
-            isMoving = false;
-            velocity = {0, 0};
+            system->moving[index] = 0;
+            system->velocities[index] = {0, 0};
         }
-        stateTimer = (float)(gen->operator()() % 3 + 1); // 1-3秒切换一次状态
+        stateTimer = (float)(gen() % 3 + 1); // 1-3秒切换一次状态
     }
+}
 
-    // 更新AI方向改变计时器
-    aiChangeDirectionTimer += deltaTime;
-    
-    // 性格逻辑：好奇的猫会尝试靠近静止的玩家
-    if (personality == CatPersonality::CURIOUS) {
-        personalityTimer += deltaTime;
-        if (personalityTimer > 3.0f) {
-            // 检查玩家是否静止 (这里简化为距离判断)
-            float dx = position.x - playerPos.x;
-            float dy = position.y - playerPos.y;
-            float distToPlayer = std::sqrt(dx * dx + dy * dy);
-            
-            if (distToPlayer < 200.0f && distToPlayer > 50.0f) {
-                // 向玩家移动
-                Vector2 dir = {playerPos.x - position.x, playerPos.y - position.y};
-                float len = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-                if (len > 0) {
-                    velocity.x = (dir.x / len) * speed * 0.5f;
-                    velocity.y = (dir.y / len) * speed * 0.5f;
-                    isMoving = true;
-                }
-            } else if (gen->operator()() % 100 < 20) {
-                isMoving = true;
-                changeRandomDirection();
-            }
-            personalityTimer = 0.0f;
-        }
-    }
+void Cat::wanderTurn(float deltaTime) {
+    Pcg32& gen = system->rngs[index];
+    Vector2& velocity = system->velocities[index];
+    uint8_t& isMoving = system->moving[index];
+    float& aiChangeDirectionTimer = system->aiChangeDirectionTimers[index];
+    float& aiChangeDirectionInterval = system->aiChangeDirectionIntervals[index];
 
     // 随机改变方向
+    aiChangeDirectionTimer += deltaTime;
     if (aiChangeDirectionTimer >= aiChangeDirectionInterval) {
         changeRandomDirection();
         aiChangeDirectionTimer = 0.0f;
-        aiChangeDirectionInterval = 1.0f + static_cast<float>(gen->operator()() % 30) / 10.0f;
+        aiChangeDirectionInterval = 1.0f + static_cast<float>(gen() % 30) / 10.0f;
     }
-    
+
     // 随机停止/移动
-    if (gen->operator()() % 100 < 5) {
+    if (gen() % 100 < 5) {
         isMoving = !isMoving;
         if (!isMoving) {
             velocity = {0, 0};
@@ -416,103 +145,101 @@ void Cat::normalAI(float deltaTime, Vector2 playerPos) {
             changeRandomDirection();
         }
     }
-    
+
     // 保持移动
     if (isMoving && (velocity.x == 0 && velocity.y == 0)) {
         changeRandomDirection();
     }
 }
 
+bool Cat::approachPlayer(Vector2 playerPos, float speedScale, float minDistance, float maxDistance) {
+    const Vector2 position = system->positions[index];
+    Vector2 toPlayer = {playerPos.x - position.x, playerPos.y - position.y};
+    float distance = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y);
+    if (distance <= minDistance || distance >= maxDistance) return false;
+
+    // 向玩家移动
+    const float speed = system->speeds[index];
+    system->velocities[index].x = (toPlayer.x / distance) * speed * speedScale;
+    system->velocities[index].y = (toPlayer.y / distance) * speed * speedScale;
+    system->moving[index] = 1;
+    return true;
+}
+
 void Cat::fleeAI(float deltaTime) {
-    // 计算远离玩家的方向
+    const Vector2 position = system->positions[index];
+    const Vector2 catnipPosition = system->catnipPositions[index];
+
+    // 远离玩家的方向（不必归一化）
     Vector2 fleeDirection = {position.x - catnipPosition.x, position.y - catnipPosition.y};
-    
-    // 归一化
-    float length = std::sqrt(fleeDirection.x * fleeDirection.x + fleeDirection.y * fleeDirection.y);
-    if (length > 0) {
-        fleeDirection.x /= length;
-        fleeDirection.y /= length;
-    }
-    
-    // 根据品种和性格设置逃跑速度
-    float fleeMultiplier = 1.2f; // 基础逃跑速度倍率
-    if (type == CatType::BENGAL) fleeMultiplier = 1.6f;
-    else if (type == CatType::SIAMESE) fleeMultiplier = 1.4f;
-    else if (type == CatType::RAGDOLL) fleeMultiplier = 1.1f;
-
-    if (personality == CatPersonality::COWARD) {
-        fleeMultiplier *= 1.4f; // 胆小鬼逃跑动力更强
+
+    // 有寻路时朝远离方向的一个点绕障碍跑
+    float lengthSquared = fleeDirection.x * fleeDirection.x + fleeDirection.y * fleeDirection.y;
+    if (system->navigation && lengthSquared > 0) {
+        float length = std::sqrt(lengthSquared);
+        Vector2 size = system->sizes[index];
+        Vector2 center = {position.x + size.x / 2.0f, position.y + size.y / 2.0f};
+        Vector2 fleeTarget = {center.x + fleeDirection.x / length * FLEE_TARGET_DISTANCE,
+                              center.y + fleeDirection.y / length * FLEE_TARGET_DISTANCE};
+        fleeDirection = steerTowards(fleeTarget, deltaTime);
     }
-    
-    // 设置高速逃跑
-    velocity.x = fleeDirection.x * speed * fleeMultiplier;
-    velocity.y = fleeDirection.y * speed * fleeMultiplier;
-    isMoving = true;
-    
+
+    // 高速逃跑：速度已含品种和性格倍率
+    system->steerDirections[index] = fleeDirection;
+    system->steerSpeeds[index] = system->fleeSpeeds[index];
+    system->moving[index] = 1;
+
     // 聪明猫咪会尝试绕圈逃跑
-    if (type == CatType::SIAMESE && smartMovePattern % 3 == 0) {
-        velocity.x += fleeDirection.y * speed * 0.5f;
-        velocity.y -= fleeDirection.x * speed * 0.5f;
-    }
-    
+    int& smartMovePattern = system->smartMovePatterns[index];
+    bool circling = CatSpecies::get(system->types[index]).circlesWhenFleeing && smartMovePattern % 3 == 0;
+    system->steerSideSpeeds[index] = circling ? system->speeds[index] * 0.5f : 0.0f;
+
     smartMovePattern++;
-    
-    // 逃跑一段时间后恢复正常
-    if (catnipEffectTimer <= 0.0f) {
-        setState(CatState::NORMAL);
-    }
 }
 
 void Cat::catnipAI(float deltaTime) {
+    const Vector2 position = system->positions[index];
+    const Vector2 catnipPosition = system->catnipPositions[index];
+
     // 向猫薄荷位置缓慢移动
     Vector2 toCatnip = {catnipPosition.x - position.x, catnipPosition.y - position.y};
-    
-    float length = std::sqrt(toCatnip.x * toCatnip.x + toCatnip.y * toCatnip.y);
-    if (length > 0) {
-        toCatnip.x /= length;
-        toCatnip.y /= length;
-    }
-    
-    // 品种和性格影响沉迷移动速度
-    float catnipMultiplier = 0.5f;
-    if (type == CatType::RAGDOLL) catnipMultiplier = 0.3f;
-    else if (type == CatType::BENGAL) catnipMultiplier = 0.7f;
-
-    if (personality == CatPersonality::GREEDY) {
-        catnipMultiplier *= 1.2f; // 贪吃的猫跑向猫薄荷更快
+    float lengthSquared = toCatnip.x * toCatnip.x + toCatnip.y * toCatnip.y;
+
+    // 有寻路时沿路径绕开墙体
+    if (system->navigation && lengthSquared > 0) {
+        toCatnip = steerTowards(catnipPosition, deltaTime);
     }
-    
-    // 沉迷状态移动缓慢
-    velocity.x = toCatnip.x * speed * catnipMultiplier;
-    velocity.y = toCatnip.y * speed * catnipMultiplier;
-    isMoving = true;
-    
+
     // 如果靠近猫薄荷，停止移动（沉迷中）
-    if (length < 20.0f) {
-        velocity = {0, 0};
-        isMoving = false;
-    }
-    
-    // 沉迷时间结束，恢复正常
-    if (catnipEffectTimer <= 0.0f) {
-        setState(CatState::NORMAL);
-        std::cout << "猫咪恢复清醒: " << name << std::endl;
+    if (lengthSquared < 20.0f * 20.0f) {
+        system->velocities[index] = {0, 0};
+        system->moving[index] = 0;
+    } else {
+        // 沉迷状态移动缓慢：速度已含品种和性格倍率
+        system->steerDirections[index] = toCatnip;
+        system->steerSpeeds[index] = system->catnipSpeeds[index];
+        system->steerSideSpeeds[index] = 0.0f;
+        system->moving[index] = 1;
     }
 }
 
 void Cat::changeRandomDirection() {
     // 随机方向
-    int direction = gen->operator()() % 8; // 8个方向
-    
+    int direction = system->rngs[index]() % 8; // 8个方向
+
     float angle = (float)direction * 45.0f * (PI / 180.0f); // 转换为弧度
-    
-    velocity.x = cosf(angle) * speed;
-    velocity.y = sinf(angle) * speed;
-    
-    isMoving = true;
+
+    system->velocities[index].x = cosf(angle) * system->speeds[index];
+    system->velocities[index].y = sinf(angle) * system->speeds[index];
+
+    system->moving[index] = 1;
 }
 
 void Cat::checkBoundaries(int mapWidth, int mapHeight) {
+    Vector2& position = system->positions[index];
+    Vector2& velocity = system->velocities[index];
+    const Vector2 size = system->sizes[index];
+
     // 边界检测，碰到边界反弹
     if (position.x < 0) {
         position.x = 0;
@@ -522,62 +249,115 @@ void Cat::checkBoundaries(int mapWidth, int mapHeight) {
         position.y = 0;
         velocity.y = -velocity.y; // 反弹
     }
-    if (position.x + width > mapWidth) {
-        position.x = mapWidth - width;
+    if (position.x + size.x > mapWidth) {
+        position.x = mapWidth - size.x;
         velocity.x = -velocity.x; // 反弹
     }
-    if (position.y + height > mapHeight) {
-        position.y = mapHeight - height;
+    if (position.y + size.y > mapHeight) {
+        position.y = mapHeight - size.y;
         velocity.y = -velocity.y; // 反弹
     }
 }
 
-bool Cat::checkCollision(const Rectangle& playerRect) {
-    Rectangle catRect = {position.x, position.y, width, height};
-    return CheckCollisionRecs(catRect, playerRect);
+bool Cat::checkCollision(const Rectangle& playerRect) const {
+    return CheckCollisionRecs(getRect(), playerRect);
+}
+
+CatState Cat::getState() const {
+    return system->states[index];
+}
+
+const char* Cat::getName() const {
+    return system->names[index];
+}
+
+Vector2 Cat::getPosition() const {
+    return system->positions[index];
+}
+
+Vector2 Cat::getRenderPosition(float alpha) const {
+    Vector2 previous = system->previousPositions[index];
+    Vector2 current = system->positions[index];
+    return {previous.x + (current.x - previous.x) * alpha, previous.y + (current.y - previous.y) * alpha};
+}
+
+Vector2 Cat::getVelocity() const {
+    return system->velocities[index];
+}
+
+float Cat::getSpeed() const {
+    return system->speeds[index];
+}
+
+CatType Cat::getType() const {
+    return system->types[index];
+}
+
+bool Cat::isCaughtStatus() const {
+    return system->caught[index] != 0;
+}
+
+bool Cat::getIsShiny() const {
+    return system->appearances[index].isShiny;
+}
+
+CatPersonality Cat::getPersonality() const {
+    return system->personalities[index];
+}
+
+Color Cat::getCatColor() const {
+    return system->appearances[index].color;
 }
 
 void Cat::setPosition(Vector2 pos) {
-    position = pos;
+    // 瞬移不插值
+    system->positions[index] = pos;
+    system->previousPositions[index] = pos;
 }
 
 void Cat::setPosition(float x, float y) {
-    position.x = x;
-    position.y = y;
+    setPosition(Vector2{x, y});
+}
+
+CatHandle Cat::getHandle() const {
+    return system->getHandle(index);
 }
 
 Rectangle Cat::getRect() const {
-    return {position.x, position.y, width, height};
+    Vector2 position = system->positions[index];
+    Vector2 size = system->sizes[index];
+    return {position.x, position.y, size.x, size.y};
 }
 
 void Cat::setCaught(bool caught) {
-    isCaught = caught;
+    system->caught[index] = caught ? 1 : 0;
     if (caught) {
-        velocity = {0, 0};
-        isMoving = false;
+        system->velocities[index] = {0, 0};
+        system->moving[index] = 0;
         setState(CatState::CAUGHT);
     }
 }
 
 void Cat::setSpeed(float speed) {
-    this->speed = speed;
+    system->speeds[index] = speed;
+    updateTraitLanes();
 }
 
-void Cat::setName(const std::string& name) {
-    this->name = name;
+void Cat::setName(const char* name) {
+    system->names[index] = name;
 }
 
 void Cat::setTexturePath(const std::string& path) {
-    texturePath = path;
+    system->appearances[index].texturePath = path;
 }
 
 void Cat::reloadTexture() {
-    if (texturePath == "default") {
+    CatAppearance& appearance = system->appearances[index];
+    if (appearance.texturePath == "default") {
         Image image = GenImageColor(32, 32, PINK);
-        sprite = LoadTextureFromImage(image);
+        appearance.sprite = LoadTextureFromImage(image);
         UnloadImage(image);
-        width = 32.0f;
-        height = 32.0f;
+        system->sizes[index] = {32.0f, 32.0f};
     } else {
         try {
             // 这里可以加载自定义猫咪纹理
@@ -585,144 +365,152 @@ void Cat::reloadTexture() {
             // width = static_cast<float>(sprite.width);
             // height = static_cast<float>(sprite.height);
         } catch (const std::exception& e) {
-            std::cerr << "无法加载猫咪纹理: " << texturePath << " 错误: " << e.what() << std::endl;
+            std::cerr << "无法加载猫咪纹理: " << appearance.texturePath << " 错误: " << e.what() << std::endl;
         }
     }
 }
 
 std::string Cat::getTexturePath() const {
-    return texturePath;
+    return system->appearances[index].texturePath;
+}
+
+float Cat::getBaseEffectTime() const {
+    return system->baseEffectTimes[index];
+}
+
+void Cat::setBaseEffectTime(float time) {
+    system->baseEffectTimes[index] = time;
 }
 
 // 品种相关方法实现
 void Cat::setCatType(CatType type) {
-    this->type = type;
-    
-    // 根据新品种更新属性
-    if (type == CatType::PERSIAN) {
-        speed = 220.0f;
-        baseEffectTime = 15.0f;
-        color = ORANGE;
-    } else if (type == CatType::SIAMESE) {
-        speed = 280.0f;
-        baseEffectTime = 8.0f;
-        color = BROWN;
-    } else if (type == CatType::MAINE_COON) {
-        speed = 240.0f;
-        baseEffectTime = 12.0f;
-        color = DARKGRAY;
-    } else if (type == CatType::RAGDOLL) {
-        speed = 210.0f;
-        baseEffectTime = 18.0f;
-        color = LIGHTGRAY;
-    } else if (type == CatType::BENGAL) {
-        speed = 350.0f;
-        baseEffectTime = 6.0f;
-        color = YELLOW;
-    }
+    const CatSpeciesInfo& species = CatSpecies::get(type);
+    system->types[index] = type;
+    system->speeds[index] = species.speed;
+    system->baseEffectTimes[index] = species.baseEffectTime;
+    system->appearances[index].color = species.color;
+
+    updateTraitLanes();
+}
+
+void Cat::updateTraitLanes() {
+    const CatSpeciesInfo& species = CatSpecies::get(system->types[index]);
+    const CatPersonalityInfo& personality = CatSpecies::getPersonality(system->personalities[index]);
+    const float speed = system->speeds[index];
+
+    // 品种给出基础值，性格在其上修正
+    system->attractRanges[index] = species.attractRange * personality.attractScale;
+    system->alertRanges[index] = personality.alertRange;
+    system->fleeSpeeds[index] = speed * (species.fleeMultiplier * personality.fleeScale);
+    system->catnipSpeeds[index] = speed * (species.catnipMultiplier * personality.catnipScale);
 }
 
 CatType Cat::getCatType() const {
-    return type;
+    return system->types[index];
 }
 
 std::string Cat::getCatTypeName() const {
-    if (type == CatType::PERSIAN) return "波斯猫";
-    if (type == CatType::SIAMESE) return "暹罗猫";
-    if (type == CatType::MAINE_COON) return "缅因猫";
-    if (type == CatType::RAGDOLL) return "布偶猫";
-    if (type == CatType::BENGAL) return "孟加拉猫";
-    return "未知";
+    if (!CatSpecies::isValid(system->types[index])) return "未知";
+    return CatSpecies::get(system->types[index]).name;
 }
 
 // 获取猫咪基础速度
 float Cat::getBaseSpeed() const {
-    return speed;
-}
-
-// GIF功能已完全移除
-
-void Cat::updateState(Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip, int capturedCount, float deltaTime) {
-    // 如果被抓到，不更新状态
-    if (isCaught) return;
-    
-    // 计算与玩家的距离
-    float dx = position.x - playerPosition.x;
-    float dy = position.y - playerPosition.y;
-    float distanceToPlayer = std::sqrt(dx * dx + dy * dy);
-    
-    // 计算与猫薄荷的距离
-    float cdx = position.x - catnipPosition.x;
-    float cdy = position.y - catnipPosition.y;
-    float distanceToCatnip = std::sqrt(cdx * cdx + cdy * cdy);
-    
-    // 根据品种调整吸引范围
-    float attractRange = 100.0f;
-    if (type == CatType::BENGAL) attractRange = 120.0f;  // 孟加拉猫范围更大
-    else if (type == CatType::RAGDOLL) attractRange = 90.0f;  // 布偶猫范围更小
-    
-    // 根据性格调整吸引范围
-    if (personality == CatPersonality::GREEDY) attractRange *= 1.5f;
-    else if (personality == CatPersonality::COWARD) attractRange *= 0.8f;
-    
-    // 逃跑触发范围
-    float alertRange = 120.0f;
-    if (personality == CatPersonality::COWARD) alertRange = 200.0f; // 胆小猫逃得更早
-    
-    // 沉迷时间加成
-    float bonusTime = capturedCount * 0.5f;
-    float totalEffectTime = baseEffectTime + bonusTime;
-    if (personality == CatPersonality::GREEDY) totalEffectTime *= 1.3f; // 贪吃猫沉迷更久
-
-    // 状态切换逻辑
-    if (state == CatState::NORMAL) {
-        // 检查猫薄荷
-        if (hasCatnip && distanceToCatnip < attractRange) {
-            setState(CatState::CATNIPPED);
-            catnipEffectTimer = totalEffectTime;
-            this->catnipPosition = catnipPosition;
-            std::cout << "猫咪被猫薄荷吸引: " << getCatTypeName() << " " << name << " 沉迷时间: " << totalEffectTime << "秒" << std::endl;
-        }
-        // 检查玩家 (逃跑)
-        else if (distanceToPlayer < alertRange) {
-            setState(CatState::FLEEING);
-            catnipEffectTimer = 2.0f; // 逃跑 2 秒
-            this->catnipPosition = playerPosition; // 远离玩家
-            std::cout << "猫咪逃跑: " << getCatTypeName() << " " << name << std::endl;
-        }
-        // 好奇性格：如果玩家没动，慢慢靠近
-        else if (personality == CatPersonality::CURIOUS && distanceToPlayer < 200.0f) {
-            personalityTimer += deltaTime;
-            if (personalityTimer > 2.0f) { // 盯着看2秒后靠近
-                Vector2 toPlayer = {playerPosition.x - position.x, playerPosition.y - position.y};
-                float len = sqrtf(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y);
-                if (len > 50.0f) {
-                    velocity.x = (toPlayer.x / len) * speed * 0.4f;
-                    velocity.y = (toPlayer.y / len) * speed * 0.4f;
-                    isMoving = true;
-                }
+    return system->speeds[index];
+}
+
+void Cat::runBehavior(const BehaviorTree& tree, uint8_t proximity, const CatWorldSnapshot& world, float deltaTime) {
+    // 如果被抓到，不再行动
+    if (system->caught[index]) return;
+
+    // 从根开始沿成功 / 失败跳转执行，直到 END
+    const BehaviorNode* nodes = tree.getNodes();
+    uint32_t node = tree.getRoot(system->personalities[index]);
+    while (node != BehaviorNode::END) {
+        const BehaviorNode& current = nodes[node];
+        node = runLeaf(current, proximity, world, deltaTime) ? current.onSuccess : current.onFailure;
+    }
+}
+
+bool Cat::runLeaf(const BehaviorNode& current, uint8_t proximity, const CatWorldSnapshot& world, float deltaTime) {
+    switch (current.type) {
+        case BehaviorNodeType::IS_STATE:
+            return system->states[index] == static_cast<CatState>(current.arg);
+        case BehaviorNodeType::IS_NEAR:
+            return (proximity & current.arg) != 0;
+        case BehaviorNodeType::ABOVE:
+            return system->blackboards[index][current.arg] > current.params[0];
+        case BehaviorNodeType::CHANCE:
+            return system->rngs[index]() % 100 < current.arg;
+        case BehaviorNodeType::EFFECT_OVER:
+            return system->catnipEffectTimers[index] <= 0.0f;
+
+        case BehaviorNodeType::SET_STATE: {
+            const CatState newState = static_cast<CatState>(current.arg);
+            setState(newState);
+
+            float duration = 0.0f;
+            if (current.options & STATE_SET_DURATION) {
+                duration = current.params[0];
+                system->catnipEffectTimers[index] = duration;
+            } else if (current.options & STATE_EFFECT_DURATION) {
+                // 沉迷时间随已抓数量加成，再乘上性格和本次切换的倍率
+                duration = system->baseEffectTimes[index] + world.capturedCount * current.params[2];
+                duration *= current.params[0];
+                duration *= current.params[1];
+                system->catnipEffectTimers[index] = duration;
             }
-        } else {
-            personalityTimer = 0.0f;
-        }
-    } else if (state == CatState::FLEEING) {
-        // 逃跑中如果遇到猫薄荷，胆小猫可能不会理会，贪吃猫可能会切换状态
-        if (hasCatnip && distanceToCatnip < attractRange * 0.5f && personality == CatPersonality::GREEDY) {
-            setState(CatState::CATNIPPED);
-            catnipEffectTimer = totalEffectTime * 0.7f; // 逃跑中切换，效果减弱
-            this->catnipPosition = catnipPosition;
+
+            if (current.options & STATE_TARGET_PLAYER) system->catnipPositions[index] = world.playerPosition;
+            else if (current.options & STATE_TARGET_CATNIP) system->catnipPositions[index] = world.catnipPosition;
+
+            if (current.options & STATE_NOTIFY) {
+                system->emitEvent({CatEventType::STATE_CHANGED, index, newState, duration});
+            }
+            return true;
         }
+        case BehaviorNodeType::ADD_TIME:
+            system->blackboards[index][current.arg] += deltaTime;
+            return true;
+        case BehaviorNodeType::CLEAR:
+            system->blackboards[index][current.arg] = 0.0f;
+            return true;
+        case BehaviorNodeType::APPROACH_PLAYER:
+            return approachPlayer(world.playerPosition, current.params[0], current.params[1], current.params[2]);
+        case BehaviorNodeType::RANDOM_DIRECTION:
+            changeRandomDirection();
+            return true;
+        case BehaviorNodeType::WANDER_PAUSE:
+            wanderPause(deltaTime);
+            return true;
+        case BehaviorNodeType::WANDER_TURN:
+            wanderTurn(deltaTime);
+            return true;
+        case BehaviorNodeType::FLEE:
+            fleeAI(deltaTime * current.params[0]);
+            return true;
+        case BehaviorNodeType::SEEK_CATNIP:
+            catnipAI(deltaTime * current.params[0]);
+            return true;
+        default:
+            return false;
     }
 }
 
 void Cat::setState(CatState newState) {
+    CatState& state = system->states[index];
     if (state != newState) {
         state = newState;
-        stateTimer = 0.0f;
-        
+        system->stateTimers[index] = 0.0f;
+
+        // 目标随状态改变，旧路径作废
+        clearPath();
+
         // 更新状态指示器
+        StatusIndicator* statusIndicator = system->statusIndicators[index].get();
         if (statusIndicator) {
-            Vector2 indicatorPos = {position.x + width/2, position.y - 20};
+            Vector2 position = system->positions[index];
+            Vector2 indicatorPos = {position.x + system->sizes[index].x/2, position.y - 20};
             if (state == CatState::FLEEING) {
                 statusIndicator->showStatus(indicatorPos.x, indicatorPos.y, CatStatus::FLEEING);
             } else if (state == CatState::CATNIPPED) {
@@ -736,36 +524,98 @@ void Cat::setState(CatState newState) {
     }
 }
 
-void Cat::updateMovement(float deltaTime) {
-    // 基础移动逻辑，根据当前状态调整移动
-    if (isCaught) return;
-    
-    // 注意：位置更新现在统一在 update() 中进行，这里只负责逻辑处理
-}
-
 void Cat::updateStatusIndicator(float deltaTime) {
-    if (statusIndicator) {
-        statusIndicator->update(deltaTime);
+    if (system->statusIndicators[index]) {
+        system->statusIndicators[index]->update(deltaTime);
     }
 }
 
-void Cat::drawStatusIndicator() {
+void Cat::drawStatusIndicator(float alpha) {
+    StatusIndicator* statusIndicator = system->statusIndicators[index].get();
     if (statusIndicator && statusIndicator->isActive()) {
         // 在猫咪上方绘制状态指示器
-        Vector2 indicatorPos = {position.x + width/2, position.y - 15};
-        
+        Vector2 position = getRenderPosition(alpha);
+        Vector2 indicatorPos = {position.x + system->sizes[index].x/2, position.y - 15};
+
+        CatState state = system->states[index];
         CatStatus currentStatus = CatStatus::NORMAL;
         if (state == CatState::FLEEING) currentStatus = CatStatus::FLEEING;
         else if (state == CatState::CATNIPPED) currentStatus = CatStatus::CATNIPPED;
         else if (state == CatState::CAUGHT) currentStatus = CatStatus::CAUGHT;
-        
+
         statusIndicator->drawAt(indicatorPos.x, indicatorPos.y, currentStatus);
     }
 }
 
 float Cat::getCatnipTimeRemaining() const {
-    if (state == CatState::CATNIPPED) {
-        return catnipEffectTimer;
+    if (system->states[index] == CatState::CATNIPPED) {
+        return system->catnipEffectTimers[index];
     }
     return 0.0f;
 }
+
+void Cat::clearPath() {
+    CatPath& path = system->paths[index];
+    if (system->navigation && path.request != 0) {
+        // 并行更新中寻路服务不能碰，留到更新结束后取消
+        if (system->deferNavigation) {
+            path.cancelledRequest = path.request;
+        } else {
+            system->navigation->cancel(path.request);
+        }
+    }
+    path.request = 0;
+    path.requestQueued = false;
+    path.waypoints.clear();
+    path.index = 0;
+    path.repathTimer = 0.0f;
+}
+
+Vector2 Cat::steerTowards(Vector2 goal, float deltaTime) {
+    NavigationSystem* navigation = system->navigation;
+    CatPath& path = system->paths[index];
+    Vector2 position = system->positions[index];
+    Vector2 size = system->sizes[index];
+    Vector2 center = {position.x + size.x / 2.0f, position.y + size.y / 2.0f};
+
+    // 直线方向，路径未就绪或已走完时使用
+    Vector2 straight = {goal.x - center.x, goal.y - center.y};
+    float straightLength = std::sqrt(straight.x * straight.x + straight.y * straight.y);
+    if (straightLength > 0) {
+        straight.x /= straightLength;
+        straight.y /= straightLength;
+    }
+
+    if (!navigation || !navigation->isReady()) return straight;
+
+    // 目标明显移动或到了重新规划的时间才发新请求，请求在寻路服务里按预算分帧完成
+    // 请求先记在猫身上，由 CatSystem 在更新结束后按下标顺序提交，结果在下一步开始时取回
+    path.repathTimer -= deltaTime;
+    float goalShiftX = goal.x - path.goal.x;
+    float goalShiftY = goal.y - path.goal.y;
+    bool goalMoved = goalShiftX * goalShiftX + goalShiftY * goalShiftY > REPATH_DISTANCE * REPATH_DISTANCE;
+    if (path.request == 0 && !path.requestQueued && (path.repathTimer <= 0.0f || goalMoved)) {
+        path.requestQueued = true;
+        path.requestFrom = center;
+        path.goal = goal;
+        path.repathTimer = REPATH_INTERVAL;
+    }
+
+    // 跳过已经到达的拐点
+    while (path.index < path.waypoints.size()) {
+        float dx = path.waypoints[path.index].x - center.x;
+        float dy = path.waypoints[path.index].y - center.y;
+        if (dx * dx + dy * dy > WAYPOINT_RADIUS * WAYPOINT_RADIUS) break;
+        path.index++;
+    }
+
+    if (path.index >= path.waypoints.size()) return straight;
+
+    Vector2 direction = {path.waypoints[path.index].x - center.x, path.waypoints[path.index].y - center.y};
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (length > 0) {
+        direction.x /= length;
+        direction.y /= length;
+    }
+    return direction;
+}
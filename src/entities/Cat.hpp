@@ -1,11 +1,9 @@
 #ifndef CAT_HPP
 #define CAT_HPP
 
-#include "../core/StatusIndicator.hpp"
 #include <raylib.h>
 #include <string>
-#include <memory>
-#include <random>
+#include <cstdint>
 
 enum class CatType {
     PERSIAN,
@@ -29,113 +27,75 @@ enum class CatPersonality {
     CURIOUS     // 好奇：偶尔会主动靠近静止的玩家
 };
 
+class CatSystem;
+class BehaviorTree;
+struct BehaviorNode;
+struct CatWorldSnapshot;
+
+// 猫咪的持久引用：槽位 + 代数，猫被删除后槽位代数加一，旧引用随之失效
+// 与 Cat 句柄不同，删除其他猫不会影响它，可以长期保存（用 CatSystem::isAlive 检查）
+struct CatHandle {
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+
+    bool isNull() const { return slot == INVALID_SLOT; }
+    bool operator==(const CatHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const CatHandle& other) const { return !(*this == other); }
+};
+
+// 猫咪句柄：数据保存在 CatSystem 的数组中，这里只记录系统指针和下标
+// 句柄可以随意复制，CatSystem 删除任何一只猫之后旧句柄失效；需要长期保存时用 CatHandle
 class Cat {
 private:
-    std::string name;
-    Vector2 position;
-    Vector2 velocity;
-    float speed;
-    CatType type;
-    CatState state;
-    bool isCaught;
-    float catnipTimer;
-    float stateTimer;
-    Color color;
-    
-    // 基础属性
-    float width, height;
-    float legLength;     // 腿长
-    float bodyFatness;   // 胖瘦程度 (1.0 为标准)
-    bool isFluffy;       // 是否蓬松
-    bool isMoving;
-    bool facingRight;    // 转向状态
-    float breathTimer;  // 呼吸动画计时器
-    float walkTimer;    // 走路动画计时器
-    float blinkTimer;   // 眨眼计时器
-    float blinkDuration; // 眨眼持续时间
-    bool isBlinking;    // 是否正在眨眼
-    float tailWagTimer; // 尾巴摆动计时器
-    int currentFrame;
-    float frameTime;
-    float animationSpeed;
-    Texture2D sprite;
-    std::string texturePath;
-    
-    // 随机数生成
-    std::unique_ptr<std::random_device> rd;
-    std::unique_ptr<std::mt19937> gen;
-    
-    // AI相关
-    float aiChangeDirectionTimer;
-    float aiChangeDirectionInterval;
-    int smartMovePattern;
+    CatSystem* system;
+    uint32_t index;
     
-    // 猫薄荷效果
-    float catnipEffectTimer;
-    float baseEffectTime;
-    Vector2 catnipPosition;
-    
-    // 随机印象属性 (Random Impression Traits)
-    float earAngle;       // 耳朵角度 (0为立耳, 1.5为飞机耳)
-    float eyeSize;        // 眼睛大小缩放
-    float whiskerLength;  // 胡须长度
-    float tailStyle;      // 尾巴风格 (长度或摆动频率)
-
-    // 稀有度与性格
-    bool isShiny;           // 是否是闪光猫
-    Color shinyEffectColor; // 闪光特效颜色
-    CatPersonality personality;
-    float personalityTimer; // 性格行为计时器
-
-    // 状态指示器
-    std::unique_ptr<StatusIndicator> statusIndicator;
+    // 朝 goal 前进的单位方向：有寻路服务时沿路径走，否则（或路径未就绪时）直线
+    Vector2 steerTowards(Vector2 goal, float deltaTime);
+    void clearPath();
+    
+    // 按品种、性格和速度预先算好批量内核用到的范围和速度
+    void updateTraitLanes();
+    
+    // 求值行为树的条件或动作节点，返回是否成功
+    bool runLeaf(const BehaviorNode& node, uint8_t proximity, const CatWorldSnapshot& world, float deltaTime);
+    
+    friend class CatSystem;
 
 public:
-    // 构造函数和析构函数
-    Cat(const std::string& name, Vector2 position, CatType type);
-    Cat(const std::string& name, float x, float y, CatType type);
-    ~Cat();
-    
-    // 移动构造函数和赋值运算符
-    Cat(Cat&& other) noexcept;
-    Cat& operator=(Cat&& other) noexcept;
-    
-    // 删除拷贝构造函数和拷贝赋值运算符
-    Cat(const Cat&) = delete;
-    Cat& operator=(const Cat&) = delete;
-    
-    // 更新和绘制
-    void update(float deltaTime, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip, int capturedCount);
-    void draw();
+    Cat(CatSystem* system, uint32_t index) : system(system), index(index) {}
+    
+    uint32_t getIndex() const { return index; }
+    CatHandle getHandle() const;
+    
+    // 绘制：alpha 为上一个模拟步到当前模拟步之间的插值系数
+    void draw(float alpha = 1.0f);
     void updateTimers(float deltaTime);
     
     // 状态管理
     void setState(CatState newState);
-    CatState getState() const { return state; }
-    void updateState(Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip, int capturedCount, float deltaTime);
+    CatState getState() const;
     
-    // 移动相关
-    void moveRandomly(float deltaTime);
-    void fleeFrom(Vector2 target, float deltaTime);
-    void moveTowards(Vector2 target, float deltaTime);
-    void updateMovement(float deltaTime);
-    void updateAI(float deltaTime, Vector2 playerPos);
+    // AI：按性格运行行为树一次，状态切换和移动都由树决定
+    // proximity 为 CatKernels::evaluateProximity 算出的距离标志
+    void runBehavior(const BehaviorTree& tree, uint8_t proximity, const CatWorldSnapshot& world, float deltaTime);
     
     // 猫薄荷效果
-    void applyCatnipEffect(float duration);
-    bool isUnderCatnipEffect() const;
     float getCatnipTimeRemaining() const;
     
     // 获取信息
-    std::string getName() const { return name; }
-    Vector2 getPosition() const { return position; }
-    Vector2 getVelocity() const { return velocity; }
-    float getSpeed() const { return speed; }
-    CatType getType() const { return type; }
-    bool isCaughtStatus() const { return isCaught; }
-    bool getIsShiny() const { return isShiny; }
-    CatPersonality getPersonality() const { return personality; }
-    Color getCatColor() const { return color; }
+    const char* getName() const;
+    Vector2 getPosition() const;
+    Vector2 getRenderPosition(float alpha) const;
+    Vector2 getVelocity() const;
+    float getSpeed() const;
+    CatType getType() const;
+    bool isCaughtStatus() const;
+    bool getIsShiny() const;
+    CatPersonality getPersonality() const;
+    Color getCatColor() const;
     Rectangle getRect() const;
     
     // 设置信息
@@ -143,37 +103,36 @@ public:
     void setPosition(float x, float y);
     void setCaught(bool caught);
     void setSpeed(float speed);
-    void setName(const std::string& name);
+    void setName(const char* name);     // 不复制，要求同 CatSystem::spawn
     void setTexturePath(const std::string& path);
     void reloadTexture();
     
     // 类型相关
     std::string getCatTypeName() const;
-    float getCatnipSensitivity() const;
     float getBaseSpeed() const;
     void setCatType(CatType type);
     CatType getCatType() const;
     
     // 边界检测
     void checkBoundaries(int mapWidth, int mapHeight);
-    bool checkCollision(const Rectangle& playerRect);
+    bool checkCollision(const Rectangle& playerRect) const;
     
     // 状态指示器
     void updateStatusIndicator(float deltaTime);
-    void drawStatusIndicator();
+    void drawStatusIndicator(float alpha = 1.0f);
     
-    // 内部AI方法
-    void normalAI(float deltaTime, Vector2 playerPos);
+    // 行为树的动作：逃跑和沉迷只给出方向与速度，新速度由 CatSystem 的批量转向算出
+    void wanderPause(float deltaTime);
+    void wanderTurn(float deltaTime);
+    bool approachPlayer(Vector2 playerPos, float speedScale, float minDistance, float maxDistance);
     void fleeAI(float deltaTime);
     void catnipAI(float deltaTime);
     void changeRandomDirection();
-    bool shouldChangeDirection() const;
-    Vector2 generateRandomDirection() const;
     
     // 工具方法
     std::string getTexturePath() const;
-    float getBaseEffectTime() const { return baseEffectTime; }
-    void setBaseEffectTime(float time) { baseEffectTime = time; }
+    float getBaseEffectTime() const;
+    void setBaseEffectTime(float time);
 };
 
 #endif // CAT_HPP
@@ -0,0 +1,371 @@
+#include "CatSpecies.hpp"
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// 内置品种，按 CatType 下标排列
+constexpr std::array<CatSpeciesInfo, CatSpecies::BUILTIN_COUNT> BUILTIN_SPECIES = {{
+    {"PERSIAN", "波斯猫", "Persian Cat", "Persian",
+     "高贵优雅，毛发蓬松。虽然动作缓慢，但对猫薄荷有着惊人的执着。",
+     "Persian: Noble cat with long fluffy fur and a calm personality.",
+     "性格: 温顺 | 稀有度: *** | 速度: 较慢", "Temper: Gentle | Rarity: *** | Speed: Slow",
+     "assets/sprites/cat_persian.png",
+     220.0f, 15.0f, 100.0f, 1.2f, 0.5f, false,
+     ORANGE, Color{245, 245, 240, 255}, WHITE, Color{245, 240, 230, 255},
+     Color{245, 240, 230, 255}, Color{220, 210, 190, 255}, WHITE, Color{240, 230, 140, 255}},
+    {"SIAMESE", "暹罗猫", "Siamese Cat", "Siamese",
+     "聪明伶俐，好奇心强。它们擅长绕开玩家的捕捉，需要一点耐心。",
+     "Siamese: Short-haired cat from Thailand with unique points.",
+     "性格: 好奇 | 稀有度: *** | 速度: 极快", "Temper: Curious | Rarity: *** | Speed: Fast",
+     "assets/sprites/cat_siamese.png",
+     280.0f, 8.0f, 100.0f, 1.4f, 0.5f, true,
+     BROWN, Color{230, 200, 180, 255}, Color{235, 200, 175, 255}, Color{235, 220, 200, 255},
+     Color{235, 220, 200, 255}, Color{80, 60, 50, 255}, BLACK, Color{50, 150, 255, 255}},
+    {"MAINE_COON", "缅因猫", "Maine Coon", "Maine",
+     "猫中巨人，性格温顺。虽然体型庞大，但跑起来却意外地轻盈。",
+     "Maine Coon: Large fluffy cat known as the 'Gentle Giant'.",
+     "性格: 友善 | 稀有度: **** | 速度: 中等", "Temper: Friendly | Rarity: **** | Speed: Medium",
+     "assets/sprites/cat_maine_coon.png",
+     240.0f, 12.0f, 100.0f, 1.2f, 0.5f, false,
+     DARKGRAY, Color{100, 80, 60, 255}, Color{100, 80, 60, 255}, Color{100, 95, 90, 255},
+     Color{100, 95, 90, 255}, Color{60, 55, 50, 255}, Color{40, 35, 30, 255}, Color{150, 200, 50, 255}},
+    {"RAGDOLL", "布偶猫", "Ragdoll Cat", "Ragdoll",
+     "像布娃娃一样柔软。它们非常容易被猫薄荷吸引，是最容易捕捉的品种。",
+     "Ragdoll: Extremely docile cat that goes limp when picked up.",
+     "性格: 慵懒 | 稀有度: **** | 速度: 较慢", "Temper: Lazy | Rarity: **** | Speed: Slow",
+     "assets/sprites/cat_ragdoll.png",
+     210.0f, 18.0f, 90.0f, 1.1f, 0.3f, false,
+     LIGHTGRAY, Color{240, 240, 250, 255}, Color{245, 245, 250, 255}, WHITE,
+     WHITE, Color{200, 210, 230, 255}, BLACK, Color{0, 120, 255, 255}},
+    {"BENGAL", "孟加拉猫", "Bengal Cat", "Bengal",
+     "充满野性活力。速度极快，对危险感知敏锐，是捕捉者的终极挑战。",
+     "Bengal: Active cat with a beautiful wild leopard pattern.",
+     "性格: 活跃 | 稀有度: ***** | 速度: 极快", "Temper: Active | Rarity: ***** | Speed: Very Fast",
+     "assets/sprites/cat_bengal.png",
+     350.0f, 6.0f, 120.0f, 1.6f, 0.7f, false,
+     YELLOW, YELLOW, Color{210, 140, 60, 255}, Color{220, 150, 60, 255},
+     Color{210, 160, 100, 255}, Color{120, 80, 40, 255}, BLACK, Color{100, 180, 50, 255}}
+}};
+
+// 性格修正，按 CatPersonality 下标排列
+constexpr std::array<CatPersonalityInfo, CatSpecies::PERSONALITY_COUNT> BUILTIN_PERSONALITIES = {{
+    {"NORMAL", 1.0f, 120.0f, 1.0f, 1.0f},
+    {"COWARD", 0.8f, 200.0f, 1.4f, 1.0f},   // 吸引范围小，逃得更早更快
+    {"GREEDY", 1.5f, 120.0f, 1.0f, 1.2f},   // 吸引范围大，跑向猫薄荷更快
+    {"CURIOUS", 1.0f, 120.0f, 1.0f, 1.0f}
+}};
+
+using SpeciesTable = std::array<CatSpeciesInfo, CatSpecies::MAX_COUNT>;
+
+constexpr SpeciesTable makeBuiltinTable() {
+    SpeciesTable table{};
+    for (size_t i = 0; i < CatSpecies::BUILTIN_COUNT; i++) table[i] = BUILTIN_SPECIES[i];
+    return table;
+}
+
+// 常量初始化，其他翻译单元的静态对象构造时也可以安全查询
+SpeciesTable speciesTable = makeBuiltinTable();
+size_t speciesCount = CatSpecies::BUILTIN_COUNT;
+std::array<CatPersonalityInfo, CatSpecies::PERSONALITY_COUNT> personalityTable = BUILTIN_PERSONALITIES;
+
+// JSON 里读到的字符串，表项中的指针指向这里
+std::deque<std::string> stringPool;
+std::string loadError;
+
+struct FloatField {
+    const char* key;
+    float CatSpeciesInfo::* member;
+};
+
+struct StringField {
+    const char* key;
+    const char* CatSpeciesInfo::* member;
+};
+
+struct ColorField {
+    const char* key;
+    Color CatSpeciesInfo::* member;
+};
+
+constexpr FloatField FLOAT_FIELDS[] = {
+    {"speed", &CatSpeciesInfo::speed},
+    {"baseEffectTime", &CatSpeciesInfo::baseEffectTime},
+    {"attractRange", &CatSpeciesInfo::attractRange},
+    {"fleeMultiplier", &CatSpeciesInfo::fleeMultiplier},
+    {"catnipMultiplier", &CatSpeciesInfo::catnipMultiplier}
+};
+
+constexpr StringField STRING_FIELDS[] = {
+    {"name", &CatSpeciesInfo::name},
+    {"englishName", &CatSpeciesInfo::englishName},
+    {"shortName", &CatSpeciesInfo::shortName},
+    {"description", &CatSpeciesInfo::description},
+    {"englishDescription", &CatSpeciesInfo::englishDescription},
+    {"traits", &CatSpeciesInfo::traits},
+    {"englishTraits", &CatSpeciesInfo::englishTraits},
+    {"sprite", &CatSpeciesInfo::spritePath}
+};
+
+constexpr ColorField COLOR_FIELDS[] = {
+    {"color", &CatSpeciesInfo::color},
+    {"bodyColor", &CatSpeciesInfo::bodyColor},
+    {"modelColor", &CatSpeciesInfo::modelColor},
+    {"iconColor", &CatSpeciesInfo::iconColor},
+    {"primaryColor", &CatSpeciesInfo::primaryColor},
+    {"secondaryColor", &CatSpeciesInfo::secondaryColor},
+    {"accentColor", &CatSpeciesInfo::accentColor},
+    {"eyeColor", &CatSpeciesInfo::eyeColor}
+};
+
+struct PersonalityField {
+    const char* key;
+    float CatPersonalityInfo::* member;
+};
+
+constexpr PersonalityField PERSONALITY_FIELDS[] = {
+    {"attractScale", &CatPersonalityInfo::attractScale},
+    {"alertRange", &CatPersonalityInfo::alertRange},
+    {"fleeScale", &CatPersonalityInfo::fleeScale},
+    {"catnipScale", &CatPersonalityInfo::catnipScale}
+};
+
+bool readNonNegative(const rapidjson::Value& value, const std::string& where, float& out, std::string& error) {
+    if (!value.IsNumber() || value.GetDouble() < 0.0) {
+        error = where + " 必须是非负数字";
+        return false;
+    }
+    out = static_cast<float>(value.GetDouble());
+    return true;
+}
+
+bool readColor(const rapidjson::Value& value, const std::string& where, Color& out, std::string& error) {
+    if (!value.IsArray() || (value.Size() != 3 && value.Size() != 4)) {
+        error = where + " 必须是 [r, g, b] 或 [r, g, b, a]";
+        return false;
+    }
+    unsigned char channels[4] = {0, 0, 0, 255};
+    for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
+        if (!value[i].IsInt() || value[i].GetInt() < 0 || value[i].GetInt() > 255) {
+            error = where + " 的分量必须是 0-255 的整数";
+            return false;
+        }
+        channels[i] = static_cast<unsigned char>(value[i].GetInt());
+    }
+    out = Color{channels[0], channels[1], channels[2], channels[3]};
+    return true;
+}
+
+// 把 JSON 对象中的字段写进 info；新字符串先放进 strings，成功后再并入字符串池
+bool applySpecies(const rapidjson::Value& object, const std::string& id, CatSpeciesInfo& info,
+                  std::deque<std::string>& strings, std::string& error) {
+    for (auto member = object.MemberBegin(); member != object.MemberEnd(); ++member) {
+        const char* key = member->name.GetString();
+        const rapidjson::Value& value = member->value;
+        const std::string where = "品种 " + id + " 的 " + key;
+        bool known = std::strcmp(key, "base") == 0;
+
+        for (const FloatField& field : FLOAT_FIELDS) {
+            if (std::strcmp(key, field.key) != 0) continue;
+            if (!readNonNegative(value, where, info.*field.member, error)) return false;
+            known = true;
+        }
+        for (const StringField& field : STRING_FIELDS) {
+            if (std::strcmp(key, field.key) != 0) continue;
+            if (!value.IsString()) {
+                error = where + " 必须是字符串";
+                return false;
+            }
+            strings.emplace_back(value.GetString(), value.GetStringLength());
+            info.*field.member = strings.back().c_str();
+            known = true;
+        }
+        for (const ColorField& field : COLOR_FIELDS) {
+            if (std::strcmp(key, field.key) != 0) continue;
+            if (!readColor(value, where, info.*field.member, error)) return false;
+            known = true;
+        }
+        if (std::strcmp(key, "circlesWhenFleeing") == 0) {
+            if (!value.IsBool()) {
+                error = where + " 必须是布尔值";
+                return false;
+            }
+            info.circlesWhenFleeing = value.GetBool();
+            known = true;
+        }
+
+        if (!known) {
+            error = "品种 " + id + " 有未知字段: " + key;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 在 table 的前 count 项中按键名查找
+template <typename Table>
+size_t findById(const Table& table, size_t count, const char* id) {
+    for (size_t i = 0; i < count; i++) {
+        if (std::strcmp(table[i].id, id) == 0) return i;
+    }
+    return count;
+}
+
+} // namespace
+
+const CatSpeciesInfo& CatSpecies::get(CatType type) {
+    return speciesTable[static_cast<size_t>(type)];
+}
+
+const CatPersonalityInfo& CatSpecies::getPersonality(CatPersonality personality) {
+    return personalityTable[static_cast<size_t>(personality)];
+}
+
+size_t CatSpecies::getCount() {
+    return speciesCount;
+}
+
+bool CatSpecies::isValid(CatType type) {
+    return static_cast<size_t>(type) < speciesCount;
+}
+
+bool CatSpecies::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        loadError = "无法打开品种文件: " + path;
+        return false;
+    }
+
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!loadFromString(text)) {
+        loadError = path + ": " + loadError;
+        return false;
+    }
+    std::cout << "品种表加载成功: " << path << " (" << speciesCount << " 个品种)" << std::endl;
+    return true;
+}
+
+bool CatSpecies::loadFromString(const std::string& text) {
+    loadError.clear();
+
+    rapidjson::Document document;
+    document.Parse<rapidjson::kParseFullPrecisionFlag | rapidjson::kParseCommentsFlag>(text.c_str());
+    if (document.HasParseError()) {
+        loadError = std::string(rapidjson::GetParseError_En(document.GetParseError())) +
+                    " (偏移 " + std::to_string(document.GetErrorOffset()) + ")";
+        return false;
+    }
+    if (!document.IsObject()) {
+        loadError = "根节点必须是对象";
+        return false;
+    }
+
+    // 在内置表的副本上修改，全部成功后才替换
+    SpeciesTable species = makeBuiltinTable();
+    size_t count = BUILTIN_COUNT;
+    auto personalities = BUILTIN_PERSONALITIES;
+    std::deque<std::string> strings;
+
+    auto speciesMember = document.FindMember("species");
+    if (speciesMember != document.MemberEnd()) {
+        if (!speciesMember->value.IsObject()) {
+            loadError = "species 必须是对象";
+            return false;
+        }
+        for (auto entry = speciesMember->value.MemberBegin(); entry != speciesMember->value.MemberEnd(); ++entry) {
+            const std::string id(entry->name.GetString(), entry->name.GetStringLength());
+            if (!entry->value.IsObject()) {
+                loadError = "品种 " + id + " 必须是对象";
+                return false;
+            }
+
+            size_t slot = findById(species, count, id.c_str());
+            if (slot == count) {
+                // 新品种：从模板复制后追加
+                if (count == MAX_COUNT) {
+                    loadError = "品种过多（最多 " + std::to_string(MAX_COUNT) + " 个）";
+                    return false;
+                }
+                size_t base = static_cast<size_t>(CatType::PERSIAN);
+                auto baseMember = entry->value.FindMember("base");
+                if (baseMember != entry->value.MemberEnd()) {
+                    if (!baseMember->value.IsString()) {
+                        loadError = "品种 " + id + " 的 base 必须是字符串";
+                        return false;
+                    }
+                    base = findById(species, count, baseMember->value.GetString());
+                    if (base == count) {
+                        loadError = "品种 " + id + " 的模板不存在: " + baseMember->value.GetString();
+                        return false;
+                    }
+                }
+                species[count] = species[base];
+                strings.push_back(id);
+                species[count].id = strings.back().c_str();
+                count++;
+            } else if (entry->value.HasMember("base")) {
+                loadError = "base 只能用于新品种: " + id;
+                return false;
+            }
+
+            if (!applySpecies(entry->value, id, species[slot], strings, loadError)) return false;
+        }
+    }
+
+    auto personalityMember = document.FindMember("personalities");
+    if (personalityMember != document.MemberEnd()) {
+        if (!personalityMember->value.IsObject()) {
+            loadError = "personalities 必须是对象";
+            return false;
+        }
+        for (auto entry = personalityMember->value.MemberBegin(); entry != personalityMember->value.MemberEnd(); ++entry) {
+            const std::string id(entry->name.GetString(), entry->name.GetStringLength());
+            // 性格与行为树一一对应，只能覆盖不能追加
+            size_t slot = findById(personalities, personalities.size(), id.c_str());
+            if (slot == personalities.size()) {
+                loadError = "未知性格: " + id;
+                return false;
+            }
+            if (!entry->value.IsObject()) {
+                loadError = "性格 " + id + " 必须是对象";
+                return false;
+            }
+            for (auto member = entry->value.MemberBegin(); member != entry->value.MemberEnd(); ++member) {
+                const char* key = member->name.GetString();
+                bool known = false;
+                for (const PersonalityField& field : PERSONALITY_FIELDS) {
+                    if (std::strcmp(key, field.key) != 0) continue;
+                    if (!readNonNegative(member->value, "性格 " + id + " 的 " + key,
+                                         personalities[slot].*field.member, loadError)) return false;
+                    known = true;
+                }
+                if (!known) {
+                    loadError = "性格 " + id + " 有未知字段: " + key;
+                    return false;
+                }
+            }
+        }
+    }
+
+    speciesTable = species;
+    speciesCount = count;
+    personalityTable = personalities;
+    stringPool.swap(strings);
+    return true;
+}
+
+void CatSpecies::reset() {
+    speciesTable = makeBuiltinTable();
+    speciesCount = BUILTIN_COUNT;
+    personalityTable = BUILTIN_PERSONALITIES;
+    stringPool.clear();
+    loadError.clear();
+}
+
+const std::string& CatSpecies::getError() {
+    return loadError;
+}
@@ -0,0 +1,85 @@
+#ifndef CATSPECIES_HPP
+#define CATSPECIES_HPP
+
+#include "Cat.hpp"
+#include <raylib.h>
+#include <array>
+#include <string>
+#include <cstddef>
+
+// 一个品种的全部资料：模拟用的数值，以及绘制、图鉴和收藏界面用的文字和配色
+struct CatSpeciesInfo {
+    const char* id;                 // JSON 中的键名，如 "PERSIAN"
+    const char* name;               // 中文名
+    const char* englishName;        // 英文全名
+    const char* shortName;          // 英文短名（收藏卡片）
+    const char* description;        // 图鉴描述
+    const char* englishDescription; // 收藏界面的英文介绍
+    const char* traits;             // 收藏界面的性格 / 稀有度 / 速度
+    const char* englishTraits;
+    const char* spritePath;         // 纹理路径，空字符串表示只用程序化绘制
+
+    float speed;
+    float baseEffectTime;           // 基础沉迷时间（秒）
+    float attractRange;             // 猫薄荷吸引范围
+    float fleeMultiplier;           // 逃跑速度 = 速度 * 倍率
+    float catnipMultiplier;         // 沉迷时走向猫薄荷的速度倍率
+    bool circlesWhenFleeing;        // 逃跑时按一定规律绕圈
+
+    Color color;                    // 外观主色
+    Color bodyColor;                // 游戏内程序化绘制的身体颜色
+    Color modelColor;               // 图鉴 3D 模型颜色
+    Color iconColor;                // 收藏卡片小图标颜色
+    Color primaryColor;             // 收藏界面像素画：毛色
+    Color secondaryColor;           // 阴影 / 重点色
+    Color accentColor;              // 斑纹 / 高光
+    Color eyeColor;
+};
+
+// 性格对品种数值的修正
+struct CatPersonalityInfo {
+    const char* id;                 // JSON 中的键名，如 "COWARD"
+    float attractScale;             // 吸引范围倍率
+    float alertRange;               // 逃跑触发范围
+    float fleeScale;                // 逃跑速度倍率
+    float catnipScale;              // 沉迷移动速度倍率
+};
+
+// 品种注册表：内置品种是按 CatType 下标排列的 constexpr 表，启动时可以用 JSON 覆盖或追加
+// 查询只是一次下标访问；加载只应在启动时、生成猫咪之前进行，之后各线程只读
+//
+// JSON 格式（所有字段都可省略）：
+// {
+//     "species": {
+//         "BENGAL": {"speed": 360, "modelColor": [210, 140, 60]},
+//         "SPHYNX": {"base": "SIAMESE", "name": "斯芬克斯猫", "sprite": ""}
+//     },
+//     "personalities": {
+//         "COWARD": {"alertRange": 220}
+//     }
+// }
+// 已有的键覆盖对应品种；新的键追加一个品种（CatType 值接在内置品种之后），
+// 以 "base" 指定的品种（默认波斯猫）为模板；颜色写作 [r, g, b] 或 [r, g, b, a]
+class CatSpecies {
+public:
+    static constexpr size_t BUILTIN_COUNT = static_cast<size_t>(CatType::BENGAL) + 1;
+    static constexpr size_t MAX_COUNT = 16;
+    static constexpr size_t PERSONALITY_COUNT = static_cast<size_t>(CatPersonality::CURIOUS) + 1;
+
+    // 调用方保证 type 小于 getCount()
+    static const CatSpeciesInfo& get(CatType type);
+    static const CatPersonalityInfo& getPersonality(CatPersonality personality);
+    static size_t getCount();
+    static bool isValid(CatType type);
+
+    // 每次加载都从内置表开始，失败时保留原来的注册表
+    static bool loadFromFile(const std::string& path);
+    static bool loadFromString(const std::string& text);
+    // 恢复内置表
+    static void reset();
+
+    // 错误信息
+    static const std::string& getError();
+};
+
+#endif // CATSPECIES_HPP
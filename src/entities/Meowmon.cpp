@@ -1,5 +1,4 @@
 #include "Meowmon.hpp"
-#include <random>
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -8,7 +7,8 @@
 
 Meowmon::Meowmon(const std::string& name, SkillType type, int level) 
     : name(name), type(type), level(level), experience(0), 
-      nextLevelExp(level * 100), evolvedFormName(""), evolutionLevel(0) {
+      nextLevelExp(level * 100), evolvedFormName(""), evolutionLevel(0),
+      rng(RandomService::getInstance().split(RandomStream::BATTLE)) {
     initStats();
     
     // 尝试加载精灵图（简化版，直接使用raylib的加载函数）
@@ -103,13 +103,8 @@ void Meowmon::useSkill(Meowmon& target, const Skill& skill) {
         return;
     }
     
-    // 计算伤害
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> accuracyDist(0, 99);
-    
     // 检查命中率
-    if (accuracyDist(gen) >= skill.accuracy) {
+    if (rng.nextInt(0, 99) >= skill.accuracy) {
         std::cout << name << "的" << skill.name << "没有命中！" << std::endl;
         return;
     }
@@ -119,8 +114,7 @@ void Meowmon::useSkill(Meowmon& target, const Skill& skill) {
     int damage = static_cast<int>((((2 * level / 5 + 2) * skill.power * attackValue / target.getDefense()) / 50) + 2);
     
     // 随机伤害波动 (85% - 100%)
-    std::uniform_int_distribution<> damageDist(85, 100);
-    damage = (damage * damageDist(gen)) / 100;
+    damage = (damage * rng.nextInt(85, 100)) / 100;
     
     // 应用属性效果
     damage = static_cast<int>(damage * typeEffectiveness);
@@ -162,11 +156,11 @@ void Meowmon::levelUp() {
     std::cout << name << "升到了" << level << "级！" << std::endl;
     
     // 提升属性
-    maxHealth += 10 + (rand() % 5);
+    maxHealth += rng.nextInt(10, 14);
     currentHealth = maxHealth;
-    attackValue += 2 + (rand() % 3);
-    defense += 2 + (rand() % 3);
-    speed += 1 + (rand() % 2);
+    attackValue += rng.nextInt(2, 4);
+    defense += rng.nextInt(2, 4);
+    speed += rng.nextInt(1, 2);
     
     // 学习新技能
     learnNewSkill();
@@ -339,11 +333,11 @@ bool Meowmon::isAlive() const {
 
 void Meowmon::initStats() {
     // 根据等级初始化属性
-    maxHealth = 50 + (level * 10) + (rand() % (level * 2));
+    maxHealth = 50 + (level * 10) + rng.nextInt(0, level * 2 - 1);
     currentHealth = maxHealth;
-    attackValue = 30 + (level * 2) + (rand() % (level + 1));
-    defense = 30 + (level * 2) + (rand() % (level + 1));
-    speed = 30 + (level * 2) + (rand() % (level + 1));
+    attackValue = 30 + (level * 2) + rng.nextInt(0, level);
+    defense = 30 + (level * 2) + rng.nextInt(0, level);
+    speed = 30 + (level * 2) + rng.nextInt(0, level);
     
     // 计算下一级所需经验
     nextLevelExp = level * 100;
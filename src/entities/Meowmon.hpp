@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <raylib.h>
+#include "core/Random.hpp"
 
 // 技能类型枚举
 enum class SkillType {
@@ -128,6 +129,9 @@ private:
     std::string evolvedFormName;
     int evolutionLevel;
     
+    // 命中、伤害波动和成长用的随机流，派生自 RandomStream::BATTLE
+    Pcg32 rng;
+    
     // 初始化属性
     void initStats();
     
@@ -1,22 +1,26 @@
 #include "Player.hpp"
 #include "core/ResourceManager.hpp"
 #include "Catnip.hpp"
+#include "systems/MapLoader.hpp"
 #include <cmath>
 #include <iostream>
 
 Player::Player(const std::string& name, Vector2 position)
-    : name(name), position(position), velocity({0, 0}), speed(200.0f),
+    : name(name), position(position), previousPosition(position), velocity({0, 0}), speed(200.0f),
       isMoving(false), currentFrame(0), frameTime(0.0f), animationSpeed(0.1f),
       width(32.0f), height(32.0f), texturePath("assets/sprites/player.png"),
-      catnipCooldownTimer(0.0f), catnipCooldownDuration(2.0f), capturedCount(0) {
+      collisionMap(nullptr), catnipCooldownTimer(0.0f), catnipCooldownDuration(2.0f), capturedCount(0) {
     
     std::cout << "Player构造函数开始: texturePath=" << texturePath << std::endl;
     
-    // 直接创建默认纹理，不依赖ResourceManager
-    std::cout << "创建默认玩家方块纹理..." << std::endl;
-    Image image = GenImageColor(32, 32, ORANGE);
-    sprite = LoadTextureFromImage(image);
-    UnloadImage(image);
+    // 直接创建默认纹理，不依赖ResourceManager；没有窗口（无图形模拟）时没有图形上下文，跳过
+    sprite = Texture2D{0};
+    if (IsWindowReady()) {
+        std::cout << "创建默认玩家方块纹理..." << std::endl;
+        Image image = GenImageColor(32, 32, ORANGE);
+        sprite = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
     texturePath = "default";  // 标记为默认纹理
     
     // 确保设置正确的尺寸
@@ -33,9 +37,16 @@ Player::Player(const std::string& name, Vector2 position)
 }
 
 void Player::update(float deltaTime) {
+    previousPosition = position;
+    
     // 更新位置
-    position.x += velocity.x * deltaTime;
-    position.y += velocity.y * deltaTime;
+    Vector2 delta = {velocity.x * deltaTime, velocity.y * deltaTime};
+    if (collisionMap) {
+        position = collisionMap->moveAndSlide(getRect(), delta).position;
+    } else {
+        position.x += delta.x;
+        position.y += delta.y;
+    }
     
     // 更新朝向
     if (velocity.x > 0) facingRight = true;
@@ -61,7 +72,7 @@ void Player::update(float deltaTime) {
     }
 }
 
-void Player::draw() {
+void Player::draw(float alpha) {
     // --- 核心比例调整 (参考星露谷物语：头大身小，2:3:2 比例) ---
     const float p = 3.0f; // 基础像素大小
     
@@ -73,7 +84,8 @@ void Player::draw() {
     Color shoeColor = { 40, 40, 40, 255 };
     Color shadowColor = { 0, 0, 0, 60 };
 
-    Vector2 center = { position.x + width/2, position.y + height/2 };
+    Vector2 drawPosition = getRenderPosition(alpha);
+    Vector2 center = { drawPosition.x + width/2, drawPosition.y + height/2 };
     float dir = facingRight ? 1.0f : -1.0f;
     
     // 呼吸与行走动画
@@ -81,10 +93,10 @@ void Player::draw() {
     float walk = isMoving ? sinf((float)GetTime() * 12.0f) : 0.0f;
 
     // 0. 椭圆阴影
-    DrawEllipse((int)center.x, (int)(position.y + height - 2.0f), 10, 4, shadowColor);
+    DrawEllipse((int)center.x, (int)(drawPosition.y + height - 2.0f), 10, 4, shadowColor);
 
     // 1. 腿部与脚 (1x2 像素)
-    float legY = position.y + height - 6;
+    float legY = drawPosition.y + height - 6;
     float lOff = walk * 3.0f;
     // 左脚
     DrawRectangleRec({ center.x - 2.0f*p, legY + lOff, p, 4 }, pantsColor);
@@ -112,7 +124,7 @@ void Player::draw() {
     DrawRectangleRec({ eyeX, headY + 5, 2, 2 }, { 40, 40, 60, 255 });
 
     // 4. UI
-    DrawText(name.c_str(), (int)(center.x - (float)MeasureText(name.c_str(), 10) / 2.0f), (int)(position.y - 15.0f), 10, Fade(BLACK, 0.8f));
+    DrawText(name.c_str(), (int)(center.x - (float)MeasureText(name.c_str(), 10) / 2.0f), (int)(drawPosition.y - 15.0f), 10, Fade(BLACK, 0.8f));
     
     catnip.draw();
 }
@@ -148,10 +160,29 @@ void Player::handleInput() {
     }
     
     // 抛出猫薄荷（空格键或鼠标左键）- 需要冷却
-    if ((IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) && catnipCooldownTimer <= 0.0f) {
-        throwCatnip();
-        catnipCooldownTimer = catnipCooldownDuration;  // 重置冷却
+    if (IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        throwCatnipAt(GetMousePosition());
+    }
+}
+
+void Player::setMoveDirection(Vector2 direction) {
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    if (length <= 0.0f) {
+        velocity = {0, 0};
+        isMoving = false;
+        return;
     }
+    velocity = {direction.x / length * speed, direction.y / length * speed};
+    isMoving = true;
+}
+
+bool Player::throwCatnipAt(Vector2 target) {
+    if (catnipCooldownTimer > 0.0f) return false;
+    
+    catnip.throwCatnip(position, target, 1.0f);
+    catnipCooldownTimer = catnipCooldownDuration;  // 重置冷却
+    std::cout << "玩家抛出猫薄荷，目标: (" << target.x << "," << target.y << ")" << std::endl;
+    return true;
 }
 
 void Player::checkBoundaries(int mapWidth, int mapHeight) {
@@ -170,14 +201,25 @@ void Player::checkBoundaries(int mapWidth, int mapHeight) {
     }
 }
 
+void Player::setCollisionMap(const MapLoader* map) {
+    collisionMap = map;
+}
+
 void Player::setPosition(Vector2 position) {
+    // 瞬移不插值
     this->position = position;
+    previousPosition = position;
 }
 
 Vector2 Player::getPosition() const {
     return position;
 }
 
+Vector2 Player::getRenderPosition(float alpha) const {
+    return {previousPosition.x + (position.x - previousPosition.x) * alpha,
+            previousPosition.y + (position.y - previousPosition.y) * alpha};
+}
+
 Rectangle Player::getRect() const {
     return {position.x, position.y, width, height};
 }
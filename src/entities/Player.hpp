@@ -5,10 +5,13 @@
 #include <string>
 #include "Catnip.hpp"
 
+class MapLoader;
+
 class Player {
 private:
     std::string name;
     Vector2 position;
+    Vector2 previousPosition;   // 上一个模拟步的位置，渲染插值用
     Vector2 velocity;
     float speed;
     bool isMoving;
@@ -36,23 +39,35 @@ private:
     // 猫薄荷
     Catnip catnip;
     
+    // 碰撞地图（可为空）
+    const MapLoader* collisionMap;
+    
 public:
     Player(const std::string& name, Vector2 position);
     ~Player() = default;
     
-    // 更新和绘制
+    // 更新和绘制：update 按固定步长调用，draw 的 alpha 为两次模拟之间的插值系数
     void update(float deltaTime);
-    void draw();
+    void draw(float alpha = 1.0f);
     
     // 输入处理
     void handleInput();
     
+    // 脚本控制（无图形模拟用）：按方向移动，方向会被归一化，零向量表示停下
+    void setMoveDirection(Vector2 direction);
+    // 向目标位置抛出猫薄荷，冷却中返回 false
+    bool throwCatnipAt(Vector2 target);
+    
     // 边界检测
     void checkBoundaries(int mapWidth, int mapHeight);
     
+    // 设置碰撞地图，移动时沿墙滑动
+    void setCollisionMap(const MapLoader* map);
+    
     // 设置和获取
     void setPosition(Vector2 position);
     Vector2 getPosition() const;
+    Vector2 getRenderPosition(float alpha) const;
     Rectangle getRect() const;
     
     void setSpeed(float speed);
@@ -2,19 +2,58 @@
 #include "entities/Player.hpp"
 #include "entities/Cat.hpp"
 #include "entities/Catnip.hpp"
+#include "entities/CatSpecies.hpp"
 #include "systems/MapLoader.hpp"
+#include "systems/NavigationSystem.hpp"
+#include "systems/CatSystem.hpp"
+#include "systems/CatKernels.hpp"
+#include "systems/BehaviorTree.hpp"
 #include "core/ResourceManager.hpp"
 #include "core/GameState.hpp"
 #include "core/StartScreen.hpp"
 #include "core/SettingsMenu.hpp"
 #include "core/Meowdex.hpp"
 #include "core/UIHelper.hpp"
+#include "core/Random.hpp"
+#include "core/FixedTimestep.hpp"
+#include "core/JobSystem.hpp"
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <cstring>
+#include <cstdlib>
 
-int main() {
-    // 初始化窗口，设置标题和大小
+int main(int argc, char* argv[]) {
+    // 世界种子：--seed <数字> 指定，否则随机；同一种子可复现整局游戏
+    RandomService& random = RandomService::getInstance();
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--seed") == 0) {
+            random.setWorldSeed(std::strtoull(argv[i + 1], nullptr, 10));
+        }
+    }
+    std::cout << "世界种子: " << random.getWorldSeed() << std::endl;
+    Pcg32& spawnRng = random.stream(RandomStream::SPAWNER);
+    Pcg32& effectsRng = random.stream(RandomStream::EFFECTS);
+    
+    // 任务线程池：猫咪按块在多个线程上并行更新（需比猫咪晚析构）
+    JobSystem jobSystem;
+    
+    // 品种表：数据文件可选，不存在时只用内置品种（需在创建图鉴和生成猫咪之前加载）
+    const char* speciesPath = FileExists("assets/data/species.json") ? "assets/data/species.json" : "../assets/data/species.json";
+    if (FileExists(speciesPath) && !CatSpecies::loadFromFile(speciesPath)) {
+        std::cerr << "使用内置品种表: " << CatSpecies::getError() << std::endl;
+    }
+    
+    // 猫咪行为树：读取失败时沿用内置默认行为（需比猫咪晚析构）
+    BehaviorTree catBehavior;
+    bool hasCatBehavior = catBehavior.loadFromFile("assets/ai/cat_behavior.json") ||
+                          catBehavior.loadFromFile("../assets/ai/cat_behavior.json");
+    if (!hasCatBehavior) {
+        std::cerr << "使用内置猫咪行为: " << catBehavior.getError() << std::endl;
+    }
+    
+    // 初始化窗口，设置标题和大小；渲染跟随垂直同步，模拟按固定步长与之解耦
+    SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(800, 600, "Meowmon - Catnip Catcher");
     
     SetExitKey(KEY_NULL); // 禁止 ESC 键直接退出游戏
@@ -31,10 +70,17 @@ int main() {
     
     float screenShake = 0.0f;
     
+    // 模拟时钟（120Hz）
+    FixedTimestep simClock;
+    int simStepsLastFrame = 0;
+    
     // 初始化组件
     StartScreen startScreen;
     std::unique_ptr<Player> player = nullptr;
-    std::unique_ptr<std::vector<Cat>> cats = nullptr;
+    // 寻路服务需比猫咪晚析构（猫咪析构时会取消未完成的请求）
+    std::unique_ptr<NavigationSystem> navigation = nullptr;
+    std::unique_ptr<CatSystem> cats = nullptr;
+    std::vector<CatHandle> capturedCats;
     std::unique_ptr<MapLoader> mapLoader = nullptr;
     std::unique_ptr<SettingsMenu> settingsMenu = std::make_unique<SettingsMenu>();
     std::unique_ptr<Meowdex> meowdex = std::make_unique<Meowdex>();
@@ -86,46 +132,61 @@ int main() {
                     // 更新开始界面
                     startScreen.update(deltaTime);
                     
-                    // 检查是否开始游戏
-                    if (startScreen.shouldStartGame()) {
-                        std::cout << "检测到开始游戏信号，切换到PLAYING状态" << std::endl;
-                        currentState = GameState::PLAYING;
+                    // 检查是否开始游戏：地图在后台线程加载，开始界面显示进度条
+                    if (!gameInitialized && !startScreen.isLoading() && startScreen.shouldStartGame()) {
+                        std::cout << "检测到开始游戏信号，开始加载地图" << std::endl;
+                        mapLoader = std::make_unique<MapLoader>();
                         
-                        // 初始化游戏对象
-                        if (!gameInitialized) {
-                            std::cout << "初始化游戏对象..." << std::endl;
-                            // 创建地图加载器
-                            mapLoader = std::make_unique<MapLoader>();
-                            
-                            // 尝试加载草地图 - 使用TMX格式
-                            std::string mapPath = "assets/maps/grass block.tmx";
-                            std::cout << "尝试加载草地图文件: " << mapPath << std::endl;
-                            if (!mapLoader->loadMap(mapPath)) {
-                                // 尝试备用路径
-                                mapPath = "../assets/maps/grass block.tmx";
-                                if (!mapLoader->loadMap(mapPath)) {
-                                    std::cout << "无法加载草地图文件，使用默认设置" << std::endl;
-                                } else {
-                                    std::cout << "草地图加载成功 (备用路径)！" << std::endl;
-                                }
+                        // 尝试加载草地图 - 使用TMX格式，找不到时尝试备用路径
+                        mapLoader->startAsyncLoad({"assets/maps/grass block.tmx", "../assets/maps/grass block.tmx"});
+                        startScreen.beginLoading();
+                    }
+                    
+                    if (startScreen.isLoading() && mapLoader) {
+                        // 主线程每帧只上传一张纹理
+                        MapLoadState loadState = mapLoader->updateAsyncLoad();
+                        startScreen.setLoadProgress(mapLoader->getLoadProgress());
+                        
+                        if (loadState == MapLoadState::READY || loadState == MapLoadState::FAILED) {
+                            if (loadState == MapLoadState::READY) {
+                                std::cout << "草地图加载成功: " << mapLoader->getLoadedPath() << std::endl;
+#ifndef PLATFORM_WEB
+                                // 在 Tiled 中保存地图即可在游戏里看到修改
+                                mapLoader->enableHotReload();
+#endif
                             } else {
-                                std::cout << "草地图加载成功！" << std::endl;
+                                std::cout << "无法加载草地图文件，使用默认设置" << std::endl;
                             }
+                            startScreen.finishLoading();
+                            
+                            // 初始化游戏对象
+                            std::cout << "初始化游戏对象..." << std::endl;
                             
                             // 创建玩家
                             player = std::make_unique<Player>("Player1", Vector2{100.0f, 100.0f});
                             player->setSpeed(200.0f);
+                            player->setCollisionMap(mapLoader.get());
                             
                             // 创建猫咪 - 使用英文名字避免中文乱码
-                            cats = std::make_unique<std::vector<Cat>>();
-                            cats->push_back(Cat("Mimi", {200.0f, 200.0f}, CatType::PERSIAN));
-                            cats->push_back(Cat("Whiskers", {400.0f, 300.0f}, CatType::SIAMESE));
-                            cats->push_back(Cat("Shadow", {600.0f, 400.0f}, CatType::MAINE_COON));
-                            cats->push_back(Cat("Luna", {300.0f, 500.0f}, CatType::RAGDOLL));
+                            cats = std::make_unique<CatSystem>();
+                            cats->spawn("Mimi", {200.0f, 200.0f}, CatType::PERSIAN);
+                            cats->spawn("Whiskers", {400.0f, 300.0f}, CatType::SIAMESE);
+                            cats->spawn("Shadow", {600.0f, 400.0f}, CatType::MAINE_COON);
+                            cats->spawn("Luna", {300.0f, 500.0f}, CatType::RAGDOLL);
+                            // 寻路网格按猫咪的碰撞尺寸生成
+                            navigation = std::make_unique<NavigationSystem>();
+                            navigation->build(*mapLoader, {CatSystem::CAT_WIDTH, CatSystem::CAT_HEIGHT});
+                            
+                            cats->setCollisionMap(mapLoader.get());
+                            cats->setNavigation(navigation.get());
+                            cats->setJobSystem(&jobSystem);
+                            cats->setBehavior(hasCatBehavior ? &catBehavior : nullptr);
                             
                             gameInitialized = true;
                             caughtCount = 0;
-                            std::cout << "游戏对象初始化完成" << std::endl;
+                            simClock.reset();
+                            std::cout << "游戏对象初始化完成，切换到PLAYING状态" << std::endl;
+                            currentState = GameState::PLAYING;
                         }
                     }
                     break;
@@ -133,76 +194,105 @@ int main() {
                 case GameState::PLAYING:
                     // 游戏主逻辑
                     if (player && cats && mapLoader) {
-                        // 处理玩家输入
+                        // 处理玩家输入（每帧一次，结果作用于本帧的所有模拟步）
                         player->handleInput();
                         
-                        // 更新玩家位置
-                        player->update(deltaTime);
-                        
                         // 获取地图尺寸
                         int mapWidth = mapLoader->getMapWidth();
                         int mapHeight = mapLoader->getMapHeight();
                         
-                        // 边界检测
-                        player->checkBoundaries(mapWidth, mapHeight);
-                        
-                        // 更新猫咪
-                        for (auto& cat : *cats) {
-                            // 更新猫咪状态（基于玩家和猫薄荷，传递抓到数量）
-                            bool hasCatnip = player->isCatnipActive();
-                            Vector2 catnipPos = player->getCatnipPosition();
-                            cat.updateState(player->getPosition(), catnipPos, hasCatnip, player->getCapturedCount(), deltaTime);
+                        // 固定步长模拟：帧率只决定每帧跑几步，不影响玩法
+                        simStepsLastFrame = simClock.advance(deltaTime);
+                        for (int step = 0; step < simStepsLastFrame; step++) {
+                            const float stepTime = simClock.getStep();
+                            
+                            // 更新玩家位置
+                            player->update(stepTime);
                             
-                            cat.update(deltaTime, player->getPosition(), catnipPos, hasCatnip, player->getCapturedCount());
-                            cat.checkBoundaries(mapWidth, mapHeight);
+                            // 边界检测
+                            player->checkBoundaries(mapWidth, mapHeight);
                             
-                            // 检查是否被抓到
-                            if (!cat.isCaughtStatus() && cat.checkCollision(player->getRect())) {
-                                if (cat.getState() == CatState::CATNIPPED) {
+                            // 推进寻路请求（所有猫共享每步的搜索预算）
+                            if (navigation) navigation->update();
+                            
+                            // 更新猫咪（基于玩家和猫薄荷的快照，传递抓到数量）
+                            CatWorldSnapshot world;
+                            world.playerPosition = player->getPosition();
+                            world.playerRect = player->getRect();
+                            // 细节分级用的视野：以模拟中的玩家位置为屏幕中心，不受渲染插值和震屏影响
+                            float viewWidth = GetScreenWidth() / camera.zoom;
+                            float viewHeight = GetScreenHeight() / camera.zoom;
+                            world.viewRect = {world.playerPosition.x - viewWidth / 2.0f, world.playerPosition.y - viewHeight / 2.0f,
+                                              viewWidth, viewHeight};
+                            world.catnipPosition = player->getCatnipPosition();
+                            world.hasCatnip = player->isCatnipActive();
+                            world.capturedCount = player->getCapturedCount();
+                            world.mapWidth = mapWidth;
+                            world.mapHeight = mapHeight;
+                            cats->update(stepTime, world);
+                            
+                            // 检查是否被抓到：沉迷中碰到玩家的猫由更新产生抓捕事件
+                            for (const CatEvent& event : cats->getEvents()) {
+                                if (event.type != CatEventType::CAPTURE) continue;
+                                Cat cat = cats->get(event.cat);
+                                if (!cat.isCaughtStatus()) {
                                     cat.setCaught(true);
                                     caughtCount++;
                                     player->incrementCapturedCount();
                                     if (meowdex) meowdex->recordCapture(cat);
                                     screenShake = 0.5f; // 抓到时震动
+                                    capturedCats.push_back(cat.getHandle());
+                                }
+                            }
+                            
+                            // 抓到的猫立即回收槽位（事件遍历完再删，删除会移动下标）
+                            for (CatHandle handle : capturedCats) {
+                                cats->release(handle);
+                            }
+                            capturedCats.clear();
+                            
+                            // 动态刷新系统：如果地图上的活猫少于 4 只，尝试生成新的
+                            size_t activeCats = cats->countActive();
+                            
+                            if (activeCats < 4) {
+                                CatType randomType = (CatType)(spawnRng.nextInt(0, (int)CatSpecies::getCount() - 1));
+                                const char* names[] = {"Mimi", "Whiskers", "Shadow", "Luna", "Oliver", "Leo", "Milo", "Bella"};
+                                const char* randomName = names[spawnRng.nextInt(0, 7)];
+                                
+                                // 在玩家附近的出生区域中找不压墙的位置，找不到就等下一步再试
+                                Vector2 playerPos = player->getPosition();
+                                Rectangle spawnArea = {playerPos.x - 600.0f, playerPos.y - 450.0f, 1200.0f, 900.0f};
+                                Vector2 spawnPos;
+                                if (mapLoader->findSpawnPosition(spawnArea, {CatSystem::CAT_WIDTH, CatSystem::CAT_HEIGHT}, spawnPos)) {
+                                    cats->spawn(randomName, spawnPos, randomType);
                                 }
                             }
                         }
-
-                        // 更新相机
-                        camera.target = player->getPosition();
+                        
+                        // 更新相机：跟随插值后的玩家位置，与画面上的玩家一致
+                        camera.target = player->getRenderPosition(simClock.getAlpha());
                         if (screenShake > 0) {
-                            camera.offset.x = 400 + GetRandomValue(-10, 10) * screenShake;
-                            camera.offset.y = 300 + GetRandomValue(-10, 10) * screenShake;
+                            camera.offset.x = 400 + effectsRng.nextInt(-10, 10) * screenShake;
+                            camera.offset.y = 300 + effectsRng.nextInt(-10, 10) * screenShake;
                             screenShake -= deltaTime * 2.0f;
                         } else {
                             camera.offset = { 400, 300 };
                         }
-
-                    // 动态刷新系统：如果地图上的活猫少于 4 只，尝试生成新的
-                    int activeCats = 0;
-                    for (const auto& c : *cats) if (!c.isCaughtStatus()) activeCats++;
-
-                    if (activeCats < 4) {
-                        float spawnX = (float)(GetRandomValue(50, mapWidth - 50));
-                        float spawnY = (float)(GetRandomValue(50, mapHeight - 50));
                         
-                        CatType randomType = (CatType)(GetRandomValue(0, 4));
-                        const char* names[] = {"Mimi", "Whiskers", "Shadow", "Luna", "Oliver", "Leo", "Milo", "Bella"};
-                        const char* randomName = names[GetRandomValue(0, 7)];
+                        // 无限地图：按相机位置换入/换出区块
+                        mapLoader->updateStreaming(camera);
                         
-                        cats->push_back(Cat(randomName, {spawnX, spawnY}, randomType));
-                        std::cout << "A new cat appeared: " << randomName << " at (" << spawnX << ", " << spawnY << ")" << std::endl;
-                    }
-
-                    // 定期清理已抓获的猫咪对象，防止 vector 无限增长
-                    static float cleanupTimer = 0;
-                    cleanupTimer += deltaTime;
-                    if (cleanupTimer > 5.0f) { // 每 5 秒清理一次
-                        cats->erase(std::remove_if(cats->begin(), cats->end(), 
-                            [](const Cat& c) { return c.isCaughtStatus(); }), cats->end());
-                        cleanupTimer = 0;
+                        // 水面、花丛等动画图块
+                        mapLoader->updateAnimations(deltaTime);
+                        
+                        // 地图热重载只应用变化的图块，寻路网格同步刷新受影响的区域
+                        if (mapLoader->updateHotReload()) {
+                            int x0, y0, x1, y1;
+                            if (navigation && mapLoader->getReloadCollisionBounds(x0, y0, x1, y1)) {
+                                navigation->refreshCells(x0, y0, x1, y1);
+                            }
+                        }
                     }
-                }
                     break;
 
                 case GameState::PAUSED:
@@ -225,18 +315,18 @@ int main() {
                 
             case GameState::PLAYING:
                 if (gameInitialized) {
-                    BeginMode2D(camera);
+                    // 烘焙视野内发生变化的地图区块（必须在 BeginMode2D 之前）
+                    mapLoader->bakeDirtyChunks(camera);
                     
-                    // 绘制地图
-                    mapLoader->draw();
+                    BeginMode2D(camera);
                     
-                    // 绘制猫咪
-                    for (auto& cat : *cats) {
-                        cat.draw();
-                    }
+                    // 绘制地图（只绘制相机视野内的区块）
+                    mapLoader->draw(camera);
                     
-                    // 绘制玩家
-                    player->draw();
+                    // 绘制猫咪和玩家（在最近两次模拟状态之间插值）
+                    float renderAlpha = simClock.getAlpha();
+                    cats->draw(renderAlpha);
+                    player->draw(renderAlpha);
                     
                     EndMode2D();
                     
@@ -276,6 +366,8 @@ int main() {
                         DrawText(TextFormat("FPS: %i", GetFPS()), 20, dy, 15, LIME); dy += 20;
                         DrawText(TextFormat("POS: %.0f, %.0f", player->getPosition().x, player->getPosition().y), 20, dy, 15, WHITE); dy += 20;
                         DrawText(TextFormat("MAP: %dx%d", mapLoader->getMapWidth(), mapLoader->getMapHeight()), 20, dy, 15, WHITE); dy += 20;
+                        DrawText(TextFormat("SIM: %d steps, dropped %.2fs, %s, %u threads", simStepsLastFrame, simClock.getDroppedTime(), CatKernels::getInstructionSet(), jobSystem.getThreadCount()), 20, dy, 15, WHITE); dy += 20;
+                        DrawText(TextFormat("AI LOD: near %d, mid %d, far %d", (int)cats->countLod(CatLod::NEAR), (int)cats->countLod(CatLod::MID), (int)cats->countLod(CatLod::FAR)), 20, dy, 15, WHITE); dy += 20;
                     }
                     
                     // 底部操作指引 (改为简洁的图标/文字)
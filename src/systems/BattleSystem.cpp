@@ -1,11 +1,11 @@
 #include "BattleSystem.hpp"
 #include <iostream>
-#include <random>
 
 BattleSystem::BattleSystem() 
     : currentState(BattleState::BATTLE_START), battleResult(BattleResult::DRAW),
       currentPlayerMeowmonIndex(0), currentEnemyMeowmonIndex(0),
-      animationTimer(0.0f), animationDuration(1.0f) {
+      animationTimer(0.0f), animationDuration(1.0f),
+      rng(RandomService::getInstance().split(RandomStream::BATTLE)) {
 }
 
 void BattleSystem::startBattle(std::vector<std::shared_ptr<Meowmon>> playerTeam, 
@@ -342,7 +342,7 @@ int BattleSystem::enemyChooseSkill(const Meowmon& enemy, const Meowmon& player)
     }
     
     // 随机选择一个技能
-    return availableSkills[rand() % availableSkills.size()];
+    return availableSkills[rng.nextInt(0, static_cast<int>(availableSkills.size()) - 1)];
 }
 
 bool BattleSystem::isTeamDefeated(const std::vector<std::shared_ptr<Meowmon>>& team) const {
@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include "entities/Meowmon.hpp"
+#include "core/Random.hpp"
 
 class BattleSystem {
 public:
@@ -84,6 +85,9 @@ private:
     // 战斗信息文本
     std::vector<std::string> battleMessages;
     
+    // 敌方决策用的随机流
+    Pcg32 rng;
+    
     // 检查队伍是否全灭
     bool isTeamDefeated(const std::vector<std::shared_ptr<Meowmon>>& team) const;
 };
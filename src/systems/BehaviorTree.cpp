@@ -0,0 +1,337 @@
+#include "BehaviorTree.hpp"
+#include "CatKernels.hpp"
+#include "DefaultBehavior.hpp"
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// 树的最大嵌套层数（含展开的子树），超过时多半是子树循环引用
+constexpr size_t MAX_DEPTH = 64;
+
+constexpr const char* PERSONALITY_NAMES[BehaviorTree::PERSONALITY_COUNT] = {"NORMAL", "COWARD", "GREEDY", "CURIOUS"};
+
+struct NodeTypeName {
+    const char* name;
+    BehaviorNodeType type;
+};
+
+constexpr NodeTypeName NODE_TYPES[] = {
+    {"state", BehaviorNodeType::IS_STATE},
+    {"near", BehaviorNodeType::IS_NEAR},
+    {"above", BehaviorNodeType::ABOVE},
+    {"chance", BehaviorNodeType::CHANCE},
+    {"effect_over", BehaviorNodeType::EFFECT_OVER},
+    {"set_state", BehaviorNodeType::SET_STATE},
+    {"add_time", BehaviorNodeType::ADD_TIME},
+    {"clear", BehaviorNodeType::CLEAR},
+    {"approach_player", BehaviorNodeType::APPROACH_PLAYER},
+    {"random_direction", BehaviorNodeType::RANDOM_DIRECTION},
+    {"wander_pause", BehaviorNodeType::WANDER_PAUSE},
+    {"wander_turn", BehaviorNodeType::WANDER_TURN},
+    {"flee", BehaviorNodeType::FLEE},
+    {"seek_catnip", BehaviorNodeType::SEEK_CATNIP},
+};
+
+// 把 JSON 树编译成跳转：已知一棵子树成功、失败后分别接着执行哪个节点，就能算出它的入口
+// 组合节点从最后一个子节点倒着编译，每个子节点的后继就是已经编好的下一个子节点的入口；
+// 子树引用原地展开，叶子按倒序追加，全部编完后再整体翻转成执行顺序
+class TreeCompiler {
+public:
+    TreeCompiler(const rapidjson::Value* subtrees, std::vector<BehaviorNode>& nodes, std::string& error)
+        : subtrees(subtrees), nodes(nodes), error(error) {}
+
+    bool compile(const rapidjson::Value& value, uint16_t success, uint16_t failure, size_t depth, uint16_t& entry) {
+        if (depth >= MAX_DEPTH) return fail("树嵌套过深（或子树循环引用）");
+        if (!value.IsObject()) return fail("节点必须是对象");
+
+        std::string type;
+        if (!readString(value, "type", type)) return fail("节点缺少 type");
+
+        if (type == "subtree") {
+            std::string name;
+            if (!readString(value, "name", name)) return fail("subtree 缺少 name");
+            if (!subtrees || !subtrees->HasMember(name.c_str())) return fail("未定义的子树: " + name);
+            return compile((*subtrees)[name.c_str()], success, failure, depth + 1, entry);
+        }
+
+        // 选择：失败时试下一个子节点；顺序：成功时做下一个子节点
+        if (type == "selector" || type == "sequence") {
+            auto children = value.FindMember("children");
+            if (children == value.MemberEnd() || !children->value.IsArray()) return fail(type + " 缺少 children 数组");
+
+            const bool selector = type == "selector";
+            uint16_t next = selector ? failure : success;
+            for (rapidjson::SizeType i = children->value.Size(); i-- > 0;) {
+                const rapidjson::Value& child = children->value[i];
+                if (!compile(child, selector ? success : next, selector ? next : failure, depth + 1, next)) return false;
+            }
+            entry = next;
+            return true;
+        }
+
+        // 取反：交换后继；总是成功：两个后继都是成功
+        if (type == "invert" || type == "succeed") {
+            auto child = value.FindMember("child");
+            if (child == value.MemberEnd()) {
+                if (type == "invert") return fail("invert 缺少 child");
+                entry = success;
+                return true;
+            }
+            if (type == "invert") return compile(child->value, failure, success, depth + 1, entry);
+            return compile(child->value, success, success, depth + 1, entry);
+        }
+
+        const NodeTypeName* found = nullptr;
+        for (const NodeTypeName& item : NODE_TYPES) {
+            if (type == item.name) found = &item;
+        }
+        if (!found) return fail("未知的节点类型: " + type);
+        if (nodes.size() >= BehaviorNode::END) return fail("节点过多");
+
+        BehaviorNode node;
+        node.type = found->type;
+        node.onSuccess = success;
+        node.onFailure = failure;
+        if (!readParams(value, node)) return false;
+
+        entry = static_cast<uint16_t>(nodes.size());
+        nodes.push_back(node);
+        return true;
+    }
+
+private:
+    bool fail(const std::string& message) {
+        error = message;
+        return false;
+    }
+
+    static bool readString(const rapidjson::Value& value, const char* key, std::string& out) {
+        auto member = value.FindMember(key);
+        if (member == value.MemberEnd() || !member->value.IsString()) return false;
+        out.assign(member->value.GetString(), member->value.GetStringLength());
+        return true;
+    }
+
+    static float readFloat(const rapidjson::Value& value, const char* key, float fallback) {
+        auto member = value.FindMember(key);
+        if (member == value.MemberEnd() || !member->value.IsNumber()) return fallback;
+        return static_cast<float>(member->value.GetDouble());
+    }
+
+    bool readState(const rapidjson::Value& value, uint8_t& out) {
+        std::string state;
+        if (!readString(value, "state", state)) return fail("缺少 state");
+        if (state == "normal") out = static_cast<uint8_t>(CatState::NORMAL);
+        else if (state == "fleeing") out = static_cast<uint8_t>(CatState::FLEEING);
+        else if (state == "catnipped") out = static_cast<uint8_t>(CatState::CATNIPPED);
+        else return fail("未知的状态: " + state);
+        return true;
+    }
+
+    // 黑板键名在编译时换成槽位编号，同名共用一个槽位
+    bool readSlot(const rapidjson::Value& value, uint8_t& out) {
+        std::string key;
+        if (!readString(value, "key", key)) return fail("缺少 key");
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) {
+                out = static_cast<uint8_t>(i);
+                return true;
+            }
+        }
+        if (keys.size() >= BehaviorTree::BLACKBOARD_SLOTS) return fail("黑板槽位不足: " + key);
+        out = static_cast<uint8_t>(keys.size());
+        keys.push_back(key);
+        return true;
+    }
+
+    bool readParams(const rapidjson::Value& value, BehaviorNode& node) {
+        switch (node.type) {
+            case BehaviorNodeType::IS_STATE:
+                return readState(value, node.arg);
+            case BehaviorNodeType::IS_NEAR: {
+                std::string range;
+                if (!readString(value, "range", range)) return fail("near 缺少 range");
+                if (range == "alert") node.arg = CatKernels::NEAR_ALERT;
+                else if (range == "curious") node.arg = CatKernels::NEAR_CURIOUS;
+                else if (range == "attract") node.arg = CatKernels::NEAR_ATTRACT;
+                else if (range == "attract_half") node.arg = CatKernels::NEAR_ATTRACT_HALF;
+                else return fail("未知的范围: " + range);
+                return true;
+            }
+            case BehaviorNodeType::ABOVE:
+                node.params[0] = readFloat(value, "value", 0.0f);
+                return readSlot(value, node.arg);
+            case BehaviorNodeType::ADD_TIME:
+            case BehaviorNodeType::CLEAR:
+                return readSlot(value, node.arg);
+            case BehaviorNodeType::CHANCE: {
+                auto percent = value.FindMember("percent");
+                if (percent == value.MemberEnd() || !percent->value.IsInt() ||
+                    percent->value.GetInt() < 0 || percent->value.GetInt() > 100) {
+                    return fail("chance 的 percent 必须是 0-100 的整数");
+                }
+                node.arg = static_cast<uint8_t>(percent->value.GetInt());
+                return true;
+            }
+            case BehaviorNodeType::SET_STATE: {
+                if (!readState(value, node.arg)) return false;
+
+                auto duration = value.FindMember("duration");
+                if (duration != value.MemberEnd()) {
+                    if (duration->value.IsNumber()) {
+                        node.options |= STATE_SET_DURATION;
+                        node.params[0] = static_cast<float>(duration->value.GetDouble());
+                    } else if (duration->value.IsString() && std::string(duration->value.GetString()) == "effect") {
+                        node.options |= STATE_EFFECT_DURATION;
+                        node.params[0] = readFloat(value, "effectScale", 1.0f);
+                        node.params[1] = readFloat(value, "scale", 1.0f);
+                        node.params[2] = readFloat(value, "captureBonus", 0.5f);
+                    } else {
+                        return fail("duration 必须是数字或 \"effect\"");
+                    }
+                }
+
+                std::string target;
+                if (readString(value, "target", target)) {
+                    if (target == "player") node.options |= STATE_TARGET_PLAYER;
+                    else if (target == "catnip") node.options |= STATE_TARGET_CATNIP;
+                    else return fail("未知的目标: " + target);
+                }
+
+                auto notify = value.FindMember("notify");
+                if (notify != value.MemberEnd() && notify->value.IsBool() && notify->value.GetBool()) {
+                    node.options |= STATE_NOTIFY;
+                }
+                return true;
+            }
+            case BehaviorNodeType::APPROACH_PLAYER:
+                node.params[0] = readFloat(value, "speed", 1.0f);
+                node.params[1] = readFloat(value, "minDistance", 0.0f);
+                node.params[2] = readFloat(value, "maxDistance", std::numeric_limits<float>::infinity());
+                return true;
+            case BehaviorNodeType::FLEE:
+            case BehaviorNodeType::SEEK_CATNIP:
+                node.params[0] = readFloat(value, "timeScale", 1.0f);
+                return true;
+            default:
+                return true;
+        }
+    }
+
+    const rapidjson::Value* subtrees;
+    std::vector<BehaviorNode>& nodes;
+    std::string& error;
+    std::vector<std::string> keys;
+};
+
+} // namespace
+
+BehaviorTree::BehaviorTree() {
+    roots.fill(BehaviorNode::END);
+}
+
+bool BehaviorTree::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "无法打开行为树文件: " + path;
+        return false;
+    }
+
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!loadFromString(text)) {
+        error = path + ": " + error;
+        return false;
+    }
+    std::cout << "行为树加载成功: " << path << " (" << nodes.size() << " 个节点)" << std::endl;
+    return true;
+}
+
+bool BehaviorTree::loadFromString(const std::string& text) {
+    error.clear();
+
+    rapidjson::Document document;
+    document.Parse<rapidjson::kParseFullPrecisionFlag | rapidjson::kParseCommentsFlag>(text.c_str());
+    if (document.HasParseError()) {
+        error = std::string(rapidjson::GetParseError_En(document.GetParseError())) +
+                " (偏移 " + std::to_string(document.GetErrorOffset()) + ")";
+        return false;
+    }
+    if (!document.IsObject()) {
+        error = "根节点必须是对象";
+        return false;
+    }
+
+    auto personalities = document.FindMember("personalities");
+    if (personalities == document.MemberEnd() || !personalities->value.IsObject()) {
+        error = "缺少 personalities";
+        return false;
+    }
+    auto subtrees = document.FindMember("subtrees");
+    const rapidjson::Value* subtreeTable = nullptr;
+    if (subtrees != document.MemberEnd() && subtrees->value.IsObject()) subtreeTable = &subtrees->value;
+
+    // 编译到临时数组，全部成功后才替换
+    std::vector<BehaviorNode> compiled;
+    std::array<uint16_t, PERSONALITY_COUNT> compiledRoots;
+    std::array<bool, PERSONALITY_COUNT> defined;
+    defined.fill(false);
+    TreeCompiler compiler(subtreeTable, compiled, error);
+
+    for (const auto& member : personalities->value.GetObject()) {
+        std::string name(member.name.GetString(), member.name.GetStringLength());
+        size_t personality = PERSONALITY_COUNT;
+        for (size_t i = 0; i < PERSONALITY_COUNT; i++) {
+            if (name == PERSONALITY_NAMES[i]) personality = i;
+        }
+        if (personality == PERSONALITY_COUNT) {
+            error = "未知的性格: " + name;
+            return false;
+        }
+
+        if (!compiler.compile(member.value, BehaviorNode::END, BehaviorNode::END, 0, compiledRoots[personality])) {
+            error = name + ": " + error;
+            return false;
+        }
+        defined[personality] = true;
+    }
+
+    // 没写的性格沿用 NORMAL
+    const size_t normal = static_cast<size_t>(CatPersonality::NORMAL);
+    if (!defined[normal]) {
+        error = "缺少 NORMAL 性格";
+        return false;
+    }
+    for (size_t i = 0; i < PERSONALITY_COUNT; i++) {
+        if (!defined[i]) compiledRoots[i] = compiledRoots[normal];
+    }
+
+    // 叶子是倒序追加的，翻转后大体按执行顺序排列
+    const uint16_t last = static_cast<uint16_t>(compiled.size() - 1);
+    auto flip = [last](uint16_t node) { return node == BehaviorNode::END ? node : static_cast<uint16_t>(last - node); };
+    std::reverse(compiled.begin(), compiled.end());
+    for (BehaviorNode& node : compiled) {
+        node.onSuccess = flip(node.onSuccess);
+        node.onFailure = flip(node.onFailure);
+    }
+    for (uint16_t& root : compiledRoots) root = flip(root);
+
+    nodes = std::move(compiled);
+    roots = compiledRoots;
+    return true;
+}
+
+const BehaviorTree& BehaviorTree::getDefault() {
+    static const BehaviorTree tree = [] {
+        BehaviorTree builtIn;
+        if (!builtIn.loadFromString(DEFAULT_BEHAVIOR)) {
+            std::cerr << "内置行为树编译失败: " << builtIn.getError() << std::endl;
+        }
+        return builtIn;
+    }();
+    return tree;
+}
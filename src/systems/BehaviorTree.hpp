@@ -0,0 +1,86 @@
+#ifndef BEHAVIORTREE_HPP
+#define BEHAVIORTREE_HPP
+
+#include "../entities/Cat.hpp"
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 编译后的节点类型：只有条件和动作，组合节点（selector、sequence、invert、succeed）在编译时消解成跳转
+enum class BehaviorNodeType : uint8_t {
+    // 条件
+    IS_STATE,           // 当前状态为 arg
+    IS_NEAR,            // 距离标志含 arg（CatKernels::NEAR_*）
+    ABOVE,              // 黑板槽位 arg 大于 params[0]
+    CHANCE,             // arg% 概率成功，消耗猫自己的随机流
+    EFFECT_OVER,        // 猫薄荷 / 逃跑计时结束
+    // 动作（除 APPROACH_PLAYER 外总是成功）
+    SET_STATE,          // 切换到状态 arg，options 决定是否设定时长、目标和发事件
+    ADD_TIME,           // 黑板槽位 arg 加上本步时长
+    CLEAR,              // 黑板槽位 arg 清零
+    APPROACH_PLAYER,    // 距离在 (params[1], params[2]) 内时以 params[0] 倍速度走向玩家，否则失败
+    RANDOM_DIRECTION,   // 随机选一个方向走
+    WANDER_PAUSE,       // 随机游走：定时随机停下或起步
+    WANDER_TURN,        // 随机游走：定时转向、随机停走
+    FLEE,               // 逃离目标点，params[0] 为寻路计时倍率
+    SEEK_CATNIP         // 走向猫薄荷，params[0] 为寻路计时倍率
+};
+
+// SET_STATE 的选项
+enum BehaviorStateOption : uint8_t {
+    STATE_SET_DURATION = 1,     // 设定计时：params[0] 为固定时长
+    STATE_EFFECT_DURATION = 2,  // 计时按沉迷时长算：(基础时长 + 已抓数 * params[2]) * params[0] * params[1]
+    STATE_TARGET_PLAYER = 4,    // 目标点设为玩家位置
+    STATE_TARGET_CATNIP = 8,    // 目标点设为猫薄荷位置
+    STATE_NOTIFY = 16           // 发出 STATE_CHANGED 事件
+};
+
+// 节点执行后按结果跳到 onSuccess 或 onFailure，END 表示这一步的求值结束
+struct BehaviorNode {
+    static constexpr uint16_t END = 0xFFFF;
+
+    BehaviorNodeType type = BehaviorNodeType::IS_STATE;
+    uint8_t arg = 0;
+    uint8_t options = 0;
+    uint16_t onSuccess = END;
+    uint16_t onFailure = END;
+    float params[3] = {0.0f, 0.0f, 0.0f};
+};
+
+// 猫咪行为树：JSON 中每种性格一棵树，加载时编译成一个连续的节点数组
+// 每个模拟步从根重新求值，不保存运行中的节点，所以只有成功和失败两种结果；
+// 于是组合节点可以在编译时展开：每个条件、动作记下成功和失败后接着执行哪个节点，
+// 求值只是沿跳转依次执行，不需要栈，也不做虚函数调用和内存分配
+// 需要跨步保存的数据（如好奇计时）放在每只猫的黑板槽位里，键名在编译时换成槽位编号
+class BehaviorTree {
+public:
+    static constexpr size_t BLACKBOARD_SLOTS = 4;
+    static constexpr size_t PERSONALITY_COUNT = static_cast<size_t>(CatPersonality::CURIOUS) + 1;
+
+    BehaviorTree();
+
+    // 读取并编译 JSON，失败时保留原来的树
+    bool loadFromFile(const std::string& path);
+    bool loadFromString(const std::string& text);
+
+    // 内置的默认行为，编译自程序内嵌的 JSON
+    static const BehaviorTree& getDefault();
+
+    const BehaviorNode* getNodes() const { return nodes.data(); }
+    size_t getNodeCount() const { return nodes.size(); }
+    // 性格对应的第一个节点，BehaviorNode::END 表示什么也不做
+    uint16_t getRoot(CatPersonality personality) const { return roots[static_cast<size_t>(personality)]; }
+
+    // 错误信息
+    const std::string& getError() const { return error; }
+
+private:
+    std::vector<BehaviorNode> nodes;
+    std::array<uint16_t, PERSONALITY_COUNT> roots;
+    std::string error;
+};
+
+using CatBlackboard = std::array<float, BehaviorTree::BLACKBOARD_SLOTS>;
+
+#endif // BEHAVIORTREE_HPP
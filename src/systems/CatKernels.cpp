@@ -0,0 +1,297 @@
+#include "CatKernels.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CATKERNELS_USE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 版本用 target 属性单独编译，运行时检测 CPU 后才调用，整个程序不需要 -mavx2
+#define CATKERNELS_USE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+// Vector2 数组在内存中是 x0 y0 x1 y1 ...，SIMD 版本在加载后拆成 x、y 两组
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 必须是紧凑的两个 float");
+
+void CatKernels::evaluateProximityScalar(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                         size_t begin, size_t end, Vector2 playerPosition, Vector2 catnipPosition,
+                                         bool hasCatnip, uint8_t* flags) {
+    const float curiousRange2 = CURIOUS_RANGE * CURIOUS_RANGE;
+    for (size_t i = begin; i < end; i++) {
+        float dx = positions[i].x - playerPosition.x;
+        float dy = positions[i].y - playerPosition.y;
+        float playerDistance2 = dx * dx + dy * dy;
+
+        uint8_t result = 0;
+        if (playerDistance2 < alertRanges[i] * alertRanges[i]) result |= NEAR_ALERT;
+        if (playerDistance2 < curiousRange2) result |= NEAR_CURIOUS;
+
+        if (hasCatnip) {
+            float cdx = positions[i].x - catnipPosition.x;
+            float cdy = positions[i].y - catnipPosition.y;
+            float catnipDistance2 = cdx * cdx + cdy * cdy;
+            float halfRange = attractRanges[i] * 0.5f;
+            if (catnipDistance2 < attractRanges[i] * attractRanges[i]) result |= NEAR_ATTRACT;
+            if (catnipDistance2 < halfRange * halfRange) result |= NEAR_ATTRACT_HALF;
+        }
+        flags[i] = result;
+    }
+}
+
+void CatKernels::applySteeringScalar(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                                     size_t begin, size_t end, Vector2* velocities) {
+    for (size_t i = begin; i < end; i++) {
+        if (!(speeds[i] > 0.0f)) continue;
+
+        float dx = directions[i].x;
+        float dy = directions[i].y;
+        float length = std::sqrt(dx * dx + dy * dy);
+        float nx = 0.0f;
+        float ny = 0.0f;
+        if (length > 0.0f) {
+            nx = dx / length;
+            ny = dy / length;
+        }
+        velocities[i].x = nx * speeds[i] + ny * sideSpeeds[i];
+        velocities[i].y = ny * speeds[i] - nx * sideSpeeds[i];
+    }
+}
+
+#ifdef CATKERNELS_USE_SSE2
+
+// 每次 4 只猫
+static size_t evaluateProximitySse2(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                    size_t count, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip,
+                                    uint8_t* flags) {
+    const __m128 playerX = _mm_set1_ps(playerPosition.x);
+    const __m128 playerY = _mm_set1_ps(playerPosition.y);
+    const __m128 catnipX = _mm_set1_ps(catnipPosition.x);
+    const __m128 catnipY = _mm_set1_ps(catnipPosition.y);
+    const __m128 curiousRange2 = _mm_set1_ps(CatKernels::CURIOUS_RANGE * CatKernels::CURIOUS_RANGE);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(&positions[i].x);        // x0 y0 x1 y1
+        __m128 b = _mm_loadu_ps(&positions[i + 2].x);    // x2 y2 x3 y3
+        __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128 dx = _mm_sub_ps(x, playerX);
+        __m128 dy = _mm_sub_ps(y, playerY);
+        __m128 playerDistance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 alert = _mm_loadu_ps(alertRanges + i);
+        int alertMask = _mm_movemask_ps(_mm_cmplt_ps(playerDistance2, _mm_mul_ps(alert, alert)));
+        int curiousMask = _mm_movemask_ps(_mm_cmplt_ps(playerDistance2, curiousRange2));
+
+        int attractMask = 0;
+        int halfMask = 0;
+        if (hasCatnip) {
+            __m128 cdx = _mm_sub_ps(x, catnipX);
+            __m128 cdy = _mm_sub_ps(y, catnipY);
+            __m128 catnipDistance2 = _mm_add_ps(_mm_mul_ps(cdx, cdx), _mm_mul_ps(cdy, cdy));
+            __m128 attract = _mm_loadu_ps(attractRanges + i);
+            __m128 halfRange = _mm_mul_ps(attract, half);
+            attractMask = _mm_movemask_ps(_mm_cmplt_ps(catnipDistance2, _mm_mul_ps(attract, attract)));
+            halfMask = _mm_movemask_ps(_mm_cmplt_ps(catnipDistance2, _mm_mul_ps(halfRange, halfRange)));
+        }
+
+        for (int lane = 0; lane < 4; lane++) {
+            flags[i + lane] = static_cast<uint8_t>(
+                (((alertMask >> lane) & 1) ? CatKernels::NEAR_ALERT : 0) |
+                (((curiousMask >> lane) & 1) ? CatKernels::NEAR_CURIOUS : 0) |
+                (((attractMask >> lane) & 1) ? CatKernels::NEAR_ATTRACT : 0) |
+                (((halfMask >> lane) & 1) ? CatKernels::NEAR_ATTRACT_HALF : 0));
+        }
+    }
+    return i;
+}
+
+static size_t applySteeringSse2(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                                size_t count, Vector2* velocities) {
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 speed = _mm_loadu_ps(speeds + i);
+        __m128 active = _mm_cmpgt_ps(speed, zero);
+        if (_mm_movemask_ps(active) == 0) continue;
+
+        __m128 a = _mm_loadu_ps(&directions[i].x);
+        __m128 b = _mm_loadu_ps(&directions[i + 2].x);
+        __m128 dx = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 dy = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 valid = _mm_cmpgt_ps(length, zero);
+        __m128 nx = _mm_and_ps(valid, _mm_div_ps(dx, length));
+        __m128 ny = _mm_and_ps(valid, _mm_div_ps(dy, length));
+
+        __m128 side = _mm_loadu_ps(sideSpeeds + i);
+        __m128 vx = _mm_add_ps(_mm_mul_ps(nx, speed), _mm_mul_ps(ny, side));
+        __m128 vy = _mm_sub_ps(_mm_mul_ps(ny, speed), _mm_mul_ps(nx, side));
+
+        // 交错回 x y x y，只覆盖需要转向的猫
+        __m128 activeLow = _mm_unpacklo_ps(active, active);
+        __m128 activeHigh = _mm_unpackhi_ps(active, active);
+        __m128 oldLow = _mm_loadu_ps(&velocities[i].x);
+        __m128 oldHigh = _mm_loadu_ps(&velocities[i + 2].x);
+        __m128 newLow = _mm_unpacklo_ps(vx, vy);
+        __m128 newHigh = _mm_unpackhi_ps(vx, vy);
+        _mm_storeu_ps(&velocities[i].x, _mm_or_ps(_mm_and_ps(activeLow, newLow), _mm_andnot_ps(activeLow, oldLow)));
+        _mm_storeu_ps(&velocities[i + 2].x, _mm_or_ps(_mm_and_ps(activeHigh, newHigh), _mm_andnot_ps(activeHigh, oldHigh)));
+    }
+    return i;
+}
+
+#endif // CATKERNELS_USE_SSE2
+
+#ifdef CATKERNELS_USE_AVX2
+
+// 8 只猫的坐标拆成 x、y 两组：shuffle 之后顺序是 0 1 4 5 2 3 6 7，再按 64 位重排
+__attribute__((target("avx2")))
+static inline void loadVector2x8(const Vector2* source, __m256& x, __m256& y) {
+    __m256 a = _mm256_loadu_ps(&source[0].x);
+    __m256 b = _mm256_loadu_ps(&source[4].x);
+    __m256 shuffledX = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 shuffledY = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(shuffledX), _MM_SHUFFLE(3, 1, 2, 0)));
+    y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(shuffledY), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+__attribute__((target("avx2")))
+static size_t evaluateProximityAvx2(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                    size_t count, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip,
+                                    uint8_t* flags) {
+    const __m256 playerX = _mm256_set1_ps(playerPosition.x);
+    const __m256 playerY = _mm256_set1_ps(playerPosition.y);
+    const __m256 catnipX = _mm256_set1_ps(catnipPosition.x);
+    const __m256 catnipY = _mm256_set1_ps(catnipPosition.y);
+    const __m256 curiousRange2 = _mm256_set1_ps(CatKernels::CURIOUS_RANGE * CatKernels::CURIOUS_RANGE);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y;
+        loadVector2x8(positions + i, x, y);
+
+        __m256 dx = _mm256_sub_ps(x, playerX);
+        __m256 dy = _mm256_sub_ps(y, playerY);
+        __m256 playerDistance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 alert = _mm256_loadu_ps(alertRanges + i);
+        int alertMask = _mm256_movemask_ps(_mm256_cmp_ps(playerDistance2, _mm256_mul_ps(alert, alert), _CMP_LT_OQ));
+        int curiousMask = _mm256_movemask_ps(_mm256_cmp_ps(playerDistance2, curiousRange2, _CMP_LT_OQ));
+
+        int attractMask = 0;
+        int halfMask = 0;
+        if (hasCatnip) {
+            __m256 cdx = _mm256_sub_ps(x, catnipX);
+            __m256 cdy = _mm256_sub_ps(y, catnipY);
+            __m256 catnipDistance2 = _mm256_add_ps(_mm256_mul_ps(cdx, cdx), _mm256_mul_ps(cdy, cdy));
+            __m256 attract = _mm256_loadu_ps(attractRanges + i);
+            __m256 halfRange = _mm256_mul_ps(attract, half);
+            attractMask = _mm256_movemask_ps(_mm256_cmp_ps(catnipDistance2, _mm256_mul_ps(attract, attract), _CMP_LT_OQ));
+            halfMask = _mm256_movemask_ps(_mm256_cmp_ps(catnipDistance2, _mm256_mul_ps(halfRange, halfRange), _CMP_LT_OQ));
+        }
+
+        for (int lane = 0; lane < 8; lane++) {
+            flags[i + lane] = static_cast<uint8_t>(
+                (((alertMask >> lane) & 1) ? CatKernels::NEAR_ALERT : 0) |
+                (((curiousMask >> lane) & 1) ? CatKernels::NEAR_CURIOUS : 0) |
+                (((attractMask >> lane) & 1) ? CatKernels::NEAR_ATTRACT : 0) |
+                (((halfMask >> lane) & 1) ? CatKernels::NEAR_ATTRACT_HALF : 0));
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t applySteeringAvx2(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                                size_t count, Vector2* velocities) {
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 speed = _mm256_loadu_ps(speeds + i);
+        __m256 active = _mm256_cmp_ps(speed, zero, _CMP_GT_OQ);
+        if (_mm256_movemask_ps(active) == 0) continue;
+
+        __m256 dx, dy;
+        loadVector2x8(directions + i, dx, dy);
+
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+        __m256 nx = _mm256_and_ps(valid, _mm256_div_ps(dx, length));
+        __m256 ny = _mm256_and_ps(valid, _mm256_div_ps(dy, length));
+
+        __m256 side = _mm256_loadu_ps(sideSpeeds + i);
+        __m256 vx = _mm256_add_ps(_mm256_mul_ps(nx, speed), _mm256_mul_ps(ny, side));
+        __m256 vy = _mm256_sub_ps(_mm256_mul_ps(ny, speed), _mm256_mul_ps(nx, side));
+
+        // unpack 得到 0 1 | 4 5 和 2 3 | 6 7，再按 128 位拼回 0-3 和 4-7
+        __m256 newLow = _mm256_unpacklo_ps(vx, vy);
+        __m256 newHigh = _mm256_unpackhi_ps(vx, vy);
+        __m256 activeLow = _mm256_unpacklo_ps(active, active);
+        __m256 activeHigh = _mm256_unpackhi_ps(active, active);
+        __m256 newFirst = _mm256_permute2f128_ps(newLow, newHigh, 0x20);
+        __m256 newSecond = _mm256_permute2f128_ps(newLow, newHigh, 0x31);
+        __m256 activeFirst = _mm256_permute2f128_ps(activeLow, activeHigh, 0x20);
+        __m256 activeSecond = _mm256_permute2f128_ps(activeLow, activeHigh, 0x31);
+
+        __m256 oldFirst = _mm256_loadu_ps(&velocities[i].x);
+        __m256 oldSecond = _mm256_loadu_ps(&velocities[i + 4].x);
+        _mm256_storeu_ps(&velocities[i].x, _mm256_blendv_ps(oldFirst, newFirst, activeFirst));
+        _mm256_storeu_ps(&velocities[i + 4].x, _mm256_blendv_ps(oldSecond, newSecond, activeSecond));
+    }
+    return i;
+}
+
+static bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // CATKERNELS_USE_AVX2
+
+void CatKernels::evaluateProximity(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                   size_t count, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip,
+                                   uint8_t* flags) {
+    size_t done = 0;
+#if defined(CATKERNELS_USE_AVX2)
+    if (hasAvx2()) {
+        done = evaluateProximityAvx2(positions, alertRanges, attractRanges, count, playerPosition, catnipPosition, hasCatnip, flags);
+    } else {
+        done = evaluateProximitySse2(positions, alertRanges, attractRanges, count, playerPosition, catnipPosition, hasCatnip, flags);
+    }
+#elif defined(CATKERNELS_USE_SSE2)
+    done = evaluateProximitySse2(positions, alertRanges, attractRanges, count, playerPosition, catnipPosition, hasCatnip, flags);
+#endif
+    // 不足一组的尾部
+    evaluateProximityScalar(positions, alertRanges, attractRanges, done, count, playerPosition, catnipPosition, hasCatnip, flags);
+}
+
+void CatKernels::applySteering(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                               size_t count, Vector2* velocities) {
+    size_t done = 0;
+#if defined(CATKERNELS_USE_AVX2)
+    if (hasAvx2()) {
+        done = applySteeringAvx2(directions, speeds, sideSpeeds, count, velocities);
+    } else {
+        done = applySteeringSse2(directions, speeds, sideSpeeds, count, velocities);
+    }
+#elif defined(CATKERNELS_USE_SSE2)
+    done = applySteeringSse2(directions, speeds, sideSpeeds, count, velocities);
+#endif
+    applySteeringScalar(directions, speeds, sideSpeeds, done, count, velocities);
+}
+
+const char* CatKernels::getInstructionSet() {
+#if defined(CATKERNELS_USE_AVX2)
+    return hasAvx2() ? "AVX2" : "SSE2";
+#elif defined(CATKERNELS_USE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef CATKERNELS_HPP
+#define CATKERNELS_HPP
+
+#include <raylib.h>
+#include <cstdint>
+#include <cstddef>
+
+// 猫咪批量计算内核：直接在 CatSystem 的连续数组上一次处理 4/8 只猫
+// x86-64 上默认 SSE2，运行时检测到 AVX2 时改用 AVX2，其他平台用标量版本；
+// 各版本的运算顺序相同且不使用 FMA，结果逐位一致，同一世界种子在任何机器上复现相同结果
+class CatKernels {
+public:
+    // evaluateProximity 输出的标志位
+    static constexpr uint8_t NEAR_ALERT = 1 << 0;           // 玩家在逃跑范围内
+    static constexpr uint8_t NEAR_CURIOUS = 1 << 1;         // 玩家在好奇猫的观察范围内
+    static constexpr uint8_t NEAR_ATTRACT = 1 << 2;         // 猫薄荷在吸引范围内
+    static constexpr uint8_t NEAR_ATTRACT_HALF = 1 << 3;    // 猫薄荷在一半吸引范围内
+
+    static constexpr float CURIOUS_RANGE = 200.0f;
+
+    // 按每只猫的逃跑/吸引范围判断与玩家、猫薄荷的距离（比较平方距离，不开方）
+    // 没有猫薄荷时不输出吸引标志
+    static void evaluateProximity(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                  size_t count, Vector2 playerPosition, Vector2 catnipPosition, bool hasCatnip,
+                                  uint8_t* flags);
+
+    // 把方向归一化后乘以速度得到新速度，sideSpeeds 为沿方向右侧垂直方向的附加速度
+    // 只写入 speeds > 0 的猫，其余保持原速度；方向为零向量时速度为零
+    static void applySteering(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                              size_t count, Vector2* velocities);
+
+    // 当前使用的指令集："AVX2"、"SSE2" 或 "scalar"
+    static const char* getInstructionSet();
+
+private:
+    static void evaluateProximityScalar(const Vector2* positions, const float* alertRanges, const float* attractRanges,
+                                        size_t begin, size_t end, Vector2 playerPosition, Vector2 catnipPosition,
+                                        bool hasCatnip, uint8_t* flags);
+    static void applySteeringScalar(const Vector2* directions, const float* speeds, const float* sideSpeeds,
+                                    size_t begin, size_t end, Vector2* velocities);
+};
+
+#endif // CATKERNELS_HPP
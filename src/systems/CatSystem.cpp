@@ -0,0 +1,708 @@
+#include "CatSystem.hpp"
+#include "MapLoader.hpp"
+#include "NavigationSystem.hpp"
+#include "CatKernels.hpp"
+#include "../core/ResourceManager.hpp"
+#include "../core/JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// 并行更新时每块的猫数：块太小调度开销占比高，太大则线程间负载不均
+static constexpr size_t UPDATE_GRAIN = 128;
+
+CatSystem::CatSystem(size_t capacity)
+    : collisionMap(nullptr), navigation(nullptr), jobs(nullptr), behavior(&BehaviorTree::getDefault()),
+      deferNavigation(false), textureLoading(true), verbose(false), tick(0), spatialDirty(true),
+      maxAlertRange(0.0f), maxAttractRange(0.0f) {
+    typeSpriteLoaded.fill(false);
+    typeSprites.fill(Texture2D{0});
+
+    // 按容量一次预留，之后生成和删除都不会再扩容
+    positions.reserve(capacity);
+    previousPositions.reserve(capacity);
+    velocities.reserve(capacity);
+    sizes.reserve(capacity);
+    speeds.reserve(capacity);
+    states.reserve(capacity);
+    caught.reserve(capacity);
+    moving.reserve(capacity);
+    facingRight.reserve(capacity);
+    stateTimers.reserve(capacity);
+    catnipEffectTimers.reserve(capacity);
+    aiChangeDirectionTimers.reserve(capacity);
+    aiChangeDirectionIntervals.reserve(capacity);
+    blackboards.reserve(capacity);
+    smartMovePatterns.reserve(capacity);
+    catnipPositions.reserve(capacity);
+    types.reserve(capacity);
+    personalities.reserve(capacity);
+    baseEffectTimes.reserve(capacity);
+    rngs.reserve(capacity);
+    lods.reserve(capacity);
+    lastUpdateTicks.reserve(capacity);
+    alertRanges.reserve(capacity);
+    attractRanges.reserve(capacity);
+    fleeSpeeds.reserve(capacity);
+    catnipSpeeds.reserve(capacity);
+    proximityFlags.reserve(capacity);
+    steerDirections.reserve(capacity);
+    steerSpeeds.reserve(capacity);
+    steerSideSpeeds.reserve(capacity);
+    stepTimes.reserve(capacity);
+    events.reserve(capacity);
+    captureEvents.reserve(capacity);
+    nearbyCats.reserve(capacity);
+    nearbyPositions.reserve(capacity);
+    nearbyAlertRanges.reserve(capacity);
+    nearbyAttractRanges.reserve(capacity);
+    nearbyFlags.reserve(capacity);
+
+    names.reserve(capacity);
+    appearances.reserve(capacity);
+    animations.reserve(capacity);
+    statusIndicators.reserve(capacity);
+    spareIndicators.reserve(capacity);
+    paths.reserve(capacity);
+
+    // 槽位全部空闲，栈顶是 0 号槽位
+    slotIndices.assign(capacity, CatHandle::INVALID_SLOT);
+    slotGenerations.assign(capacity, 0);
+    indexSlots.reserve(capacity);
+    freeSlots.reserve(capacity);
+    for (size_t slot = capacity; slot-- > 0;) {
+        freeSlots.push_back(static_cast<uint32_t>(slot));
+    }
+}
+
+CatSystem::~CatSystem() {
+    clear();
+}
+
+CatHandle CatSystem::spawn(const char* name, Vector2 position, CatType type) {
+    if (full()) {
+        std::cerr << "猫咪池已满 (" << capacity() << ")，无法生成: " << name << std::endl;
+        return CatHandle();
+    }
+    if (!CatSpecies::isValid(type)) {
+        std::cerr << "未知品种 (" << static_cast<int>(type) << ")，无法生成: " << name << std::endl;
+        return CatHandle();
+    }
+
+    Index index = static_cast<Index>(size());
+    spatialDirty = true;
+
+    uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotIndices[slot] = index;
+    indexSlots.push_back(slot);
+
+    positions.push_back(position);
+    previousPositions.push_back(position);
+    velocities.push_back({0.0f, 0.0f});
+    sizes.push_back({CAT_WIDTH, CAT_HEIGHT});
+    speeds.push_back(50.0f);
+    states.push_back(CatState::NORMAL);
+    caught.push_back(0);
+    moving.push_back(0);
+    facingRight.push_back(1);
+    stateTimers.push_back(0.0f);
+    catnipEffectTimers.push_back(0.0f);
+    aiChangeDirectionTimers.push_back(0.0f);
+    aiChangeDirectionIntervals.push_back(0.0f);
+    blackboards.push_back({});
+    smartMovePatterns.push_back(0);
+    catnipPositions.push_back({0.0f, 0.0f});
+    types.push_back(type);
+    personalities.push_back(CatPersonality::NORMAL);
+    baseEffectTimes.push_back(10.0f);
+    rngs.push_back(RandomService::getInstance().split(RandomStream::CATS));
+    lods.push_back(CatLod::NEAR);
+    lastUpdateTicks.push_back(tick);
+    alertRanges.push_back(0.0f);
+    attractRanges.push_back(0.0f);
+    fleeSpeeds.push_back(0.0f);
+    catnipSpeeds.push_back(0.0f);
+
+    names.push_back(name);
+    appearances.emplace_back();
+    animations.emplace_back();
+    if (!spareIndicators.empty()) {
+        statusIndicators.push_back(std::move(spareIndicators.back()));
+        spareIndicators.pop_back();
+    } else {
+        statusIndicators.push_back(std::make_unique<StatusIndicator>());
+    }
+    paths.emplace_back();
+
+    Pcg32& gen = rngs[index];
+    CatAppearance& appearance = appearances[index];
+    CatAnimation& animation = animations[index];
+
+    aiChangeDirectionIntervals[index] = 2.0f + (float)(gen() % 3);
+
+    // 初始化动画计时器
+    animation.breathTimer = static_cast<float>(gen() % 100) / 10.0f;
+    animation.blinkTimer = 2.0f + static_cast<float>(gen() % 30) / 10.0f;
+    animation.tailWagTimer = static_cast<float>(gen() % 100) / 10.0f;
+
+    // 随机印象属性
+    appearance.eyeSize = 0.9f + static_cast<float>(gen() % 3) / 10.0f;
+    appearance.whiskerLength = 0.8f + static_cast<float>(gen() % 5) / 10.0f;
+    appearance.tailStyle = 0.8f + static_cast<float>(gen() % 5) / 10.0f;
+
+    // 随机稀有度 (5% 概率为闪光猫)
+    appearance.isShiny = (gen() % 100) < 5;
+    if (appearance.isShiny) {
+        // 闪光猫特效颜色
+        int effectType = gen() % 3;
+        if (effectType == 0) appearance.shinyEffectColor = GOLD;
+        else if (effectType == 1) appearance.shinyEffectColor = SKYBLUE;
+        else appearance.shinyEffectColor = PINK;
+    }
+
+    // 随机性格
+    int pType = gen() % 4;
+    if (pType == 1) personalities[index] = CatPersonality::COWARD;
+    else if (pType == 2) personalities[index] = CatPersonality::GREEDY;
+    else if (pType == 3) personalities[index] = CatPersonality::CURIOUS;
+
+    // 根据品种设置基础属性
+    Cat cat(this, index);
+    cat.setCatType(type);
+
+    // 设置初始随机方向
+    cat.changeRandomDirection();
+
+    // 加载纹理（每个品种只查找一次）
+    loadTypeSprite(type);
+    appearance.sprite = typeSprites[static_cast<size_t>(type)];
+
+    return {slot, slotGenerations[slot]};
+}
+
+void CatSystem::loadTypeSprite(CatType type) {
+    size_t typeIndex = static_cast<size_t>(type);
+    if (typeSpriteLoaded[typeIndex]) return;
+
+    std::string spritePath = CatSpecies::get(type).spritePath;
+
+    Texture2D sprite = {0};
+    if (!textureLoading) spritePath.clear();
+    if (!spritePath.empty()) {
+        sprite = ResourceManager::getInstance().loadTexture(spritePath);
+        if (sprite.id > 0) {
+            std::cout << "猫咪纹理加载成功: " << spritePath << std::endl;
+        } else {
+            // 尝试备用路径
+            spritePath = "../" + spritePath;
+            sprite = ResourceManager::getInstance().loadTexture(spritePath);
+            if (sprite.id > 0) {
+                std::cout << "猫咪纹理加载成功 (备用路径): " << spritePath << std::endl;
+            }
+        }
+    }
+
+    typeSpriteLoaded[typeIndex] = true;
+    typeSprites[typeIndex] = sprite;
+}
+
+void CatSystem::remove(Index index) {
+    if (index >= size()) return;
+    Cat(this, index).clearPath();
+    spatialDirty = true;
+
+    // 槽位回收：代数加一让旧引用失效，末尾的猫换到 index 后更新它的槽位
+    Index last = static_cast<Index>(size() - 1);
+    uint32_t slot = indexSlots[index];
+    slotIndices[slot] = CatHandle::INVALID_SLOT;
+    slotGenerations[slot]++;
+    freeSlots.push_back(slot);
+
+    // 状态指示器换到末尾，清空后留给下一只猫
+    std::swap(statusIndicators[index], statusIndicators[last]);
+    statusIndicators[last]->clearStatus();
+    spareIndicators.push_back(std::move(statusIndicators[last]));
+
+    // 与末尾交换后弹出
+    if (index != last) {
+        indexSlots[index] = indexSlots[last];
+        slotIndices[indexSlots[index]] = index;
+
+        positions[index] = positions[last];
+        previousPositions[index] = previousPositions[last];
+        velocities[index] = velocities[last];
+        sizes[index] = sizes[last];
+        speeds[index] = speeds[last];
+        states[index] = states[last];
+        caught[index] = caught[last];
+        moving[index] = moving[last];
+        facingRight[index] = facingRight[last];
+        stateTimers[index] = stateTimers[last];
+        catnipEffectTimers[index] = catnipEffectTimers[last];
+        aiChangeDirectionTimers[index] = aiChangeDirectionTimers[last];
+        aiChangeDirectionIntervals[index] = aiChangeDirectionIntervals[last];
+        blackboards[index] = blackboards[last];
+        smartMovePatterns[index] = smartMovePatterns[last];
+        catnipPositions[index] = catnipPositions[last];
+        types[index] = types[last];
+        personalities[index] = personalities[last];
+        baseEffectTimes[index] = baseEffectTimes[last];
+        rngs[index] = rngs[last];
+        lods[index] = lods[last];
+        lastUpdateTicks[index] = lastUpdateTicks[last];
+        alertRanges[index] = alertRanges[last];
+        attractRanges[index] = attractRanges[last];
+        fleeSpeeds[index] = fleeSpeeds[last];
+        catnipSpeeds[index] = catnipSpeeds[last];
+
+        names[index] = names[last];
+        appearances[index] = std::move(appearances[last]);
+        animations[index] = animations[last];
+        paths[index] = std::move(paths[last]);
+    }
+
+    positions.pop_back();
+    previousPositions.pop_back();
+    velocities.pop_back();
+    sizes.pop_back();
+    speeds.pop_back();
+    states.pop_back();
+    caught.pop_back();
+    moving.pop_back();
+    facingRight.pop_back();
+    stateTimers.pop_back();
+    catnipEffectTimers.pop_back();
+    aiChangeDirectionTimers.pop_back();
+    aiChangeDirectionIntervals.pop_back();
+    blackboards.pop_back();
+    smartMovePatterns.pop_back();
+    catnipPositions.pop_back();
+    types.pop_back();
+    personalities.pop_back();
+    baseEffectTimes.pop_back();
+    rngs.pop_back();
+    lods.pop_back();
+    lastUpdateTicks.pop_back();
+    indexSlots.pop_back();
+    alertRanges.pop_back();
+    attractRanges.pop_back();
+    fleeSpeeds.pop_back();
+    catnipSpeeds.pop_back();
+
+    names.pop_back();
+    appearances.pop_back();
+    animations.pop_back();
+    statusIndicators.pop_back();
+    paths.pop_back();
+}
+
+void CatSystem::release(CatHandle handle) {
+    if (isAlive(handle)) remove(slotIndices[handle.slot]);
+}
+
+bool CatSystem::isAlive(CatHandle handle) const {
+    return handle.slot < slotIndices.size() && slotIndices[handle.slot] != CatHandle::INVALID_SLOT &&
+           slotGenerations[handle.slot] == handle.generation;
+}
+
+size_t CatSystem::removeCaught() {
+    size_t removed = 0;
+    // 倒序删除：交换进来的末尾元素已经检查过
+    for (Index i = static_cast<Index>(size()); i-- > 0;) {
+        if (caught[i]) {
+            remove(i);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+void CatSystem::clear() {
+    while (!empty()) {
+        remove(static_cast<Index>(size() - 1));
+    }
+}
+
+size_t CatSystem::countActive() const {
+    return static_cast<size_t>(std::count(caught.begin(), caught.end(), 0));
+}
+
+void CatSystem::setNavigation(NavigationSystem* nav) {
+    for (Cat cat : *this) {
+        cat.clearPath();
+    }
+    navigation = nav;
+}
+
+void CatSystem::setBehavior(const BehaviorTree* tree) {
+    behavior = tree ? tree : &BehaviorTree::getDefault();
+
+    // 槽位编号随树变化，旧的黑板数据作废
+    for (CatBlackboard& blackboard : blackboards) {
+        blackboard.fill(0.0f);
+    }
+}
+
+void CatSystem::update(float deltaTime, const CatWorldSnapshot& world) {
+    const Index count = static_cast<Index>(size());
+    tick++;
+    collectPaths();
+
+    // 每帧的临时数组和事件缓冲区在分块之前准备好，各块只写自己的下标范围
+    proximityFlags.resize(count);
+    steerDirections.resize(count);
+    steerSpeeds.assign(count, 0.0f);
+    steerSideSpeeds.resize(count);
+    stepTimes.resize(count);
+    workerEvents.resize(jobs ? jobs->getThreadCount() : 1);
+    for (auto& buffer : workerEvents) buffer.clear();
+    workerMaxMoves.assign(workerEvents.size(), 0.0f);
+
+    deferNavigation = true;
+
+    // 1. 细节分级：醒来的休眠猫先瞬移，之后的位置就是本步模拟的起点
+    if (jobs) {
+        jobs->parallelFor(count, UPDATE_GRAIN, [this, deltaTime, &world](size_t begin, size_t end, unsigned) {
+            scheduleRange(static_cast<Index>(begin), static_cast<Index>(end), deltaTime, world);
+        });
+    } else {
+        scheduleRange(0, count, deltaTime, world);
+    }
+
+    // 2. 重建空间哈希，只判断玩家和猫薄荷附近的猫
+    rebuildSpatialHash();
+    evaluateNearby(world);
+
+    // 3. 行为树、转向和移动
+    if (jobs) {
+        jobs->parallelFor(count, UPDATE_GRAIN, [this, &world](size_t begin, size_t end, unsigned) {
+            updateRange(static_cast<Index>(begin), static_cast<Index>(end), world);
+        });
+    } else {
+        updateRange(0, count, world);
+    }
+    deferNavigation = false;
+
+    // 4. 哈希中的位置是移动前的，按本步最大位移外扩后再查询
+    detectCaptures(world);
+
+    flushPathRequests();
+    mergeEvents();
+
+    // 位置都变了，下次查询时再重建
+    spatialDirty = true;
+}
+
+void CatSystem::scheduleRange(Index begin, Index end, float deltaTime, const CatWorldSnapshot& world) {
+    std::copy(positions.begin() + begin, positions.begin() + end, previousPositions.begin() + begin);
+
+    for (Index i = begin; i < end; i++) {
+        stepTimes[i] = caught[i] ? 0.0f : scheduleLod(i, deltaTime, world);
+    }
+}
+
+void CatSystem::updateRange(Index begin, Index end, const CatWorldSnapshot& world) {
+    // 1. 推进计时器
+    for (Index i = begin; i < end; i++) {
+        if (stepTimes[i] <= 0.0f) continue;
+        Cat(this, i).updateTimers(stepTimes[i]);
+    }
+
+    // 2. 逐只运行行为树和状态指示器，距离判定结果来自 evaluateNearby；
+    //    逃跑和猫薄荷动作只给出方向和速度，随后批量换算成速度
+    const BehaviorTree& tree = *behavior;
+    for (Index i = begin; i < end; i++) {
+        if (stepTimes[i] <= 0.0f) continue;
+        Cat cat(this, i);
+        cat.runBehavior(tree, proximityFlags[i], world, stepTimes[i]);
+        cat.updateStatusIndicator(stepTimes[i]);
+    }
+    CatKernels::applySteering(steerDirections.data() + begin, steerSpeeds.data() + begin,
+                              steerSideSpeeds.data() + begin, end - begin, velocities.data() + begin);
+
+    // 3. 批量移动：撞墙时像碰到地图边界一样反弹
+    // previousPositions 即本步起点（醒来的猫已同步），记下最大位移供抓捕查询外扩
+    float maxMove = 0.0f;
+    for (Index i = begin; i < end; i++) {
+        if (stepTimes[i] <= 0.0f) continue;
+
+        const float stepTime = stepTimes[i];
+        Vector2& position = positions[i];
+        Vector2& velocity = velocities[i];
+        Vector2 delta = {velocity.x * stepTime, velocity.y * stepTime};
+        if (collisionMap) {
+            Rectangle rect = {position.x, position.y, sizes[i].x, sizes[i].y};
+            MoveResult move = collisionMap->moveAndSlide(rect, delta);
+            position = move.position;
+            if (move.hitX) velocity.x = -velocity.x;
+            if (move.hitY) velocity.y = -velocity.y;
+        } else {
+            position.x += delta.x;
+            position.y += delta.y;
+        }
+
+        // 更新转向
+        if (std::abs(velocity.x) > 0.1f) {
+            facingRight[i] = velocity.x > 0 ? 1 : 0;
+        }
+
+        // 更新动画计时器
+        CatAnimation& animation = animations[i];
+        animation.breathTimer += stepTime;
+        if (moving[i]) {
+            animation.walkTimer += stepTime * (speeds[i] / 20.0f);
+        } else {
+            animation.walkTimer = 0.0f;
+        }
+
+        // 限制在地图内
+        Cat(this, i).checkBoundaries(world.mapWidth, world.mapHeight);
+
+        maxMove = std::max(maxMove, std::max(std::abs(position.x - previousPositions[i].x),
+                                              std::abs(position.y - previousPositions[i].y)));
+    }
+
+    float& workerMove = workerMaxMoves[JobSystem::getCurrentWorker()];
+    workerMove = std::max(workerMove, maxMove);
+}
+
+float CatSystem::scheduleLod(Index index, float deltaTime, const CatWorldSnapshot& world) {
+    CatLod lod = CatLod::NEAR;
+    const Rectangle& view = world.viewRect;
+    if (view.width > 0.0f && view.height > 0.0f && states[index] == CatState::NORMAL) {
+        const Vector2 position = positions[index];
+        const Vector2 size = sizes[index];
+
+        // 猫的碰撞盒到视野矩形的距离（在视野内为 0）
+        float dx = std::max(std::max(view.x - (position.x + size.x), position.x - (view.x + view.width)), 0.0f);
+        float dy = std::max(std::max(view.y - (position.y + size.y), position.y - (view.y + view.height)), 0.0f);
+        float viewDistance = std::max(dx, dy);
+
+        bool nearCatnip = false;
+        if (world.hasCatnip) {
+            float cx = position.x - world.catnipPosition.x;
+            float cy = position.y - world.catnipPosition.y;
+            nearCatnip = cx * cx + cy * cy < LOD_NEAR_MARGIN * LOD_NEAR_MARGIN;
+        }
+
+        if (viewDistance > LOD_MID_MARGIN && !nearCatnip) lod = CatLod::FAR;
+        else if (viewDistance > LOD_NEAR_MARGIN && !nearCatnip) lod = CatLod::MID;
+    }
+    lods[index] = lod;
+
+    if (lod == CatLod::FAR) return 0.0f;
+    if (lod == CatLod::MID && (tick + indexSlots[index]) % LOD_MID_INTERVAL != 0) return 0.0f;
+
+    // 距上次更新的步数：刚从休眠醒来的猫先直接推算，再正常模拟这一步
+    uint32_t elapsedTicks = tick - lastUpdateTicks[index];
+    lastUpdateTicks[index] = tick;
+    if (elapsedTicks > LOD_MID_INTERVAL) {
+        wakeDormant(index, (elapsedTicks - 1) * deltaTime, world);
+        return deltaTime;
+    }
+    return elapsedTicks * deltaTime;
+}
+
+void CatSystem::wakeDormant(Index index, float elapsed, const CatWorldSnapshot& world) {
+    // 计时器按休眠时长推进（眨眼等纯动画的计时器不需要精确）
+    stateTimers[index] -= elapsed;
+    catnipEffectTimers[index] = std::max(catnipEffectTimers[index] - elapsed, 0.0f);
+    blackboards[index].fill(0.0f);
+
+    // 走到原本会换方向的时刻为止；之后是随机游走，期望位移接近 0，停在那里即可
+    float& directionTimer = aiChangeDirectionTimers[index];
+    float walkTime = std::min(elapsed, std::max(aiChangeDirectionIntervals[index] - directionTimer, 0.0f));
+    directionTimer += elapsed;
+
+    Vector2& position = positions[index];
+    Vector2& velocity = velocities[index];
+    if (moving[index] && walkTime > 0.0f) {
+        Vector2 delta = {velocity.x * walkTime, velocity.y * walkTime};
+        if (collisionMap) {
+            Rectangle rect = {position.x, position.y, sizes[index].x, sizes[index].y};
+            position = collisionMap->moveAndSlide(rect, delta).position;
+        } else {
+            position.x += delta.x;
+            position.y += delta.y;
+        }
+        Cat(this, index).checkBoundaries(world.mapWidth, world.mapHeight);
+    }
+
+    CatAnimation& animation = animations[index];
+    animation.breathTimer += elapsed;
+    animation.tailWagTimer += elapsed;
+
+    // 瞬移，不做插值
+    previousPositions[index] = position;
+}
+
+size_t CatSystem::countLod(CatLod lod) const {
+    size_t count = 0;
+    for (size_t i = 0; i < lods.size(); i++) {
+        if (!caught[i] && lods[i] == lod) count++;
+    }
+    return count;
+}
+
+void CatSystem::collectPaths() {
+    if (!navigation) return;
+
+    // 只有逃跑和沉迷中的猫会寻路，先看热数据里的状态，不必碰每只猫的路径
+    const Index count = static_cast<Index>(size());
+    for (Index i = 0; i < count; i++) {
+        if (states[i] != CatState::FLEEING && states[i] != CatState::CATNIPPED) continue;
+        CatPath& path = paths[i];
+        if (path.request == 0) continue;
+
+        PathStatus status = navigation->getStatus(path.request);
+        if (status == PathStatus::FOUND) {
+            navigation->takePath(path.request, path.waypoints);
+            path.index = 0;
+            path.request = 0;
+        } else if (status != PathStatus::PENDING) {
+            // 不可达：退回直线，等下次重新规划
+            path.waypoints.clear();
+            path.index = 0;
+            path.request = 0;
+        }
+        // 搜索中继续沿旧路径走
+    }
+}
+
+void CatSystem::flushPathRequests() {
+    if (!navigation) return;
+
+    // 本步没有更新的猫不会改动路径
+    const Index count = static_cast<Index>(size());
+    for (Index i = 0; i < count; i++) {
+        if (stepTimes[i] <= 0.0f) continue;
+        CatPath& path = paths[i];
+        if (path.cancelledRequest != 0) {
+            navigation->cancel(path.cancelledRequest);
+            path.cancelledRequest = 0;
+        }
+        if (path.requestQueued) {
+            path.request = navigation->requestPath(path.requestFrom, path.goal);
+            path.requestQueued = false;
+        }
+    }
+}
+
+void CatSystem::evaluateNearby(const CatWorldSnapshot& world) {
+    std::fill(proximityFlags.begin(), proximityFlags.end(), 0);
+
+    // 哈希按碰撞盒查询，内核按左上角判断，候选是真正在范围内的猫的超集；多留 1 像素防止舍入差异
+    nearbyCats.clear();
+    spatialHash.queryRadius(world.playerPosition, std::max(maxAlertRange, CatKernels::CURIOUS_RANGE) + 1.0f, nearbyCats);
+    if (world.hasCatnip) {
+        spatialHash.queryRadius(world.catnipPosition, maxAttractRange + 1.0f, nearbyCats);
+    }
+    if (nearbyCats.empty()) return;
+
+    std::sort(nearbyCats.begin(), nearbyCats.end());
+    nearbyCats.erase(std::unique(nearbyCats.begin(), nearbyCats.end()), nearbyCats.end());
+
+    const size_t nearbyCount = nearbyCats.size();
+    nearbyPositions.resize(nearbyCount);
+    nearbyAlertRanges.resize(nearbyCount);
+    nearbyAttractRanges.resize(nearbyCount);
+    nearbyFlags.resize(nearbyCount);
+    for (size_t k = 0; k < nearbyCount; k++) {
+        const Index i = nearbyCats[k];
+        nearbyPositions[k] = positions[i];
+        nearbyAlertRanges[k] = alertRanges[i];
+        nearbyAttractRanges[k] = attractRanges[i];
+    }
+
+    CatKernels::evaluateProximity(nearbyPositions.data(), nearbyAlertRanges.data(), nearbyAttractRanges.data(),
+                                  nearbyCount, world.playerPosition, world.catnipPosition, world.hasCatnip,
+                                  nearbyFlags.data());
+    for (size_t k = 0; k < nearbyCount; k++) {
+        proximityFlags[nearbyCats[k]] = nearbyFlags[k];
+    }
+}
+
+void CatSystem::detectCaptures(const CatWorldSnapshot& world) {
+    captureEvents.clear();
+
+    float margin = 1.0f;
+    for (float move : workerMaxMoves) margin = std::max(margin, move + 1.0f);
+    const Rectangle& player = world.playerRect;
+    Rectangle area = {player.x - margin, player.y - margin, player.width + margin * 2.0f, player.height + margin * 2.0f};
+
+    nearbyCats.clear();
+    spatialHash.queryRect(area, nearbyCats);
+    std::sort(nearbyCats.begin(), nearbyCats.end());
+
+    // 沉迷中的猫碰到玩家就能被抓，由调用方决定如何处理
+    for (Index i : nearbyCats) {
+        if (stepTimes[i] <= 0.0f || states[i] != CatState::CATNIPPED) continue;
+        if (CheckCollisionRecs({positions[i].x, positions[i].y, sizes[i].x, sizes[i].y}, player)) {
+            captureEvents.push_back({CatEventType::CAPTURE, i, CatState::CATNIPPED, 0.0f});
+        }
+    }
+}
+
+void CatSystem::emitEvent(const CatEvent& event) {
+    workerEvents[JobSystem::getCurrentWorker()].push_back(event);
+}
+
+void CatSystem::mergeEvents() {
+    events.clear();
+    for (const auto& buffer : workerEvents) {
+        events.insert(events.end(), buffer.begin(), buffer.end());
+    }
+    // 抓捕在移动之后检测，排在同一只猫的状态变化之后
+    events.insert(events.end(), captureEvents.begin(), captureEvents.end());
+
+    // 同一只猫的事件都来自同一个线程，按下标稳定排序后顺序与线程调度无关
+    std::stable_sort(events.begin(), events.end(), [](const CatEvent& a, const CatEvent& b) {
+        return a.cat < b.cat;
+    });
+
+    if (!verbose) return;
+    for (const CatEvent& event : events) {
+        if (event.type != CatEventType::STATE_CHANGED) continue;
+
+        Cat cat(this, event.cat);
+        if (event.state == CatState::CATNIPPED) {
+            std::cout << "猫咪被猫薄荷吸引: " << cat.getCatTypeName() << " " << names[event.cat] << " 沉迷时间: " << event.value << "秒" << std::endl;
+        } else if (event.state == CatState::FLEEING) {
+            std::cout << "猫咪逃跑: " << cat.getCatTypeName() << " " << names[event.cat] << std::endl;
+        } else if (event.state == CatState::NORMAL) {
+            std::cout << "猫咪恢复清醒: " << names[event.cat] << std::endl;
+        }
+    }
+}
+
+void CatSystem::rebuildSpatialHash() {
+    spatialHash.clear();
+    maxAlertRange = 0.0f;
+    maxAttractRange = 0.0f;
+    const Index count = static_cast<Index>(size());
+    for (Index i = 0; i < count; i++) {
+        if (caught[i]) continue;
+        spatialHash.insert(i, {positions[i].x, positions[i].y, sizes[i].x, sizes[i].y});
+        maxAlertRange = std::max(maxAlertRange, alertRanges[i]);
+        maxAttractRange = std::max(maxAttractRange, attractRanges[i]);
+    }
+    spatialHash.build();
+    spatialDirty = false;
+}
+
+void CatSystem::queryRect(const Rectangle& area, std::vector<Index>& out) {
+    if (spatialDirty) rebuildSpatialHash();
+    spatialHash.queryRect(area, out);
+}
+
+void CatSystem::queryRadius(Vector2 center, float radius, std::vector<Index>& out) {
+    if (spatialDirty) rebuildSpatialHash();
+    spatialHash.queryRadius(center, radius, out);
+}
+
+void CatSystem::draw(float alpha) {
+    for (Cat cat : *this) {
+        cat.draw(alpha);
+    }
+}
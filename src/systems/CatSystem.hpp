@@ -0,0 +1,330 @@
+#ifndef CATSYSTEM_HPP
+#define CATSYSTEM_HPP
+
+#include "../entities/Cat.hpp"
+#include "../entities/CatSpecies.hpp"
+#include "../core/StatusIndicator.hpp"
+#include "../core/Random.hpp"
+#include "SpatialHash.hpp"
+#include "BehaviorTree.hpp"
+#include <raylib.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <array>
+#include <cstdint>
+
+class MapLoader;
+class NavigationSystem;
+class JobSystem;
+
+// 外观：只在生成、绘制和图鉴中使用
+struct CatAppearance {
+    Color color = WHITE;
+    float legLength = 10.0f;     // 腿长
+    float bodyFatness = 1.0f;    // 胖瘦程度 (1.0 为标准)
+    bool isFluffy = false;       // 是否蓬松
+    float earAngle = 0.0f;       // 耳朵角度 (0为立耳, 1.5为飞机耳)
+    float eyeSize = 1.0f;        // 眼睛大小缩放
+    float whiskerLength = 1.0f;  // 胡须长度
+    float tailStyle = 0.0f;      // 尾巴风格 (长度或摆动频率)
+    bool isShiny = false;        // 是否是闪光猫
+    Color shinyEffectColor = WHITE;
+    Texture2D sprite = {0};
+    std::string texturePath;
+};
+
+// 动画计时器：只影响绘制
+struct CatAnimation {
+    float breathTimer = 0.0f;    // 呼吸动画计时器
+    float walkTimer = 0.0f;      // 走路动画计时器
+    float blinkTimer = 0.0f;     // 眨眼计时器
+    float blinkDuration = 0.15f; // 眨眼持续时间
+    bool isBlinking = false;     // 是否正在眨眼
+    float tailWagTimer = 0.0f;   // 尾巴摆动计时器
+};
+
+// 寻路状态：当前请求、正在跟随的拐点和对应的目标
+struct CatPath {
+    uint32_t request = 0;
+    std::vector<Vector2> waypoints;
+    size_t index = 0;
+    Vector2 goal = {0.0f, 0.0f};
+    float repathTimer = 0.0f;
+
+    // 并行更新中不访问寻路服务：新请求和要取消的请求先记在这里，更新结束后统一提交
+    bool requestQueued = false;
+    Vector2 requestFrom = {0.0f, 0.0f};
+    uint32_t cancelledRequest = 0;
+};
+
+// 每个模拟步开始时的玩家和猫薄荷状态，并行更新期间只读
+// viewRect 为屏幕看到的世界范围，用于 AI 细节分级；宽或高为 0 时不分级，所有猫每步更新
+struct CatWorldSnapshot {
+    Vector2 playerPosition = {0.0f, 0.0f};
+    Rectangle playerRect = {0.0f, 0.0f, 0.0f, 0.0f};
+    Rectangle viewRect = {0.0f, 0.0f, 0.0f, 0.0f};
+    Vector2 catnipPosition = {0.0f, 0.0f};
+    bool hasCatnip = false;
+    int capturedCount = 0;
+    int mapWidth = 0;
+    int mapHeight = 0;
+};
+
+// AI 细节等级：按与视野的距离决定更新频率
+enum class CatLod : uint8_t {
+    NEAR,       // 视野内或附近，每步更新
+    MID,        // 稍远，每 LOD_MID_INTERVAL 步更新一次，按槽位错开
+    FAR         // 更远，休眠；醒来时按休眠时长直接推算位置和计时器
+};
+
+enum class CatEventType {
+    STATE_CHANGED,  // 被猫薄荷吸引、开始逃跑或恢复清醒，value 为持续时间
+    CAPTURE         // 沉迷中的猫碰到了玩家
+};
+
+// 更新中产生的事件：各线程先写自己的缓冲区，更新结束后按猫的下标合并
+struct CatEvent {
+    CatEventType type;
+    uint32_t cat;
+    CatState state;
+    float value;
+};
+
+// 猫咪系统：所有猫的数据按字段分成连续数组（SoA）
+// 每帧模拟读写的热数据（位置、速度、状态、计时器）与名字、外观、动画、寻路等冷数据分开存放，
+// 批量更新时只扫过用到的数组；删除时与末尾交换，O(1) 且不移动其他猫
+// Cat 是 (系统, 下标) 形式的轻量句柄，任何删除操作之后旧句柄失效
+// 容量固定：构造时按容量预留所有数组，另有一张槽位表把 CatHandle 映射到当前下标，
+// 删除时槽位回收、代数加一；状态指示器和品种纹理也会复用，稳定运行时生成和删除都不分配堆内存
+class CatSystem {
+public:
+    using Index = uint32_t;
+
+    // 猫咪碰撞尺寸
+    static constexpr float CAT_WIDTH = 40.0f;
+    static constexpr float CAT_HEIGHT = 30.0f;
+
+    // 默认容量
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    // AI 细节分级：视野外扩 LOD_NEAR_MARGIN 内为 NEAR，LOD_MID_MARGIN 内为 MID，再远为 FAR
+    // 猫薄荷附近的猫、逃跑或沉迷中的猫总是 NEAR
+    static constexpr float LOD_NEAR_MARGIN = 256.0f;
+    static constexpr float LOD_MID_MARGIN = 1024.0f;
+    static constexpr uint32_t LOD_MID_INTERVAL = 4;
+
+    // 按下标遍历的句柄迭代器，支持 for (Cat cat : system)
+    class Iterator {
+    public:
+        Iterator(CatSystem* system, Index index) : system(system), index(index) {}
+        Cat operator*() const { return Cat(system, index); }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    private:
+        CatSystem* system;
+        Index index;
+    };
+
+    explicit CatSystem(size_t capacity = DEFAULT_CAPACITY);
+    ~CatSystem();
+
+    // 持有寻路请求和状态指示器，禁止拷贝
+    CatSystem(const CatSystem&) = delete;
+    CatSystem& operator=(const CatSystem&) = delete;
+
+    // 生成一只猫，随机外观、性格和稀有度；池已满时返回空引用
+    // 不输出日志：猫被抓后随时会补生成，纹理加载只在每个品种第一次用到时提示
+    // 名字不复制，需在猫存活期间一直有效（字符串字面量或静态名字表）
+    CatHandle spawn(const char* name, Vector2 position, CatType type);
+
+    // 删除一只猫（与末尾交换后弹出），会取消它的寻路请求
+    void remove(Index index);
+
+    // 按持久引用删除，引用已失效时什么也不做
+    void release(CatHandle handle);
+
+    // 删除所有已抓获的猫，返回删除数量
+    size_t removeCaught();
+
+    void clear();
+
+    size_t size() const { return positions.size(); }
+    bool empty() const { return positions.empty(); }
+    size_t capacity() const { return slotIndices.size(); }
+    bool full() const { return freeSlots.empty(); }
+    size_t countActive() const;
+
+    Cat get(Index index) { return Cat(this, index); }
+
+    // 持久引用：isAlive 为 true 时才能用 get 取得句柄
+    bool isAlive(CatHandle handle) const;
+    Cat get(CatHandle handle) { return Cat(this, slotIndices[handle.slot]); }
+    CatHandle getHandle(Index index) const { return {indexSlots[index], slotGenerations[indexSlots[index]]}; }
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end() { return Iterator(this, static_cast<Index>(size())); }
+
+    // 碰撞地图（可为空），撞墙时反弹
+    void setCollisionMap(const MapLoader* map) { collisionMap = map; }
+
+    // 寻路服务（可为空），追猫薄荷和逃跑时绕开障碍；会作废所有猫的当前路径
+    void setNavigation(NavigationSystem* nav);
+
+    // 任务线程池（可为空），有则把猫按块分到多个线程并行更新
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+
+    // 行为树（可为空，为空时用内置默认行为），生命周期需长于 CatSystem；会清空所有猫的黑板
+    void setBehavior(const BehaviorTree* tree);
+
+    // 是否加载品种纹理；无图形模拟没有图形上下文，需在生成猫咪之前关闭，猫咪改用程序化绘制
+    void setTextureLoading(bool enabled) { textureLoading = enabled; }
+
+    // 是否逐条输出状态变化日志（被吸引、逃跑、恢复清醒）；猫多时每步可能有很多条，默认关闭
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // 与范围相交的未抓获猫咪下标，追加到 out；空间哈希在 update 中建好，猫移动后下次查询时重建
+    void queryRect(const Rectangle& area, std::vector<Index>& out);
+    void queryRadius(Vector2 center, float radius, std::vector<Index>& out);
+
+    // 每个模拟步更新所有猫：先按块并行决定细节等级，再把所有未抓获的猫插入空间哈希，
+    // 只对玩家和猫薄荷附近查询到的猫用 SIMD 内核判断距离；随后按块并行推进计时器，
+    // 逐只运行行为树切换状态并给出方向和速度，批量算出速度并移动，
+    // 最后在玩家附近查询沉迷中碰到玩家的猫
+    // 每只猫只由一个线程处理且只写自己的数据，寻路请求和事件在更新结束后按下标顺序处理，
+    // 结果与线程数无关
+    void update(float deltaTime, const CatWorldSnapshot& world);
+
+    // 最近一次 update 产生的事件（按猫的下标排序），下标在下一次生成或删除猫之前有效
+    const std::vector<CatEvent>& getEvents() const { return events; }
+
+    // 最近一次 update 各细节等级的猫数（调试显示用）
+    size_t countLod(CatLod lod) const;
+
+    // alpha 为上一个模拟步到当前模拟步之间的插值系数
+    void draw(float alpha = 1.0f);
+
+private:
+    friend class Cat;
+
+    // 把所有未抓获的猫按碰撞盒插入空间哈希，同时记下最大的逃跑和吸引范围
+    void rebuildSpatialHash();
+
+    // 在玩家和猫薄荷附近查询候选猫，对候选猫运行距离判定内核，其余猫的标志为 0（主线程）
+    void evaluateNearby(const CatWorldSnapshot& world);
+
+    // 在玩家碰撞盒外扩本步最大位移的范围内查询，检查沉迷中碰到玩家的猫（主线程）
+    void detectCaptures(const CatWorldSnapshot& world);
+
+    // 品种纹理，每个品种只查找一次，结果留在 typeSprites
+    void loadTypeSprite(CatType type);
+
+    // 决定 [begin, end) 内的猫本步是否更新（休眠的猫醒来时会瞬移），可在任意线程执行
+    void scheduleRange(Index begin, Index end, float deltaTime, const CatWorldSnapshot& world);
+
+    // 更新 [begin, end) 内的猫，可在任意线程执行
+    void updateRange(Index begin, Index end, const CatWorldSnapshot& world);
+
+    // 按细节等级决定本步是否更新这只猫，返回要模拟的时长（0 表示跳过）
+    float scheduleLod(Index index, float deltaTime, const CatWorldSnapshot& world);
+
+    // 休眠的猫醒来：不逐步模拟，直接按休眠时长推进计时器，并沿当前方向走到原本会换方向的时刻
+    void wakeDormant(Index index, float elapsed, const CatWorldSnapshot& world);
+
+    // 更新前取回已完成的寻路结果，更新后提交记下的请求和取消（都在调用线程按下标顺序执行）
+    void collectPaths();
+    void flushPathRequests();
+
+    // 写入当前线程的事件缓冲区
+    void emitEvent(const CatEvent& event);
+
+    // 合并各线程的事件，verbose 时输出日志
+    void mergeEvents();
+
+    // 所有猫共享的地图、寻路服务、线程池和行为树
+    const MapLoader* collisionMap;
+    NavigationSystem* navigation;
+    JobSystem* jobs;
+    const BehaviorTree* behavior;
+    bool deferNavigation;           // 并行更新期间为 true
+    bool textureLoading;
+    bool verbose;
+
+    // 热数据：每帧模拟读写
+    std::vector<Vector2> positions;
+    std::vector<Vector2> previousPositions;     // 上一个模拟步的位置，渲染插值用
+    std::vector<Vector2> velocities;
+    std::vector<Vector2> sizes;
+    std::vector<float> speeds;
+    std::vector<CatState> states;
+    std::vector<uint8_t> caught;
+    std::vector<uint8_t> moving;
+    std::vector<uint8_t> facingRight;
+    std::vector<float> stateTimers;
+    std::vector<float> catnipEffectTimers;
+    std::vector<float> aiChangeDirectionTimers;
+    std::vector<float> aiChangeDirectionIntervals;
+    std::vector<CatBlackboard> blackboards;     // 行为树的黑板槽位
+    std::vector<int> smartMovePatterns;
+    std::vector<Vector2> catnipPositions;
+    std::vector<CatType> types;
+    std::vector<CatPersonality> personalities;
+    std::vector<float> baseEffectTimes;
+    std::vector<Pcg32> rngs;         // 每只猫独立的随机流，派生自 RandomStream::CATS
+    std::vector<CatLod> lods;
+    std::vector<uint32_t> lastUpdateTicks;      // 上一次实际更新时的 tick
+
+    // 按品种和性格预先算好的范围和速度，品种、性格或速度变化时由 Cat::updateTraitLanes 刷新
+    std::vector<float> alertRanges;
+    std::vector<float> attractRanges;
+    std::vector<float> fleeSpeeds;
+    std::vector<float> catnipSpeeds;
+
+    // 每帧的临时数组：距离判定结果，以及逃跑和猫薄荷 AI 给出的方向和速度
+    std::vector<uint8_t> proximityFlags;
+    std::vector<Vector2> steerDirections;
+    std::vector<float> steerSpeeds;          // 为 0 表示本帧不经过批量转向
+    std::vector<float> steerSideSpeeds;
+    std::vector<float> stepTimes;               // 本步每只猫要模拟的时长，0 表示跳过
+
+    // 槽位表：槽位 -> 下标和代数，下标 -> 槽位；空闲槽位按栈复用
+    std::vector<Index> slotIndices;
+    std::vector<uint32_t> slotGenerations;
+    std::vector<uint32_t> indexSlots;
+    std::vector<uint32_t> freeSlots;
+
+    // 删除的猫留下的状态指示器，生成时优先复用
+    std::vector<std::unique_ptr<StatusIndicator>> spareIndicators;
+
+    // 按品种缓存的纹理
+    std::array<bool, CatSpecies::MAX_COUNT> typeSpriteLoaded;
+    std::array<Texture2D, CatSpecies::MAX_COUNT> typeSprites;
+
+    // 每个线程一个事件缓冲区，主线程检测到的抓捕事件，以及合并后的结果
+    std::vector<std::vector<CatEvent>> workerEvents;
+    std::vector<CatEvent> captureEvents;
+    std::vector<CatEvent> events;
+
+    // 冷数据：绘制、图鉴和寻路
+    std::vector<const char*> names;             // 指向静态名字，不持有
+    std::vector<CatAppearance> appearances;
+    std::vector<CatAnimation> animations;
+    std::vector<std::unique_ptr<StatusIndicator>> statusIndicators;
+    std::vector<CatPath> paths;
+
+    // 模拟步计数，细节分级错开更新用
+    uint32_t tick;
+
+    // 邻近查询：每步在细节分级之后重建一次；生成、删除或移动猫之后标记重建
+    SpatialHash spatialHash;
+    bool spatialDirty;
+    float maxAlertRange;                        // 哈希中所有猫的最大逃跑范围
+    float maxAttractRange;
+    std::vector<Index> nearbyCats;              // 查询结果
+    std::vector<Vector2> nearbyPositions;       // 候选猫的位置和范围，连续存放后交给内核
+    std::vector<float> nearbyAlertRanges;
+    std::vector<float> nearbyAttractRanges;
+    std::vector<uint8_t> nearbyFlags;
+    std::vector<float> workerMaxMoves;          // 每个线程本步移动最远的猫的位移（x、y 中较大者）
+};
+
+#endif // CATSYSTEM_HPP
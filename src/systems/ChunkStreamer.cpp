@@ -0,0 +1,78 @@
+#include "ChunkStreamer.hpp"
+#include <string_view>
+
+ChunkStreamer::ChunkStreamer() : stopping(false) {
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    stop();
+}
+
+void ChunkStreamer::submit(const Request& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        requests.push_back(request);
+    }
+    
+    if (!worker.joinable()) {
+        worker = std::thread(&ChunkStreamer::workerLoop, this);
+    }
+    condition.notify_one();
+}
+
+void ChunkStreamer::collect(std::vector<Result>& results) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& result : finished) {
+        results.push_back(std::move(result));
+    }
+    finished.clear();
+}
+
+void ChunkStreamer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        requests.clear();
+    }
+    condition.notify_all();
+    
+    if (worker.joinable()) {
+        worker.join();
+    }
+    finished.clear();
+}
+
+void ChunkStreamer::workerLoop() {
+    std::vector<unsigned char> scratch;
+    
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            request = requests.front();
+            requests.pop_front();
+        }
+        
+        // 解码不持锁
+        Result result;
+        result.layerIndex = request.layerIndex;
+        result.chunkIndex = request.chunkIndex;
+        result.gids.assign(request.tileCount, 0);
+        
+        std::string_view text(request.data, request.length);
+        if (request.encoding == TileEncoding::CSV) {
+            result.ok = TileDataDecoder::decodeCsv(text, result.gids.data(), result.gids.size()) == result.gids.size();
+        } else if (request.encoding == TileEncoding::BASE64) {
+            result.ok = TileDataDecoder::decodeLayerData(text, request.compression, result.gids.data(),
+                                                         result.gids.size(), scratch);
+        } else {
+            result.ok = false;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(result));
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef CHUNKSTREAMER_HPP
+#define CHUNKSTREAMER_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include "TileDataDecoder.hpp"
+
+// 无限地图区块的后台解码线程
+// 主线程提交请求、每帧取回结果；工作线程只读请求中的源数据，不访问 MapLoader
+class ChunkStreamer {
+public:
+    // 解码请求：data 指向映射中的编码文本，需在请求完成前保持有效
+    struct Request {
+        int layerIndex;
+        int chunkIndex;
+        const char* data;
+        size_t length;
+        TileEncoding encoding;
+        TileCompression compression;
+        size_t tileCount;
+    };
+    
+    // 解码结果
+    struct Result {
+        int layerIndex;
+        int chunkIndex;
+        std::vector<uint32_t> gids;
+        bool ok;
+    };
+    
+    ChunkStreamer();
+    ~ChunkStreamer();
+    
+    // 持有线程，禁止拷贝
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+    
+    // 提交解码请求（第一次提交时启动线程）
+    void submit(const Request& request);
+    
+    // 取回所有已完成的结果，追加到 results
+    void collect(std::vector<Result>& results);
+    
+    // 丢弃尚未开始的请求，等待正在解码的请求完成，之后不会再产生结果
+    void stop();
+    
+private:
+    void workerLoop();
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Request> requests;
+    std::vector<Result> finished;
+    bool stopping;
+};
+
+#endif // CHUNKSTREAMER_HPP
@@ -0,0 +1,120 @@
+#include "FileWatcher.hpp"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define FILEWATCHER_USE_INOTIFY 1
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher() : inotifyFd(-1) {
+#ifdef FILEWATCHER_USE_INOTIFY
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cerr << "inotify 初始化失败，改为轮询文件修改时间" << std::endl;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef FILEWATCHER_USE_INOTIFY
+    // 关闭描述符时内核自动移除所有监视
+    if (inotifyFd >= 0) close(inotifyFd);
+#endif
+}
+
+bool FileWatcher::addFile(const std::string& filePath) {
+    namespace fs = std::filesystem;
+    for (const auto& file : files) {
+        if (file.path == filePath) return true;
+    }
+
+    std::error_code ec;
+    fs::path path(filePath);
+    WatchedFile file;
+    file.path = filePath;
+    file.directory = path.has_parent_path() ? path.parent_path().string() : std::string(".");
+    file.name = path.filename().string();
+    file.watchId = -1;
+    file.lastWrite = fs::last_write_time(path, ec);
+    if (ec) {
+        std::cerr << "无法监视文件: " << filePath << std::endl;
+        return false;
+    }
+
+#ifdef FILEWATCHER_USE_INOTIFY
+    // 监视目录而不是文件本身：保存时文件被替换，文件上的监视会随旧 inode 失效
+    if (inotifyFd >= 0) {
+        file.watchId = inotify_add_watch(inotifyFd, file.directory.c_str(),
+                                         IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (file.watchId < 0) {
+            std::cerr << "inotify 无法监视目录: " << file.directory << "，改为轮询" << std::endl;
+        }
+    }
+#endif
+
+    files.push_back(std::move(file));
+    return true;
+}
+
+void FileWatcher::clear() {
+#ifdef FILEWATCHER_USE_INOTIFY
+    if (inotifyFd >= 0) {
+        std::vector<int> removed;
+        for (const auto& file : files) {
+            if (file.watchId < 0 || std::find(removed.begin(), removed.end(), file.watchId) != removed.end()) continue;
+            inotify_rm_watch(inotifyFd, file.watchId);
+            removed.push_back(file.watchId);
+        }
+
+        // 丢弃已经排队的事件
+        alignas(inotify_event) char buffer[4096];
+        while (read(inotifyFd, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+#endif
+    files.clear();
+}
+
+bool FileWatcher::poll(std::vector<std::string>& changed) {
+    size_t before = changed.size();
+    auto report = [&changed, before](const std::string& path) {
+        if (std::find(changed.begin() + before, changed.end(), path) == changed.end()) {
+            changed.push_back(path);
+        }
+    };
+
+#ifdef FILEWATCHER_USE_INOTIFY
+    if (inotifyFd >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) break;  // EAGAIN：没有更多事件
+
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+
+                for (const auto& file : files) {
+                    if (file.watchId == event->wd && file.name == event->name) report(file.path);
+                }
+            }
+        }
+    }
+#endif
+
+    // 没有 inotify 的文件按修改时间判断
+    for (auto& file : files) {
+        if (file.watchId >= 0) continue;
+
+        std::error_code ec;
+        std::filesystem::file_time_type lastWrite = std::filesystem::last_write_time(file.path, ec);
+        if (ec || lastWrite == file.lastWrite) continue;
+        file.lastWrite = lastWrite;
+        report(file.path);
+    }
+
+    return changed.size() > before;
+}
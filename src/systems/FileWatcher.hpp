@@ -0,0 +1,44 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// 监视一组文件的修改（用于地图热重载）
+// Linux 上用 inotify 监视文件所在目录（Tiled 保存时先写临时文件再改名），
+// 其他平台退回按修改时间轮询
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    // 持有 inotify 描述符，禁止拷贝
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // 添加要监视的文件，重复添加会被忽略
+    bool addFile(const std::string& filePath);
+
+    // 停止监视所有文件
+    void clear();
+
+    // 非阻塞：取出自上次调用以来被修改过的文件（追加到 changed，同一文件只出现一次）
+    bool poll(std::vector<std::string>& changed);
+
+    bool empty() const { return files.empty(); }
+
+private:
+    struct WatchedFile {
+        std::string path;                          // 调用方传入的路径，原样返回
+        std::string directory;
+        std::string name;
+        int watchId;                               // inotify 目录监视号，-1 表示轮询
+        std::filesystem::file_time_type lastWrite;
+    };
+
+    int inotifyFd;
+    std::vector<WatchedFile> files;
+};
+
+#endif // FILEWATCHER_HPP
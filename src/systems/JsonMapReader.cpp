@@ -0,0 +1,414 @@
+#include "JsonMapReader.hpp"
+#include "TileDataDecoder.hpp"
+#include <rapidjson/reader.h>
+#include <rapidjson/error/en.h>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// 解析中的图层：base64 数据和尺寸可能分散在各个键中，等整个文档读完再解码
+struct PendingLayer {
+    Layer layer;
+    std::string type;
+    std::string compression;
+    std::string_view encodedData;     // 指向原地解析后的缓冲区
+    bool hasEncodedData = false;
+    float offsetX = 0.0f;             // 对象层偏移，在图层结束时加到对象上
+    float offsetY = 0.0f;
+    size_t firstObject = 0;           // 本图层对象在输出数组中的起点
+};
+
+// 只关心 Tiled 地图中用到的几层结构，其余子树整体忽略
+class MapHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, MapHandler> {
+public:
+    MapHandler(JsonMapReader::MapInfo& map, std::vector<JsonMapReader::TilesetInfo>& tilesets,
+               std::vector<MapObject>& objects)
+        : map(map), tilesets(tilesets), objects(objects) {}
+
+    std::vector<PendingLayer> layers;
+
+    bool StartObject() {
+        Scope parent = scopes.empty() ? Scope::NONE : scopes.back();
+        switch (parent) {
+            case Scope::NONE:
+                scopes.push_back(Scope::ROOT);
+                break;
+            case Scope::LAYERS:
+                layers.emplace_back();
+                layers.back().firstObject = objects.size();
+                scopes.push_back(Scope::LAYER);
+                break;
+            case Scope::OBJECTS:
+                objects.emplace_back();
+                objectIsPoint = false;
+                hasShape = false;
+                scopes.push_back(Scope::OBJECT);
+                break;
+            case Scope::SHAPE:
+                scopes.push_back(Scope::SHAPE_POINT);
+                break;
+            case Scope::TILESETS:
+                tilesets.emplace_back();
+                scopes.push_back(Scope::TILESET);
+                break;
+            case Scope::TILES:
+                tileId = -1;
+                tileCollides = false;
+                tileFrames.clear();
+                scopes.push_back(Scope::TILE);
+                break;
+            case Scope::ANIMATION:
+                frameTileId = -1;
+                frameDuration = 0;
+                scopes.push_back(Scope::FRAME);
+                break;
+            case Scope::PROPERTIES:
+                propertyIsCollides = false;
+                propertyValue = false;
+                scopes.push_back(Scope::PROPERTY);
+                break;
+            default:
+                scopes.push_back(Scope::IGNORED);
+                break;
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        Scope scope = scopes.back();
+        scopes.pop_back();
+
+        if (scope == Scope::PROPERTY) {
+            if (propertyIsCollides && propertyValue) tileCollides = true;
+        } else if (scope == Scope::TILE) {
+            if (tileCollides && tileId >= 0) tilesets.back().collidableIds.push_back(tileId);
+            if (!tileFrames.empty() && tileId >= 0) {
+                tilesets.back().animations.push_back({tileId, std::move(tileFrames)});
+                tileFrames.clear();
+            }
+        } else if (scope == Scope::FRAME) {
+            if (frameTileId >= 0) {
+                tileFrames.push_back({static_cast<uint32_t>(frameTileId), static_cast<uint32_t>(std::max(frameDuration, 0))});
+            }
+        } else if (scope == Scope::OBJECT) {
+            finishObject();
+        } else if (scope == Scope::LAYER) {
+            // offsetx/offsety 排在 objects 之后，这里统一加上
+            PendingLayer& pending = layers.back();
+            for (size_t i = pending.firstObject; i < objects.size(); ++i) {
+                objects[i].bounds.x += pending.offsetX;
+                objects[i].bounds.y += pending.offsetY;
+            }
+        } else if (scope == Scope::SHAPE_POINT) {
+            // 多边形顶点相对于对象位置，先累计包围盒
+            if (!hasShape) {
+                shapeMinX = shapeMaxX = pointX;
+                shapeMinY = shapeMaxY = pointY;
+                hasShape = true;
+            } else {
+                shapeMinX = std::min(shapeMinX, pointX);
+                shapeMaxX = std::max(shapeMaxX, pointX);
+                shapeMinY = std::min(shapeMinY, pointY);
+                shapeMaxY = std::max(shapeMaxY, pointY);
+            }
+        }
+        return true;
+    }
+
+    bool StartArray() {
+        Scope parent = scopes.empty() ? Scope::NONE : scopes.back();
+        Scope scope = Scope::IGNORED;
+
+        if (parent == Scope::ROOT && key == "layers") {
+            scope = Scope::LAYERS;
+        } else if (parent == Scope::ROOT && key == "tilesets") {
+            scope = Scope::TILESETS;
+        } else if (parent == Scope::LAYER && key == "data") {
+            scope = Scope::LAYER_DATA;
+            // 尺寸已知时一次分配到位
+            Layer& layer = layers.back().layer;
+            if (layer.width > 0 && layer.height > 0) {
+                layer.gids.reserve(static_cast<size_t>(layer.width) * layer.height);
+            }
+        } else if (parent == Scope::LAYER && key == "objects") {
+            scope = Scope::OBJECTS;
+        } else if (parent == Scope::OBJECT && (key == "polygon" || key == "polyline")) {
+            scope = Scope::SHAPE;
+        } else if (parent == Scope::TILESET && key == "tiles") {
+            scope = Scope::TILES;
+        } else if (parent == Scope::TILE && key == "properties") {
+            scope = Scope::PROPERTIES;
+        } else if (parent == Scope::TILE && key == "animation") {
+            scope = Scope::ANIMATION;
+        }
+
+        scopes.push_back(scope);
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        scopes.pop_back();
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        key = std::string_view(str, length);
+        return true;
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        std::string_view value(str, length);
+        switch (currentScope()) {
+            case Scope::ROOT:
+                if (key == "orientation") map.orientation = std::string(value);
+                else if (key == "renderorder") map.renderOrder = std::string(value);
+                break;
+            case Scope::LAYER: {
+                PendingLayer& pending = layers.back();
+                if (key == "name") pending.layer.name = std::string(value);
+                else if (key == "type") pending.type = std::string(value);
+                else if (key == "compression") pending.compression = std::string(value);
+                else if (key == "data") {
+                    // encoding 为 base64 时 data 是字符串
+                    pending.encodedData = value;
+                    pending.hasEncodedData = true;
+                }
+                break;
+            }
+            case Scope::LAYER_DATA:
+                // 兼容把 gid 写成字符串的导出文件（原地解析的字符串以 '\0' 结尾）
+                layers.back().layer.gids.push_back(static_cast<uint32_t>(std::strtoul(str, nullptr, 10)));
+                break;
+            case Scope::TILESET: {
+                JsonMapReader::TilesetInfo& tileset = tilesets.back();
+                if (key == "name") tileset.name = std::string(value);
+                else if (key == "image") tileset.image = std::string(value);
+                else if (key == "source") tileset.source = std::string(value);
+                break;
+            }
+            case Scope::PROPERTY:
+                if (key == "name") propertyIsCollides = (value == "collides");
+                break;
+            case Scope::OBJECT:
+                // Tiled 1.9 起对象的 type 改名为 class
+                if (key == "name") objects.back().name = std::string(value);
+                else if (key == "type" || key == "class") objects.back().type = std::string(value);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool Bool(bool value) {
+        switch (currentScope()) {
+            case Scope::LAYER:
+                if (key == "visible") layers.back().layer.visible = value;
+                break;
+            case Scope::PROPERTY:
+                if (key == "value") propertyValue = value;
+                break;
+            case Scope::OBJECT:
+                if (key == "point") objectIsPoint = value;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    // 带翻转标志位的 gid 超出 int 范围，数字统一按 64 位处理
+    bool Int(int value) { return integer(value); }
+    bool Uint(unsigned value) { return integer(value); }
+    bool Int64(int64_t value) { return integer(value); }
+    bool Uint64(uint64_t value) { return integer(static_cast<int64_t>(value)); }
+
+    bool Double(double value) {
+        Scope scope = currentScope();
+        if (scope == Scope::LAYER || scope == Scope::OBJECT || scope == Scope::SHAPE_POINT) {
+            number(static_cast<float>(value));
+            return true;
+        }
+        return integer(static_cast<int64_t>(value));
+    }
+
+private:
+    enum class Scope {
+        NONE,
+        ROOT,          // 根对象
+        LAYERS,        // layers 数组
+        LAYER,         // 单个图层
+        LAYER_DATA,    // 图层的 gid 数组
+        TILESETS,      // tilesets 数组
+        TILESET,       // 单个图块集
+        TILES,         // 图块集的 tiles 数组
+        TILE,          // 单个图块
+        PROPERTIES,    // 图块的 properties 数组
+        PROPERTY,      // 单个属性
+        ANIMATION,     // 图块的 animation 数组
+        FRAME,         // 单个动画帧
+        OBJECTS,       // 对象层的 objects 数组
+        OBJECT,        // 单个对象
+        SHAPE,         // 对象的 polygon/polyline 数组
+        SHAPE_POINT,   // 多边形顶点
+        IGNORED        // 不关心的子树
+    };
+
+    Scope currentScope() const { return scopes.empty() ? Scope::NONE : scopes.back(); }
+
+    // 对象坐标、图层偏移等浮点字段
+    void number(float value) {
+        switch (currentScope()) {
+            case Scope::LAYER: {
+                PendingLayer& pending = layers.back();
+                if (key == "opacity") pending.layer.opacity = value;
+                else if (key == "offsetx") pending.offsetX = value;
+                else if (key == "offsety") pending.offsetY = value;
+                break;
+            }
+            case Scope::OBJECT: {
+                Rectangle& bounds = objects.back().bounds;
+                if (key == "x") bounds.x = value;
+                else if (key == "y") bounds.y = value;
+                else if (key == "width") bounds.width = value;
+                else if (key == "height") bounds.height = value;
+                break;
+            }
+            case Scope::SHAPE_POINT:
+                if (key == "x") pointX = value;
+                else if (key == "y") pointY = value;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 对象的键读完后确定包围盒和用途
+    void finishObject() {
+        MapObject& object = objects.back();
+        if (objectIsPoint) {
+            object.bounds.width = 0.0f;
+            object.bounds.height = 0.0f;
+        } else if (hasShape) {
+            object.bounds = {object.bounds.x + shapeMinX, object.bounds.y + shapeMinY,
+                             shapeMaxX - shapeMinX, shapeMaxY - shapeMinY};
+        }
+        object.kind = MapObject::kindFromType(object.type, object.isPoint());
+    }
+
+    bool integer(int64_t value) {
+        int intValue = static_cast<int>(value);
+        switch (currentScope()) {
+            case Scope::ROOT:
+                if (key == "width") map.width = intValue;
+                else if (key == "height") map.height = intValue;
+                else if (key == "tilewidth") map.tileWidth = intValue;
+                else if (key == "tileheight") map.tileHeight = intValue;
+                break;
+            case Scope::LAYER: {
+                Layer& layer = layers.back().layer;
+                if (key == "width") layer.width = intValue;
+                else if (key == "height") layer.height = intValue;
+                else number(static_cast<float>(value));
+                break;
+            }
+            case Scope::OBJECT:
+            case Scope::SHAPE_POINT:
+                number(static_cast<float>(value));
+                break;
+            case Scope::LAYER_DATA:
+                // 翻转标志位原样保留
+                layers.back().layer.gids.push_back(static_cast<uint32_t>(value));
+                break;
+            case Scope::TILESET:
+                if (key == "firstgid") tilesets.back().firstGid = intValue;
+                break;
+            case Scope::TILE:
+                if (key == "id") tileId = intValue;
+                break;
+            case Scope::FRAME:
+                if (key == "tileid") frameTileId = intValue;
+                else if (key == "duration") frameDuration = intValue;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    JsonMapReader::MapInfo& map;
+    std::vector<JsonMapReader::TilesetInfo>& tilesets;
+    std::vector<MapObject>& objects;
+
+    std::vector<Scope> scopes;
+    std::string_view key;             // 当前对象中最近的键
+
+    // 图块属性按对象结束时汇总（键的顺序不固定）
+    int tileId = -1;
+    bool tileCollides = false;
+    bool propertyIsCollides = false;
+    bool propertyValue = false;
+
+    // 图块动画帧（本地 id）
+    std::vector<TileAnimationFrame> tileFrames;
+    int frameTileId = -1;
+    int frameDuration = 0;
+
+    // 对象的 point 标志和多边形包围盒（相对于对象位置）
+    bool objectIsPoint = false;
+    bool hasShape = false;
+    float shapeMinX = 0.0f, shapeMinY = 0.0f, shapeMaxX = 0.0f, shapeMaxY = 0.0f;
+    float pointX = 0.0f, pointY = 0.0f;
+};
+
+} // namespace
+
+bool JsonMapReader::parse(char* buffer, MapInfo& map, std::vector<TilesetInfo>& tilesets,
+                          std::vector<Layer>& layers, std::vector<MapObject>& objects) {
+    error.clear();
+
+    MapHandler handler(map, tilesets, objects);
+    rapidjson::Reader reader;
+    rapidjson::InsituStringStream stream(buffer);
+
+    rapidjson::ParseResult result = reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+    if (!result) {
+        error = std::string(rapidjson::GetParseError_En(result.Code())) + " (偏移 " + std::to_string(result.Offset()) + ")";
+        return false;
+    }
+
+    // Tiled 按字母序输出键，地图尺寸可能在 layers 之后，所以图层在这里统一收尾
+    std::vector<unsigned char> decodeScratch;
+    for (auto& pending : handler.layers) {
+        // 对象层、图像层、组图层不含图块数据
+        if (!pending.type.empty() && pending.type != "tilelayer") continue;
+
+        Layer& layer = pending.layer;
+        if (layer.width <= 0) layer.width = map.width;
+        if (layer.height <= 0) layer.height = map.height;
+        size_t tileCount = static_cast<size_t>(std::max(layer.width, 0)) * std::max(layer.height, 0);
+
+        if (pending.hasEncodedData) {
+            layer.gids.assign(tileCount, 0);
+
+            TileCompression compression;
+            if (!TileDataDecoder::parseCompression(pending.compression, compression) ||
+                !TileDataDecoder::isSupported(compression)) {
+                std::cerr << "暂不支持的图层压缩方式: " << pending.compression << " 图层: " << layer.name << std::endl;
+            } else if (!TileDataDecoder::decodeLayerData(pending.encodedData, compression,
+                                                         layer.gids.data(), layer.gids.size(), decodeScratch)) {
+                std::cerr << "图层数据解码失败: " << layer.name << std::endl;
+                std::fill(layer.gids.begin(), layer.gids.end(), 0u);
+            }
+        } else {
+            // 数组数据已在解析时写入，多余的截断、不足的补 0
+            layer.gids.resize(tileCount, 0);
+        }
+
+        layers.push_back(std::move(layer));
+    }
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef JSONMAPREADER_HPP
+#define JSONMAPREADER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MapLoader.hpp"
+
+// Tiled JSON 地图的 SAX 读取器
+// 在可写缓冲区上原地解析（rapidjson ParseInsitu），不构建 DOM：
+// 数组形式的 gid 直接写入 Layer::gids，base64 数据在解析结束后直接解码到 Layer::gids
+// 对象层只读出对象的名称、类型和包围盒
+class JsonMapReader {
+public:
+    // 地图基本属性
+    struct MapInfo {
+        int width = 0;
+        int height = 0;
+        int tileWidth = 0;
+        int tileHeight = 0;
+        std::string orientation = "orthogonal";
+        std::string renderOrder = "right-down";
+    };
+
+    // 图块动画，帧的 gid 为图块集内的本地 id
+    struct AnimationInfo {
+        int tileId = -1;
+        std::vector<TileAnimationFrame> frames;
+    };
+    
+    // 图块集描述（纹理由 MapLoader 负责加载）
+    struct TilesetInfo {
+        int firstGid = 0;
+        std::string name = "tileset";
+        std::string image;                // 内嵌图块集的图片
+        std::string source;               // 外部图块集文件
+        std::vector<int> collidableIds;   // collides = true 的本地图块 id
+        std::vector<AnimationInfo> animations;
+    };
+
+    // buffer 必须以 '\0' 结尾，解析过程中会被改写
+    // layers 追加新解析的图块图层，objects 追加对象层中的对象
+    bool parse(char* buffer, MapInfo& map, std::vector<TilesetInfo>& tilesets,
+               std::vector<Layer>& layers, std::vector<MapObject>& objects);
+
+    // 错误信息
+    const std::string& getError() const { return error; }
+
+private:
+    std::string error;
+};
+
+#endif // JSONMAPREADER_HPP
@@ -0,0 +1,102 @@
+#ifndef MAPBINARYFORMAT_HPP
+#define MAPBINARYFORMAT_HPP
+
+#include <cstdint>
+
+// 预编译二进制地图格式（.mbin），由 meowmon_mapbake 从 .tmx/.json 生成
+// 所有字段为小端序，各段按 8 字节对齐，加载时 mmap 后直接使用
+//
+// 文件布局：
+//   MapBinaryHeader
+//   MapBinaryTileset[tilesetCount]
+//   MapBinaryLayer[layerCount]
+//   int32_t collidableGids[collidableGidCount]
+//   uint64_t collisionBits[(width * height + 63) / 64]
+//   MapBinaryObject[objectCount]
+//   MapBinaryAnimation[animationCount]
+//   MapBinaryAnimationFrame[animationFrameCount]
+//   每个图层的 uint32_t gid[width * height]（由 MapBinaryLayer::gidOffset 指向）
+//   字符串段（不以 '\0' 结尾）
+
+constexpr char MAP_BINARY_MAGIC[4] = {'M', 'M', 'A', 'P'};
+constexpr uint32_t MAP_BINARY_VERSION = 2;
+
+// 字符串引用，offset 相对于字符串段起点
+struct MapBinaryString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct MapBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width;                 // 地图宽度（图块数）
+    int32_t height;                // 地图高度（图块数）
+    int32_t tileWidth;
+    int32_t tileHeight;
+    MapBinaryString orientation;
+    MapBinaryString renderOrder;
+    uint32_t tilesetCount;
+    uint32_t layerCount;
+    uint32_t collidableGidCount;
+    uint32_t objectCount;
+    uint32_t animationCount;
+    uint32_t animationFrameCount;
+    uint64_t tilesetOffset;        // 以下偏移均相对于文件起点
+    uint64_t layerOffset;
+    uint64_t collidableGidOffset;
+    uint64_t collisionOffset;
+    uint64_t objectOffset;
+    uint64_t animationOffset;
+    uint64_t animationFrameOffset;
+    uint64_t stringOffset;
+    uint64_t stringSize;
+};
+
+struct MapBinaryTileset {
+    int32_t firstGid;
+    uint32_t reserved;
+    MapBinaryString name;
+    MapBinaryString image;         // 相对于 .mbin 文件所在目录
+};
+
+struct MapBinaryLayer {
+    MapBinaryString name;
+    int32_t width;
+    int32_t height;
+    uint32_t visible;
+    float opacity;
+    uint64_t gidOffset;            // 保留翻转标志位的原始 gid
+};
+
+// 对象表（出生点、触发器等）
+struct MapBinaryObject {
+    MapBinaryString name;
+    MapBinaryString type;
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+// 图块动画表，帧按动画顺序连续存放在帧表中
+struct MapBinaryAnimation {
+    uint32_t gid;
+    uint32_t tileset;              // 所属图块集下标
+    uint32_t firstFrame;
+    uint32_t frameCount;
+};
+
+struct MapBinaryAnimationFrame {
+    uint32_t gid;
+    uint32_t duration;             // 毫秒
+};
+
+static_assert(sizeof(MapBinaryHeader) == 136, "MapBinaryHeader 布局变化需要提升 MAP_BINARY_VERSION");
+static_assert(sizeof(MapBinaryTileset) == 24, "MapBinaryTileset 布局变化需要提升 MAP_BINARY_VERSION");
+static_assert(sizeof(MapBinaryLayer) == 32, "MapBinaryLayer 布局变化需要提升 MAP_BINARY_VERSION");
+static_assert(sizeof(MapBinaryObject) == 32, "MapBinaryObject 布局变化需要提升 MAP_BINARY_VERSION");
+static_assert(sizeof(MapBinaryAnimation) == 16, "MapBinaryAnimation 布局变化需要提升 MAP_BINARY_VERSION");
+static_assert(sizeof(MapBinaryAnimationFrame) == 8, "MapBinaryAnimationFrame 布局变化需要提升 MAP_BINARY_VERSION");
+
+#endif // MAPBINARYFORMAT_HPP
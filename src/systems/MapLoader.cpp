@@ -1,526 +1,2054 @@
 #include "MapLoader.hpp"
+#include "XmlReader.hpp"
+#include "JsonMapReader.hpp"
+#include "TileDataDecoder.hpp"
+#include "MapBinaryFormat.hpp"
 #include "core/ResourceManager.hpp"
+#include "core/Random.hpp"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <chrono>
+
+// Tiled 翻转标志组合对应的绘制方式，下标为 gid >> 29（H<<2 | V<<1 | D）
+// 先对源矩形做水平翻转，再绕图块中心顺时针旋转
+struct TileOrientation {
+    float rotation;
+    bool flipX;
+};
+
+static const TileOrientation TILE_ORIENTATIONS[8] = {
+    {0.0f, false},    // 无翻转
+    {270.0f, true},   // D
+    {180.0f, true},   // V
+    {270.0f, false},  // V + D
+    {0.0f, true},     // H
+    {90.0f, false},   // H + D
+    {180.0f, false},  // H + V
+    {90.0f, true}     // H + V + D
+};
+
+// 读取整个文件到字符串，TSX/JSON 只读一次，之后在内存中单遍解析
+static bool readWholeFile(const std::string& filePath, std::string& content) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return false;
+    
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size < 0) return false;
+    
+    content.resize(static_cast<size_t>(size));
+    file.read(&content[0], size);
+    return static_cast<bool>(file) || file.eof();
+}
 
 MapLoader::MapLoader() 
     : width(0), height(0), tileWidth(0), tileHeight(0),
-      orientation("orthogonal"), renderOrder("right-down") {
+      orientation("orthogonal"), renderOrder("right-down"), textureLoading(true),
+      loadState(MapLoadState::IDLE), loadProgress(0.0f), uploadedImages(0),
+      infinite(false), originTileX(0), originTileY(0),
+      streamingBudget(8 * 1024 * 1024), residentChunkBytes(0), streamFrame(0),
+      hotReloadEnabled(false), reloadDone(false), reloadRunning(false), reloadQueued(false),
+      reloadParsed(false), reloadCollisionChanged(false), reloadX0(0), reloadY0(0), reloadX1(-1), reloadY1(-1) {
+}
+
+MapLoader::~MapLoader() {
+    if (loadThread.joinable()) {
+        loadThread.join();
+    }
+    if (reloadThread.joinable()) {
+        reloadThread.join();
+    }
+    // 解码线程读取的是映射中的数据，必须先于映射关闭停止
+    chunkStreamer.stop();
+    for (auto& image : pendingImages) {
+        if (image.data) UnloadImage(image);
+    }
+    
+    for (auto& layer : layers) {
+        releaseChunks(layer);
+    }
 }
 
 bool MapLoader::loadMap(const std::string& filePath) {
+    for (auto& layer : layers) {
+        releaseChunks(layer);
+    }
+    if (!parseMapFile(filePath)) return false;
+    
+    // 以下步骤需要图形上下文，只能在主线程执行
+    buildTileLookup();
+    resolveAnimations();
+    buildChunks();
+    collectAnimatedChunks();
+    return true;
+}
+
+bool MapLoader::startAsyncLoad(const std::vector<std::string>& candidatePaths) {
+    MapLoadState state = loadState.load();
+    if (state == MapLoadState::LOADING || state == MapLoadState::UPLOADING) return false;
+    if (loadThread.joinable()) loadThread.join();
+    
+    // 工作线程只记录图片路径，纹理由主线程在 updateAsyncLoad 中上传
+    textureLoading = false;
+    uploadedImages = 0;
+    loadProgress = 0.0f;
+    loadState = MapLoadState::LOADING;
+    loadThread = std::thread(&MapLoader::asyncLoadWorker, this, candidatePaths);
+    return true;
+}
+
+void MapLoader::asyncLoadWorker(std::vector<std::string> candidatePaths) {
+    bool parsed = false;
+    for (const auto& path : candidatePaths) {
+        std::cout << "尝试加载地图文件: " << path << std::endl;
+        if (parseMapFile(path)) {
+            parsed = true;
+            break;
+        }
+    }
+    
+    if (!parsed) {
+        loadProgress = 1.0f;
+        loadState = MapLoadState::FAILED;
+        return;
+    }
+    loadProgress = 0.5f;
+    
+    // 图片解码（stb_image）只用 CPU，放在工作线程
+    pendingImages.assign(tilesetImagePaths.size(), Image{});
+    for (size_t i = 0; i < tilesetImagePaths.size(); ++i) {
+        pendingImages[i] = ResourceManager::getInstance().loadImage(tilesetImagePaths[i]);
+        loadProgress = 0.5f + 0.4f * static_cast<float>(i + 1) / tilesetImagePaths.size();
+    }
+    
+    loadProgress = 0.9f;
+    loadState = MapLoadState::UPLOADING;
+}
+
+MapLoadState MapLoader::updateAsyncLoad(int maxUploads) {
+    MapLoadState state = loadState.load();
+    if (state != MapLoadState::UPLOADING && state != MapLoadState::FAILED) return state;
+    
+    // 工作线程已经写完全部数据
+    if (loadThread.joinable()) loadThread.join();
+    
+    if (state == MapLoadState::FAILED) {
+        textureLoading = true;
+        return state;
+    }
+    
+    // 每帧只上传少量纹理，避免单帧卡顿
+    for (int uploads = 0; uploads < maxUploads && uploadedImages < pendingImages.size(); ++uploads, ++uploadedImages) {
+        Image& image = pendingImages[uploadedImages];
+        if (!image.data) {
+            std::cerr << "无法加载图块集图片: " << tilesetImagePaths[uploadedImages] << std::endl;
+            continue;
+        }
+        
+        tilesetTextures[uploadedImages] = ResourceManager::getInstance().loadTextureFromImage(
+            tilesetImagePaths[uploadedImages], image);
+        UnloadImage(image);
+        image = Image{};
+    }
+    
+    if (!pendingImages.empty()) {
+        loadProgress = 0.9f + 0.1f * static_cast<float>(uploadedImages) / pendingImages.size();
+    }
+    if (uploadedImages < pendingImages.size()) return MapLoadState::UPLOADING;
+    
+    pendingImages.clear();
+    textureLoading = true;
+    buildTileLookup();
+    resolveAnimations();
+    buildChunks();
+    collectAnimatedChunks();
+    
+    std::cout << "地图异步加载完成: " << loadedPath << std::endl;
+    loadProgress = 1.0f;
+    loadState = MapLoadState::READY;
+    return MapLoadState::READY;
+}
+
+float MapLoader::getLoadProgress() const {
+    return loadProgress.load();
+}
+
+const std::string& MapLoader::getLoadedPath() const {
+    return loadedPath;
+}
+
+bool MapLoader::parseMapFile(const std::string& filePath) {
+    // 异步加载会依次尝试多个候选路径，失败的候选可能已经登记了图块集和图层
+    resetMapData();
+    
     // 检查文件扩展名来决定使用哪种格式
     std::string extension = filePath.substr(filePath.find_last_of(".") + 1);
     
-    if (extension == "tmx" || extension == "TMX") {
-        return loadTMX(filePath);
+    if (extension == "mbin" || extension == "MBIN") {
+        // 碰撞位图已预先算好
+        if (!loadBinary(filePath)) return false;
+    } else if (extension == "tmx" || extension == "TMX") {
+        if (!loadTMX(filePath)) return false;
+        buildCollisionGrid();
     } else if (extension == "json" || extension == "JSON") {
-        // 使用现有的JSON解析
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
-            std::cerr << "无法打开地图文件: " << filePath << std::endl;
+        if (!loadJSON(filePath)) return false;
+        buildCollisionGrid();
+    } else {
+        std::cerr << "不支持的地图格式: " << extension << std::endl;
+        return false;
+    }
+    
+    objectIndex.build(objects);
+    if (!objects.empty()) {
+        std::cout << "地图对象: " << objects.size() << " 个" << std::endl;
+    }
+    loadedPath = filePath;
+    return true;
+}
+
+void MapLoader::resetMapData() {
+    width = 0;
+    height = 0;
+    tileWidth = 0;
+    tileHeight = 0;
+    orientation = "orthogonal";
+    renderOrder = "right-down";
+    infinite = false;
+    originTileX = 0;
+    originTileY = 0;
+    
+    layers.clear();
+    tilesetTextures.clear();
+    tilesetFirstGids.clear();
+    tilesetNames.clear();
+    tilesetImagePaths.clear();
+    tilesetSourcePaths.clear();
+    tileLookup.clear();
+    
+    animations.clear();
+    animationFrames.clear();
+    animationFrameInfo.clear();
+    gidAnimation.clear();
+    tilesetClocks.clear();
+    
+    collidableGids.clear();
+    gidCollides.clear();
+    collisionBits.clear();
+    
+    objects.clear();
+    objectIndex.clear();
+    loadedPath.clear();
+}
+
+bool MapLoader::loadJSON(const std::string& filePath) {
+    // 整个文件读入可写缓冲区，SAX 原地解析，不构建 DOM
+    std::string content;
+    if (!readWholeFile(filePath, content)) {
+        std::cerr << "无法打开地图文件: " << filePath << std::endl;
+        return false;
+    }
+    
+    JsonMapReader reader;
+    JsonMapReader::MapInfo info;
+    std::vector<JsonMapReader::TilesetInfo> tilesets;
+    if (!reader.parse(content.data(), info, tilesets, layers, objects)) {
+        std::cerr << "地图文件解析错误: " << reader.getError() << std::endl;
+        layers.clear();
+        objects.clear();
+        return false;
+    }
+    
+    // 解析地图基本属性
+    width = info.width;
+    height = info.height;
+    tileWidth = info.tileWidth;
+    tileHeight = info.tileHeight;
+    orientation = info.orientation;
+    renderOrder = info.renderOrder;
+    
+    std::cout << "地图尺寸: " << width << "x" << height << " 图块大小: " << tileWidth << "x" << tileHeight << std::endl;
+    
+    // 注册图块集
+    for (const auto& tileset : tilesets) {
+        // collides = true 的图块参与碰撞
+        for (int id : tileset.collidableIds) {
+            collidableGids.push_back(tileset.firstGid + id);
+        }
+        
+        // 内嵌图块集的图片
+        if (!tileset.image.empty()) {
+            if (!registerTileset(tileset.firstGid, tileset.name, tileset.image, false)) {
+                std::cerr << "解析图块集失败!" << std::endl;
+                layers.clear();
+                return false;
+            }
+            
+            // 动画帧读出来是本地 id，换成全局 gid
+            int tilesetIndex = static_cast<int>(tilesetFirstGids.size()) - 1;
+            for (const auto& animation : tileset.animations) {
+                std::vector<TileAnimationFrame> frames = animation.frames;
+                for (auto& frame : frames) frame.gid += static_cast<uint32_t>(tileset.firstGid);
+                addTileAnimation(tilesetIndex, static_cast<uint32_t>(tileset.firstGid + animation.tileId),
+                                 frames.data(), frames.size());
+            }
+        }
+        // 如果是引用外部tileset文件（Tiled格式）
+        else if (!tileset.source.empty()) {
+            // 构建完整的tileset图片路径
+            std::string directoryPath = filePath.substr(0, filePath.find_last_of("/\\"));
+            std::string imagePath;
+            
+            // 处理source路径中的../引用
+            if (tileset.source.find("../") == 0) {
+                std::string parentDir = directoryPath.substr(0, directoryPath.find_last_of("/\\"));
+                imagePath = parentDir + "/" + tileset.source.substr(3);
+            } else {
+                imagePath = directoryPath + "/" + tileset.source;
+            }
+            
+            // 尝试加载tileset图片，失败时使用占位纹理
+            registerTileset(tileset.firstGid, tileset.name, imagePath, true);
+        }
+    }
+    
+    std::cout << "成功加载地图: " << filePath << std::endl;
+    return true;
+}
+
+// 拼接相对路径并规范化其中的 "../" 与 "./"
+static std::string resolveRelativePath(const std::string& directory, const std::string& relative) {
+    return (std::filesystem::path(directory) / relative).lexically_normal().generic_string();
+}
+
+static std::string directoryOf(const std::string& filePath) {
+    size_t slash = filePath.find_last_of("/\\");
+    return (slash == std::string::npos) ? std::string() : filePath.substr(0, slash);
+}
+
+// TMX格式解析器 - 流式单遍解析
+bool MapLoader::loadTMX(const std::string& filePath) {
+    // 无限地图的区块在游戏过程中才解码，源文件需要一直保持映射
+    if (!mappedFile.open(filePath)) {
+        std::cerr << "无法打开TMX文件: " << filePath << std::endl;
+        return false;
+    }
+    
+    std::string directory = directoryOf(filePath);
+    XmlReader reader(reinterpret_cast<const char*>(mappedFile.data()), mappedFile.size());
+    std::vector<unsigned char> decodeScratch;
+    
+    // 定位根元素 <map>
+    XmlReader::Token token;
+    while ((token = reader.next()) != XmlReader::Token::START_ELEMENT) {
+        if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) {
+            std::cerr << "TMX文件格式错误: 缺少map元素 " << reader.getError() << std::endl;
+            mappedFile.close();
             return false;
         }
+    }
+    if (reader.name() != "map") {
+        std::cerr << "TMX文件格式错误: 根元素不是map" << std::endl;
+        mappedFile.close();
+        return false;
+    }
+    
+    width = reader.intAttribute("width");
+    height = reader.intAttribute("height");
+    tileWidth = reader.intAttribute("tilewidth");
+    tileHeight = reader.intAttribute("tileheight");
+    orientation = reader.attribute("orientation", "orthogonal");
+    renderOrder = reader.attribute("renderorder", "right-down");
+    infinite = reader.boolAttribute("infinite", false);
+    
+    if (width <= 0 || height <= 0 || tileWidth <= 0 || tileHeight <= 0) {
+        std::cerr << "TMX文件格式错误: 地图尺寸无效" << std::endl;
+        mappedFile.close();
+        return false;
+    }
+    std::cout << "TMX地图尺寸: " << width << "x" << height << " 图块大小: " << tileWidth << "x" << tileHeight << std::endl;
+    
+    // 逐个处理 <map> 的子元素
+    while ((token = reader.next()) != XmlReader::Token::END_OF_DOCUMENT) {
+        if (token == XmlReader::Token::ERROR) {
+            std::cerr << "TMX解析错误: " << reader.getError() << std::endl;
+            layers.clear();
+            mappedFile.close();
+            return false;
+        }
+        if (token == XmlReader::Token::END_ELEMENT) break; // </map>
+        if (token != XmlReader::Token::START_ELEMENT) continue;
         
-        rapidjson::IStreamWrapper isw(file);
-        rapidjson::Document doc;
-        doc.ParseStream(isw);
+        if (reader.name() == "tileset") {
+            int firstGid = reader.intAttribute("firstgid", 1);
+            
+            if (reader.hasAttribute("source")) {
+                // 外部 TSX 文件
+                std::string tsxPath = resolveRelativePath(directory, reader.attribute("source"));
+                reader.skipElement();
+                if (!loadTSX(tsxPath, firstGid)) {
+                    std::cerr << "无法加载外部 TSX 文件: " << tsxPath << std::endl;
+                }
+            } else {
+                parseTilesetElement(reader, firstGid, directory, "embedded_tileset");
+            }
+        } else if (reader.name() == "layer") {
+            parseLayerElement(reader, decodeScratch);
+        } else if (reader.name() == "objectgroup") {
+            parseObjectGroup(reader);
+        } else {
+            // imagelayer、properties 等暂不处理
+            reader.skipElement();
+        }
+    }
+    
+    if (infinite) {
+        finalizeStreamedLayers();
+        std::cout << "无限地图范围: " << width << "x" << height << " 原点偏移: (" << originTileX << ", " << originTileY << ")" << std::endl;
+    } else {
+        mappedFile.close();
+    }
+    
+    std::cout << "成功加载TMX地图: " << filePath << std::endl;
+    return true;
+}
+
+bool MapLoader::loadTSX(const std::string& filePath, int firstGid) {
+    std::string content;
+    if (!readWholeFile(filePath, content)) {
+        std::cerr << "无法打开TSX文件: " << filePath << std::endl;
+        return false;
+    }
+    tilesetSourcePaths.push_back(filePath);
+    
+    XmlReader reader(content);
+    XmlReader::Token token;
+    while ((token = reader.next()) != XmlReader::Token::END_OF_DOCUMENT) {
+        if (token == XmlReader::Token::ERROR) break;
+        if (token == XmlReader::Token::START_ELEMENT && reader.name() == "tileset") {
+            return parseTilesetElement(reader, firstGid, directoryOf(filePath), "tileset");
+        }
+    }
+    
+    std::cerr << "TSX文件格式错误: 缺少tileset元素 " << reader.getError() << std::endl;
+    return false;
+}
+
+bool MapLoader::parseTilesetElement(XmlReader& reader, int firstGid, const std::string& directory,
+                                    const std::string& defaultName) {
+    std::string tilesetName = reader.attribute("name", defaultName);
+    std::string imageSource;
+    
+    // 图块动画等图块集登记成功后再加入
+    std::vector<std::pair<uint32_t, std::vector<TileAnimationFrame>>> tileAnimations;
+    std::vector<TileAnimationFrame> currentFrames;
+    
+    // 读到 </tileset> 为止
+    int depth = 1;
+    int currentTileId = -1;
+    while (depth > 0) {
+        XmlReader::Token token = reader.next();
+        if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
         
-        if (doc.HasParseError()) {
-            std::cerr << "地图文件解析错误: " << doc.GetParseError() << std::endl;
-            return false;
+        if (token == XmlReader::Token::END_ELEMENT) {
+            if (reader.name() == "tile") {
+                if (currentTileId >= 0 && !currentFrames.empty()) {
+                    tileAnimations.emplace_back(static_cast<uint32_t>(firstGid + currentTileId), std::move(currentFrames));
+                }
+                currentFrames.clear();
+                currentTileId = -1;
+            }
+            depth--;
+            continue;
         }
+        if (token != XmlReader::Token::START_ELEMENT) continue;
+        depth++;
         
-        // 解析地图基本属性
-        if (doc.HasMember("width")) width = doc["width"].GetInt();
-        if (doc.HasMember("height")) height = doc["height"].GetInt();
-        if (doc.HasMember("tilewidth")) tileWidth = doc["tilewidth"].GetInt();
-        if (doc.HasMember("tileheight")) tileHeight = doc["tileheight"].GetInt();
-        if (doc.HasMember("orientation")) orientation = doc["orientation"].GetString();
-        if (doc.HasMember("renderorder")) renderOrder = doc["renderorder"].GetString();
+        std::string_view element = reader.name();
+        if (element == "image") {
+            // 只取图块集自身的图片，忽略图片集合型图块集中单个图块的图片
+            if (currentTileId < 0 && imageSource.empty()) {
+                imageSource = reader.attribute("source");
+            }
+        } else if (element == "tile") {
+            currentTileId = reader.intAttribute("id", -1);
+        } else if (element == "property") {
+            // <tile> 下的 collides 属性
+            if (currentTileId >= 0 && reader.rawAttribute("name") == "collides" &&
+                reader.boolAttribute("value")) {
+                collidableGids.push_back(firstGid + currentTileId);
+            }
+        } else if (element == "frame") {
+            // <tile><animation><frame tileid duration/></animation></tile>
+            int frameTileId = reader.intAttribute("tileid", -1);
+            int duration = reader.intAttribute("duration", 0);
+            if (currentTileId >= 0 && frameTileId >= 0) {
+                currentFrames.push_back({static_cast<uint32_t>(firstGid + frameTileId),
+                                         static_cast<uint32_t>(std::max(duration, 0))});
+            }
+        } else if (element != "properties" && element != "animation") {
+            // 地形、碰撞形状等暂不处理
+            reader.skipElement();
+            depth--;
+        }
+    }
+    
+    if (imageSource.empty()) {
+        std::cerr << "图块集格式错误: 缺少image元素 " << tilesetName << std::endl;
+        return false;
+    }
+    
+    std::string imagePath = resolveRelativePath(directory, imageSource);
+    if (!registerTileset(firstGid, tilesetName, imagePath, false)) return false;
+    
+    int tilesetIndex = static_cast<int>(tilesetFirstGids.size()) - 1;
+    for (const auto& animation : tileAnimations) {
+        addTileAnimation(tilesetIndex, animation.first, animation.second.data(), animation.second.size());
+    }
+    
+    std::cout << "加载图块集: " << tilesetName << " 图片: " << imagePath << std::endl;
+    return true;
+}
+
+bool MapLoader::parseLayerElement(XmlReader& reader, std::vector<unsigned char>& decodeScratch) {
+    Layer layer;
+    layer.name = reader.attribute("name");
+    layer.width = reader.intAttribute("width", width);
+    layer.height = reader.intAttribute("height", height);
+    layer.visible = reader.boolAttribute("visible", true);
+    layer.opacity = reader.floatAttribute("opacity", 1.0f);
+    
+    if (layer.width <= 0) layer.width = width;
+    if (layer.height <= 0) layer.height = height;
+    if (infinite) {
+        layer.streamed = true;
+    } else {
+        layer.gids.assign(static_cast<size_t>(layer.width) * layer.height, 0);
+    }
+    
+    // 读到 </layer> 为止
+    int depth = 1;
+    while (depth > 0) {
+        XmlReader::Token token = reader.next();
+        if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
         
-        std::cout << "地图尺寸: " << width << "x" << height << " 图块大小: " << tileWidth << "x" << tileHeight << std::endl;
+        if (token == XmlReader::Token::END_ELEMENT) {
+            depth--;
+            continue;
+        }
+        if (token != XmlReader::Token::START_ELEMENT) continue;
         
-        // 解析图块集
-        if (doc.HasMember("tilesets")) {
-            if (!parseTilesets(doc["tilesets"], filePath)) {
-                std::cerr << "解析图块集失败!" << std::endl;
-                return false;
+        if (reader.name() != "data") {
+            reader.skipElement();
+            continue;
+        }
+        
+        if (layer.streamed) {
+            parseStreamChunks(reader, layer);
+            continue;
+        }
+        
+        std::string encoding = reader.attribute("encoding");
+        size_t index = 0;
+        
+        if (encoding == "csv") {
+            // CSV 直接从输入缓冲区解析到 gids，翻转标志位原样保留在高 4 位
+            while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+                if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
+                if (token == XmlReader::Token::START_ELEMENT) {
+                    reader.skipElement();
+                    continue;
+                }
+                
+                index += TileDataDecoder::decodeCsv(reader.text(), layer.gids.data() + index, layer.gids.size() - index);
+            }
+        } else if (encoding.empty()) {
+            // 未编码格式：每个图块一个 <tile gid="..."/>
+            while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+                if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
+                if (token != XmlReader::Token::START_ELEMENT) continue;
+                
+                if (reader.name() == "tile" && index < layer.gids.size()) {
+                    layer.gids[index++] = reader.uintAttribute("gid");
+                }
+                reader.skipElement();
+            }
+        } else if (encoding == "base64") {
+            // base64（可选 zlib/gzip/zstd 压缩）直接解码到 gids
+            TileCompression compression;
+            std::string compressionName = reader.attribute("compression");
+            if (!TileDataDecoder::parseCompression(compressionName, compression) ||
+                !TileDataDecoder::isSupported(compression)) {
+                std::cerr << "暂不支持的图层压缩方式: " << compressionName << " 图层: " << layer.name << std::endl;
+                reader.skipElement();
+                continue;
+            }
+            
+            std::string_view payload;
+            while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+                if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
+                if (token == XmlReader::Token::TEXT) payload = reader.text();
+                else if (token == XmlReader::Token::START_ELEMENT) reader.skipElement();
+            }
+            
+            if (!TileDataDecoder::decodeLayerData(payload, compression, layer.gids.data(), layer.gids.size(), decodeScratch)) {
+                std::cerr << "图层数据解码失败: " << layer.name << std::endl;
+                std::fill(layer.gids.begin(), layer.gids.end(), 0u);
             }
+        } else {
+            std::cerr << "暂不支持的图层数据编码: " << encoding << " 图层: " << layer.name << std::endl;
+            reader.skipElement();
         }
+    }
+    
+    layers.push_back(std::move(layer));
+    return true;
+}
+
+// 多边形/折线的 points 属性（"x,y x,y ..."，相对于对象位置），求包围盒
+static Rectangle pointsBounds(std::string_view points) {
+    std::string text(points);
+    const char* p = text.c_str();
+    bool any = false;
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+    
+    while (*p) {
+        char* next = nullptr;
+        float x = std::strtof(p, &next);
+        if (next == p || *next != ',') break;
+        p = next + 1;
+        float y = std::strtof(p, &next);
+        if (next == p) break;
+        p = next;
+        while (*p == ' ') ++p;
         
-        // 解析图层
-        if (doc.HasMember("layers")) {
-            if (!parseLayers(doc["layers"])) {
-                std::cerr << "解析图层失败!" << std::endl;
-                return false;
+        if (!any) {
+            minX = maxX = x;
+            minY = maxY = y;
+            any = true;
+        } else {
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+    
+    return Rectangle{minX, minY, maxX - minX, maxY - minY};
+}
+
+void MapLoader::parseObjectGroup(XmlReader& reader) {
+    float offsetX = reader.floatAttribute("offsetx");
+    float offsetY = reader.floatAttribute("offsety");
+    
+    XmlReader::Token token;
+    while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+        if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) return;
+        if (token != XmlReader::Token::START_ELEMENT) continue;
+        
+        if (reader.name() != "object") {
+            reader.skipElement();
+            continue;
+        }
+        
+        MapObject object;
+        object.name = XmlReader::decodeEntities(reader.rawAttribute("name"));
+        // Tiled 1.9 起对象的 type 改名为 class
+        object.type = XmlReader::decodeEntities(reader.hasAttribute("type") ? reader.rawAttribute("type") : reader.rawAttribute("class"));
+        object.bounds = {reader.floatAttribute("x") + offsetX, reader.floatAttribute("y") + offsetY,
+                         reader.floatAttribute("width"), reader.floatAttribute("height")};
+        
+        // 子元素：<point/>、<ellipse/>、<polygon points=.../>、<polyline points=.../>、<properties> 等
+        while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+            if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) return;
+            if (token != XmlReader::Token::START_ELEMENT) continue;
+            
+            if (reader.name() == "polygon" || reader.name() == "polyline") {
+                Rectangle shape = pointsBounds(reader.rawAttribute("points"));
+                object.bounds = {object.bounds.x + shape.x, object.bounds.y + shape.y, shape.width, shape.height};
+            } else if (reader.name() == "point") {
+                object.bounds.width = 0.0f;
+                object.bounds.height = 0.0f;
             }
+            reader.skipElement();
         }
         
-        std::cout << "成功加载地图: " << filePath << std::endl;
-        return true;
+        object.kind = MapObject::kindFromType(object.type, object.isPoint());
+        objects.push_back(std::move(object));
+    }
+}
+
+void MapLoader::parseStreamChunks(XmlReader& reader, Layer& layer) {
+    std::string encoding = reader.attribute("encoding");
+    std::string compressionName = reader.attribute("compression");
+    
+    if (encoding == "csv") {
+        layer.streamEncoding = TileEncoding::CSV;
+    } else if (encoding == "base64") {
+        layer.streamEncoding = TileEncoding::BASE64;
     } else {
-        std::cerr << "不支持的地图格式: " << extension << std::endl;
+        std::cerr << "无限地图不支持的图层数据编码: " << (encoding.empty() ? "xml" : encoding) << " 图层: " << layer.name << std::endl;
+        reader.skipElement();
+        return;
+    }
+    
+    if (!TileDataDecoder::parseCompression(compressionName, layer.streamCompression) ||
+        !TileDataDecoder::isSupported(layer.streamCompression)) {
+        std::cerr << "暂不支持的图层压缩方式: " << compressionName << " 图层: " << layer.name << std::endl;
+        reader.skipElement();
+        return;
+    }
+    
+    // 只记录每个 <chunk> 的位置和编码文本的范围，真正的解码交给 ChunkStreamer
+    const char* base = reinterpret_cast<const char*>(mappedFile.data());
+    XmlReader::Token token;
+    while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+        if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
+        if (token != XmlReader::Token::START_ELEMENT) continue;
+        
+        if (reader.name() != "chunk") {
+            reader.skipElement();
+            continue;
+        }
+        
+        StreamChunk chunk;
+        chunk.x = reader.intAttribute("x");
+        chunk.y = reader.intAttribute("y");
+        chunk.width = reader.intAttribute("width");
+        chunk.height = reader.intAttribute("height");
+        
+        const char* textBegin = nullptr;
+        const char* textEnd = nullptr;
+        while ((token = reader.next()) != XmlReader::Token::END_ELEMENT) {
+            if (token == XmlReader::Token::END_OF_DOCUMENT || token == XmlReader::Token::ERROR) break;
+            if (token == XmlReader::Token::START_ELEMENT) {
+                reader.skipElement();
+            } else if (token == XmlReader::Token::TEXT) {
+                if (!textBegin) textBegin = reader.text().data();
+                textEnd = reader.text().data() + reader.text().size();
+            }
+        }
+        
+        if (chunk.width <= 0 || chunk.height <= 0 || !textBegin) continue;
+        chunk.dataOffset = static_cast<size_t>(textBegin - base);
+        chunk.dataLength = static_cast<size_t>(textEnd - textBegin);
+        
+        // 图层的区块尺寸取第一个区块（Tiled 对同一地图使用统一的区块尺寸）
+        if (layer.streamChunkWidth == 0) {
+            layer.streamChunkWidth = chunk.width;
+            layer.streamChunkHeight = chunk.height;
+        }
+        layer.streamChunks.push_back(std::move(chunk));
+    }
+}
+
+void MapLoader::finalizeStreamedLayers() {
+    // 所有区块的包围盒，以图块为单位
+    bool any = false;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (const auto& layer : layers) {
+        for (const auto& chunk : layer.streamChunks) {
+            if (!any) {
+                minX = chunk.x;
+                minY = chunk.y;
+                maxX = chunk.x + chunk.width;
+                maxY = chunk.y + chunk.height;
+                any = true;
+                continue;
+            }
+            minX = std::min(minX, chunk.x);
+            minY = std::min(minY, chunk.y);
+            maxX = std::max(maxX, chunk.x + chunk.width);
+            maxY = std::max(maxY, chunk.y + chunk.height);
+        }
+    }
+    
+    // 地图整体平移，使最左上的区块位于 (0, 0)，其余代码按有限地图的坐标系工作
+    originTileX = any ? minX : 0;
+    originTileY = any ? minY : 0;
+    width = any ? maxX - minX : 0;
+    height = any ? maxY - minY : 0;
+    
+    // 对象坐标同样平移
+    for (auto& object : objects) {
+        object.bounds.x -= static_cast<float>(originTileX * tileWidth);
+        object.bounds.y -= static_cast<float>(originTileY * tileHeight);
+    }
+    
+    for (auto& layer : layers) {
+        if (!layer.streamed) continue;
+        
+        layer.width = width;
+        layer.height = height;
+        if (layer.streamChunkWidth <= 0 || layer.streamChunkHeight <= 0) {
+            layer.streamChunks.clear();
+            continue;
+        }
+        
+        layer.streamGridX = (width + layer.streamChunkWidth - 1) / layer.streamChunkWidth;
+        layer.streamGridY = (height + layer.streamChunkHeight - 1) / layer.streamChunkHeight;
+        layer.streamGrid.assign(static_cast<size_t>(layer.streamGridX) * layer.streamGridY, -1);
+        
+        std::vector<StreamChunk> placed;
+        placed.reserve(layer.streamChunks.size());
+        for (auto& chunk : layer.streamChunks) {
+            chunk.x -= originTileX;
+            chunk.y -= originTileY;
+            
+            // 区块需与网格对齐，且尺寸一致
+            if (chunk.x % layer.streamChunkWidth != 0 || chunk.y % layer.streamChunkHeight != 0 ||
+                chunk.width != layer.streamChunkWidth || chunk.height != layer.streamChunkHeight) {
+                std::cerr << "忽略未对齐的区块: (" << chunk.x + originTileX << ", " << chunk.y + originTileY
+                          << ") 图层: " << layer.name << std::endl;
+                continue;
+            }
+            
+            int cell = (chunk.y / layer.streamChunkHeight) * layer.streamGridX + chunk.x / layer.streamChunkWidth;
+            layer.streamGrid[cell] = static_cast<int>(placed.size());
+            placed.push_back(std::move(chunk));
+        }
+        layer.streamChunks = std::move(placed);
+    }
+}
+
+void MapLoader::updateStreaming(const Camera2D& camera) {
+    if (!infinite) return;
+    
+    Rectangle bounds = getCameraBounds(camera);
+    float marginX = static_cast<float>(STREAM_MARGIN_TILES * tileWidth);
+    float marginY = static_cast<float>(STREAM_MARGIN_TILES * tileHeight);
+    updateStreaming(Rectangle{bounds.x - marginX, bounds.y - marginY,
+                              bounds.width + marginX * 2.0f, bounds.height + marginY * 2.0f});
+}
+
+void MapLoader::updateStreaming(const Rectangle& keepArea) {
+    if (!infinite || tileWidth <= 0 || tileHeight <= 0) return;
+    streamFrame++;
+    
+    // 1. 接收后台线程解码完成的区块
+    std::vector<ChunkStreamer::Result> results;
+    chunkStreamer.collect(results);
+    for (auto& result : results) {
+        if (result.layerIndex < 0 || result.layerIndex >= static_cast<int>(layers.size())) continue;
+        Layer& layer = layers[result.layerIndex];
+        if (result.chunkIndex < 0 || result.chunkIndex >= static_cast<int>(layer.streamChunks.size())) continue;
+        
+        StreamChunk& chunk = layer.streamChunks[result.chunkIndex];
+        chunk.pending = false;
+        if (!result.ok) {
+            std::cerr << "区块解码失败: (" << chunk.x + originTileX << ", " << chunk.y + originTileY
+                      << ") 图层: " << layer.name << std::endl;
+            continue;
+        }
+        
+        chunk.gids = std::move(result.gids);
+        chunk.resident = true;
+        residentChunkBytes += chunk.gids.size() * sizeof(uint32_t);
+        onChunkResident(layer, chunk);
+    }
+    
+    // 2. 保留范围内的区块标记为使用中，未驻留的提交解码
+    int x0 = static_cast<int>(std::floor(keepArea.x / tileWidth));
+    int y0 = static_cast<int>(std::floor(keepArea.y / tileHeight));
+    int x1 = static_cast<int>(std::floor((keepArea.x + keepArea.width) / tileWidth));
+    int y1 = static_cast<int>(std::floor((keepArea.y + keepArea.height) / tileHeight));
+    
+    for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex) {
+        Layer& layer = layers[layerIndex];
+        if (!layer.streamed || layer.streamGrid.empty()) continue;
+        
+        int cx0 = std::max(0, x0 / layer.streamChunkWidth);
+        int cy0 = std::max(0, y0 / layer.streamChunkHeight);
+        int cx1 = std::min(layer.streamGridX - 1, x1 / layer.streamChunkWidth);
+        int cy1 = std::min(layer.streamGridY - 1, y1 / layer.streamChunkHeight);
+        
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                int index = layer.streamGrid[cy * layer.streamGridX + cx];
+                if (index < 0) continue;
+                
+                StreamChunk& chunk = layer.streamChunks[index];
+                chunk.lastUsedFrame = streamFrame;
+                if (chunk.resident || chunk.pending) continue;
+                
+                chunk.pending = true;
+                chunkStreamer.submit({static_cast<int>(layerIndex), index,
+                                      reinterpret_cast<const char*>(mappedFile.data()) + chunk.dataOffset,
+                                      chunk.dataLength, layer.streamEncoding, layer.streamCompression,
+                                      static_cast<size_t>(chunk.width) * chunk.height});
+            }
+        }
+    }
+    
+    // 3. 超出预算时淘汰保留范围外最久未用的区块
+    if (residentChunkBytes <= streamingBudget) return;
+    
+    std::vector<StreamChunk*> candidates;
+    for (auto& layer : layers) {
+        for (auto& chunk : layer.streamChunks) {
+            if (chunk.resident && chunk.lastUsedFrame != streamFrame) candidates.push_back(&chunk);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const StreamChunk* a, const StreamChunk* b) {
+        return a->lastUsedFrame < b->lastUsedFrame;
+    });
+    
+    for (StreamChunk* chunk : candidates) {
+        if (residentChunkBytes <= streamingBudget) break;
+        evictChunk(*chunk);
+    }
+}
+
+void MapLoader::onChunkResident(Layer& layer, StreamChunk& chunk) {
+    (void)layer;
+    
+    // 碰撞位图覆盖整张地图（每格 1 位），区块驻留时补上这一块
+    if (collidableGids.empty()) return;
+    for (int y = chunk.y; y < chunk.y + chunk.height; ++y) {
+        for (int x = chunk.x; x < chunk.x + chunk.width; ++x) {
+            updateCollisionCell(x, y);
+        }
+    }
+}
+
+void MapLoader::evictChunk(StreamChunk& chunk) {
+    // 碰撞位保留：淘汰只释放解码后的 gid，远处实体仍然按已知地形碰撞
+    residentChunkBytes -= chunk.gids.size() * sizeof(uint32_t);
+    chunk.gids.clear();
+    chunk.gids.shrink_to_fit();
+    chunk.resident = false;
+}
+
+void MapLoader::setStreamingBudget(size_t bytes) {
+    streamingBudget = bytes;
+}
+
+size_t MapLoader::getResidentChunkBytes() const {
+    return residentChunkBytes;
+}
+
+bool MapLoader::isInfinite() const {
+    return infinite;
+}
+
+bool MapLoader::enableHotReload() {
+    if (loadedPath.empty() || loadState.load() == MapLoadState::LOADING) {
+        std::cerr << "地图尚未加载完成，无法开启热重载" << std::endl;
+        return false;
+    }
+    
+    std::string extension = loadedPath.substr(loadedPath.find_last_of(".") + 1);
+    if (extension == "mbin" || extension == "MBIN") {
+        std::cerr << "二进制地图不支持热重载，请加载 .tmx/.json 源文件" << std::endl;
+        return false;
+    }
+    if (infinite) {
+        std::cerr << "无限地图按区块流式加载，暂不支持热重载" << std::endl;
+        return false;
+    }
+    
+    fileWatcher.clear();
+    if (!fileWatcher.addFile(loadedPath)) return false;
+    for (const auto& path : tilesetSourcePaths) {
+        fileWatcher.addFile(path);
+    }
+    
+    hotReloadEnabled = true;
+    std::cout << "地图热重载已开启: " << loadedPath << std::endl;
+    return true;
+}
+
+void MapLoader::reloadWorker(std::string filePath) {
+    reloadParsed = reloadSource->parseMapFile(filePath);
+    reloadDone = true;
+}
+
+bool MapLoader::updateHotReload() {
+    if (!hotReloadEnabled) return false;
+    
+    std::vector<std::string> changed;
+    if (fileWatcher.poll(changed)) {
+        for (const auto& path : changed) {
+            std::cout << "检测到地图文件修改: " << path << std::endl;
+        }
+        reloadQueued = true;
+    }
+    
+    bool applied = false;
+    if (reloadRunning && reloadDone.load()) {
+        reloadThread.join();
+        reloadRunning = false;
+        
+        if (reloadParsed) {
+            auto start = std::chrono::steady_clock::now();
+            applied = applyReload(*reloadSource);
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (applied) std::cout << "地图热重载完成，用时 " << elapsed << " ms" << std::endl;
+            
+            // 新引用的 .tsx 也要监视
+            for (const auto& path : reloadSource->tilesetSourcePaths) {
+                fileWatcher.addFile(path);
+            }
+        } else {
+            // 多半是文件还没写完或内容有误，保留当前地图，等下一次保存
+            std::cerr << "地图重新解析失败，保留当前地图" << std::endl;
+        }
+        reloadSource.reset();
+    }
+    
+    // 解析在工作线程进行，不访问 GPU；期间的新修改合并到下一次
+    if (reloadQueued && !reloadRunning) {
+        reloadQueued = false;
+        reloadSource = std::make_unique<MapLoader>();
+        reloadSource->setTextureLoading(false);
+        reloadDone = false;
+        reloadRunning = true;
+        reloadThread = std::thread(&MapLoader::reloadWorker, this, loadedPath);
+    }
+    
+    return applied;
+}
+
+bool MapLoader::applyReload(MapLoader& source) {
+    // 尺寸、图层、图块集图片变化时区块和纹理都要重建，只能重启
+    bool sameStructure = !source.infinite && source.width == width && source.height == height &&
+        source.tileWidth == tileWidth && source.tileHeight == tileHeight &&
+        source.layers.size() == layers.size() &&
+        source.tilesetFirstGids == tilesetFirstGids && source.tilesetImagePaths == tilesetImagePaths;
+    for (size_t i = 0; sameStructure && i < layers.size(); ++i) {
+        sameStructure = source.layers[i].name == layers[i].name &&
+                        source.layers[i].width == layers[i].width &&
+                        source.layers[i].height == layers[i].height;
+    }
+    if (!sameStructure) {
+        std::cerr << "地图结构发生变化（尺寸、图层或图块集图片），热重载只应用图块和图块属性的修改，请重启游戏" << std::endl;
+        return false;
+    }
+    
+    reloadCollisionChanged = false;
+    reloadX0 = width;
+    reloadY0 = height;
+    reloadX1 = -1;
+    reloadY1 = -1;
+    
+    // 图块属性：碰撞标记或动画变化
+    std::vector<int> oldCollidable = collidableGids;
+    std::vector<int> newCollidable = source.collidableGids;
+    std::sort(oldCollidable.begin(), oldCollidable.end());
+    std::sort(newCollidable.begin(), newCollidable.end());
+    bool collidablesChanged = oldCollidable != newCollidable;
+    if (collidablesChanged) {
+        collidableGids = source.collidableGids;
+        buildCollidableLookup();
+    }
+    
+    bool animationsChanged = source.animations.size() != animations.size() ||
+                             source.animationFrames.size() != animationFrames.size();
+    for (size_t i = 0; !animationsChanged && i < animations.size(); ++i) {
+        const TileAnimation& a = animations[i];
+        const TileAnimation& b = source.animations[i];
+        animationsChanged = a.gid != b.gid || a.tileset != b.tileset ||
+                            a.firstFrame != b.firstFrame || a.frameCount != b.frameCount;
+    }
+    for (size_t i = 0; !animationsChanged && i < animationFrames.size(); ++i) {
+        animationsChanged = animationFrames[i].gid != source.animationFrames[i].gid ||
+                            animationFrames[i].duration != source.animationFrames[i].duration;
+    }
+    if (animationsChanged) {
+        // 先恢复未重定向的查找表，不再是动画的图块回到原样
+        animations = std::move(source.animations);
+        animationFrames = std::move(source.animationFrames);
+        buildTileLookup();
+        resolveAnimations();
+    }
+    
+    // 逐图层比较 gid，整行相同的直接跳过
+    size_t changedTiles = 0;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        Layer& layer = layers[i];
+        const Layer& updated = source.layers[i];
+        // 隐藏图层的脏区块在重新显示后才烘焙
+        layer.opacity = updated.opacity;
+        layer.visible = updated.visible;
+        
+        for (int y = 0; y < layer.height; ++y) {
+            const uint32_t* oldRow = layer.tileData() + static_cast<size_t>(y) * layer.width;
+            const uint32_t* newRow = updated.tileData() + static_cast<size_t>(y) * layer.width;
+            if (std::memcmp(oldRow, newRow, static_cast<size_t>(layer.width) * sizeof(uint32_t)) == 0) continue;
+            
+            for (int x = 0; x < layer.width; ++x) {
+                uint32_t gid = newRow[x];
+                // applyTileChange 可能把映射数据复制出来，每次重新取当前行
+                if (layer.tileData()[static_cast<size_t>(y) * layer.width + x] == gid) continue;
+                
+                bool wasSolid = isSolidCell(x, y);
+                applyTileChange(layer, x, y, gid);
+                changedTiles++;
+                
+                if (isSolidCell(x, y) != wasSolid) {
+                    reloadCollisionChanged = true;
+                    reloadX0 = std::min(reloadX0, x);
+                    reloadY0 = std::min(reloadY0, y);
+                    reloadX1 = std::max(reloadX1, x);
+                    reloadY1 = std::max(reloadY1, y);
+                }
+            }
+        }
+    }
+    
+    // 碰撞标记变了，整张碰撞位图重算
+    if (collidablesChanged) {
+        buildCollisionGrid();
+        reloadCollisionChanged = true;
+        reloadX0 = 0;
+        reloadY0 = 0;
+        reloadX1 = width - 1;
+        reloadY1 = height - 1;
+    }
+    
+    // 动画变了，重新统计动画区块；区块只会在进入视野时重烘
+    if (animationsChanged) {
+        collectAnimatedChunks();
+        for (auto& layer : layers) {
+            for (auto& chunk : layer.chunks) {
+                chunk.dirty = true;
+            }
+        }
+    }
+    
+    objects = std::move(source.objects);
+    objectIndex.build(objects);
+    
+    std::cout << "地图热重载: " << changedTiles << " 个图块变化"
+              << (collidablesChanged ? "，碰撞属性已更新" : "")
+              << (animationsChanged ? "，图块动画已更新" : "") << std::endl;
+    return true;
+}
+
+bool MapLoader::getReloadCollisionBounds(int& x0, int& y0, int& x1, int& y1) const {
+    if (!reloadCollisionChanged) return false;
+    x0 = reloadX0;
+    y0 = reloadY0;
+    x1 = reloadX1;
+    y1 = reloadY1;
+    return true;
+}
+
+// 二进制格式按小端直接映射，大端主机不支持
+static bool isLittleEndianHost() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// 检查 [offset, offset + count * elementSize) 是否落在文件内且满足对齐要求
+static bool sectionInBounds(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t alignment, size_t fileSize) {
+    if (offset % alignment != 0 || offset > fileSize) return false;
+    return count <= (fileSize - offset) / elementSize;
+}
+
+bool MapLoader::loadBinary(const std::string& filePath) {
+    if (!isLittleEndianHost()) {
+        std::cerr << "二进制地图只支持小端平台: " << filePath << std::endl;
+        return false;
+    }
+    
+    if (!mappedFile.open(filePath)) {
+        std::cerr << "无法打开二进制地图: " << filePath << std::endl;
+        return false;
+    }
+    
+    const unsigned char* base = mappedFile.data();
+    const size_t fileSize = mappedFile.size();
+    
+    MapBinaryHeader header;
+    if (fileSize < sizeof(header)) {
+        std::cerr << "二进制地图文件过短: " << filePath << std::endl;
+        mappedFile.close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    
+    if (std::memcmp(header.magic, MAP_BINARY_MAGIC, 4) != 0 || header.version != MAP_BINARY_VERSION) {
+        std::cerr << "二进制地图版本不匹配，请用 meowmon_mapbake 重新生成: " << filePath << std::endl;
+        mappedFile.close();
+        return false;
+    }
+    
+    const uint64_t cellCount = static_cast<uint64_t>(header.width > 0 ? header.width : 0) *
+                               static_cast<uint64_t>(header.height > 0 ? header.height : 0);
+    const uint64_t collisionWords = (cellCount + 63) / 64;
+    
+    bool valid = header.width > 0 && header.height > 0 && header.tileWidth > 0 && header.tileHeight > 0 &&
+        sectionInBounds(header.tilesetOffset, header.tilesetCount, sizeof(MapBinaryTileset), 8, fileSize) &&
+        sectionInBounds(header.layerOffset, header.layerCount, sizeof(MapBinaryLayer), 8, fileSize) &&
+        sectionInBounds(header.collidableGidOffset, header.collidableGidCount, sizeof(int32_t), 4, fileSize) &&
+        sectionInBounds(header.collisionOffset, collisionWords, sizeof(uint64_t), 8, fileSize) &&
+        sectionInBounds(header.objectOffset, header.objectCount, sizeof(MapBinaryObject), 8, fileSize) &&
+        sectionInBounds(header.animationOffset, header.animationCount, sizeof(MapBinaryAnimation), 8, fileSize) &&
+        sectionInBounds(header.animationFrameOffset, header.animationFrameCount, sizeof(MapBinaryAnimationFrame), 8, fileSize) &&
+        sectionInBounds(header.stringOffset, header.stringSize, 1, 1, fileSize);
+    if (!valid) {
+        std::cerr << "二进制地图数据损坏: " << filePath << std::endl;
+        mappedFile.close();
+        return false;
+    }
+    
+    const char* strings = reinterpret_cast<const char*>(base + header.stringOffset);
+    auto readString = [&](const MapBinaryString& ref) {
+        if (static_cast<uint64_t>(ref.offset) + ref.length > header.stringSize) return std::string();
+        return std::string(strings + ref.offset, ref.length);
+    };
+    
+    width = header.width;
+    height = header.height;
+    tileWidth = header.tileWidth;
+    tileHeight = header.tileHeight;
+    orientation = readString(header.orientation);
+    renderOrder = readString(header.renderOrder);
+    
+    // 图块集：图片路径相对于 .mbin 所在目录
+    std::string directory = directoryOf(filePath);
+    const MapBinaryTileset* tilesets = reinterpret_cast<const MapBinaryTileset*>(base + header.tilesetOffset);
+    for (uint32_t i = 0; i < header.tilesetCount; ++i) {
+        std::string imagePath = resolveRelativePath(directory, readString(tilesets[i].image));
+        registerTileset(tilesets[i].firstGid, readString(tilesets[i].name), imagePath, true);
+    }
+    
+    // 图层数据不复制，直接指向映射区域
+    const MapBinaryLayer* layerTable = reinterpret_cast<const MapBinaryLayer*>(base + header.layerOffset);
+    for (uint32_t i = 0; i < header.layerCount; ++i) {
+        const MapBinaryLayer& record = layerTable[i];
+        uint64_t count = static_cast<uint64_t>(record.width > 0 ? record.width : 0) *
+                         static_cast<uint64_t>(record.height > 0 ? record.height : 0);
+        if (count == 0 || !sectionInBounds(record.gidOffset, count, sizeof(uint32_t), 4, fileSize)) {
+            std::cerr << "二进制地图图层数据损坏: " << readString(record.name) << std::endl;
+            layers.clear();
+            mappedFile.close();
+            return false;
+        }
+        
+        Layer layer;
+        layer.name = readString(record.name);
+        layer.width = record.width;
+        layer.height = record.height;
+        layer.visible = record.visible != 0;
+        layer.opacity = record.opacity;
+        layer.mappedGids = reinterpret_cast<const uint32_t*>(base + record.gidOffset);
+        layers.push_back(std::move(layer));
+    }
+    
+    // 碰撞：gid 表和预先算好的位图
+    const int32_t* collidable = reinterpret_cast<const int32_t*>(base + header.collidableGidOffset);
+    collidableGids.assign(collidable, collidable + header.collidableGidCount);
+    buildCollidableLookup();
+    
+    const uint64_t* bits = reinterpret_cast<const uint64_t*>(base + header.collisionOffset);
+    collisionBits.assign(bits, bits + collisionWords);
+    
+    // 对象表
+    const MapBinaryObject* objectRecords = reinterpret_cast<const MapBinaryObject*>(base + header.objectOffset);
+    objects.reserve(header.objectCount);
+    for (uint32_t i = 0; i < header.objectCount; ++i) {
+        MapObject object;
+        object.name = readString(objectRecords[i].name);
+        object.type = readString(objectRecords[i].type);
+        object.bounds = {objectRecords[i].x, objectRecords[i].y, objectRecords[i].width, objectRecords[i].height};
+        object.kind = MapObject::kindFromType(object.type, object.isPoint());
+        objects.push_back(std::move(object));
+    }
+    
+    // 图块动画
+    const MapBinaryAnimation* animationRecords = reinterpret_cast<const MapBinaryAnimation*>(base + header.animationOffset);
+    const MapBinaryAnimationFrame* frameRecords = reinterpret_cast<const MapBinaryAnimationFrame*>(base + header.animationFrameOffset);
+    for (uint32_t i = 0; i < header.animationCount; ++i) {
+        const MapBinaryAnimation& record = animationRecords[i];
+        if (static_cast<uint64_t>(record.firstFrame) + record.frameCount > header.animationFrameCount ||
+            record.tileset >= header.tilesetCount) {
+            std::cerr << "二进制地图动画数据损坏, gid: " << record.gid << std::endl;
+            continue;
+        }
+        
+        std::vector<TileAnimationFrame> frames(record.frameCount);
+        for (uint32_t f = 0; f < record.frameCount; ++f) {
+            frames[f] = {frameRecords[record.firstFrame + f].gid, frameRecords[record.firstFrame + f].duration};
+        }
+        addTileAnimation(static_cast<int>(record.tileset), record.gid, frames.data(), frames.size());
+    }
+    
+    std::cout << "成功加载二进制地图: " << filePath << " 尺寸: " << width << "x" << height
+              << " 图层: " << layers.size() << std::endl;
+    return true;
+}
+
+bool MapLoader::saveBinary(const std::string& filePath) const {
+    if (!isLittleEndianHost()) {
+        std::cerr << "二进制地图只支持小端平台" << std::endl;
+        return false;
+    }
+    
+    if (infinite) {
+        std::cerr << "无限地图按区块流式加载，暂不支持导出二进制格式" << std::endl;
+        return false;
+    }
+    
+    namespace fs = std::filesystem;
+    std::string strings;
+    auto addString = [&strings](const std::string& value) {
+        MapBinaryString ref = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+        strings += value;
+        return ref;
+    };
+    auto align8 = [](uint64_t offset) { return (offset + 7) & ~uint64_t(7); };
+    
+    // 计算各段偏移
+    MapBinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAP_BINARY_MAGIC, 4);
+    header.version = MAP_BINARY_VERSION;
+    header.width = width;
+    header.height = height;
+    header.tileWidth = tileWidth;
+    header.tileHeight = tileHeight;
+    header.orientation = addString(orientation);
+    header.renderOrder = addString(renderOrder);
+    header.tilesetCount = static_cast<uint32_t>(tilesetFirstGids.size());
+    header.layerCount = static_cast<uint32_t>(layers.size());
+    header.collidableGidCount = static_cast<uint32_t>(collidableGids.size());
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.animationCount = static_cast<uint32_t>(animations.size());
+    header.animationFrameCount = static_cast<uint32_t>(animationFrames.size());
+    
+    uint64_t offset = sizeof(MapBinaryHeader);
+    header.tilesetOffset = offset;
+    offset = align8(offset + header.tilesetCount * sizeof(MapBinaryTileset));
+    header.layerOffset = offset;
+    offset = align8(offset + header.layerCount * sizeof(MapBinaryLayer));
+    header.collidableGidOffset = offset;
+    offset = align8(offset + header.collidableGidCount * sizeof(int32_t));
+    header.collisionOffset = offset;
+    offset = align8(offset + collisionBits.size() * sizeof(uint64_t));
+    header.objectOffset = offset;
+    offset = align8(offset + header.objectCount * sizeof(MapBinaryObject));
+    header.animationOffset = offset;
+    offset = align8(offset + header.animationCount * sizeof(MapBinaryAnimation));
+    header.animationFrameOffset = offset;
+    offset = align8(offset + header.animationFrameCount * sizeof(MapBinaryAnimationFrame));
+    
+    // 图块集图片改写为相对于输出文件所在目录的路径
+    std::error_code ec;
+    fs::path outputDirectory = fs::absolute(fs::path(filePath), ec).parent_path();
+    std::vector<MapBinaryTileset> tilesetRecords(header.tilesetCount);
+    for (size_t i = 0; i < tilesetRecords.size(); ++i) {
+        std::string image = i < tilesetImagePaths.size() ? tilesetImagePaths[i] : std::string();
+        fs::path relative = fs::relative(fs::absolute(image, ec), outputDirectory, ec);
+        if (!ec && !relative.empty()) image = relative.generic_string();
+        
+        tilesetRecords[i].firstGid = tilesetFirstGids[i];
+        tilesetRecords[i].reserved = 0;
+        tilesetRecords[i].name = addString(i < tilesetNames.size() ? tilesetNames[i] : std::string());
+        tilesetRecords[i].image = addString(image);
+    }
+    
+    std::vector<MapBinaryObject> objectRecords(header.objectCount);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objectRecords[i].name = addString(objects[i].name);
+        objectRecords[i].type = addString(objects[i].type);
+        objectRecords[i].x = objects[i].bounds.x;
+        objectRecords[i].y = objects[i].bounds.y;
+        objectRecords[i].width = objects[i].bounds.width;
+        objectRecords[i].height = objects[i].bounds.height;
+    }
+    
+    std::vector<MapBinaryAnimation> animationRecords(header.animationCount);
+    for (size_t i = 0; i < animations.size(); ++i) {
+        animationRecords[i] = {animations[i].gid, static_cast<uint32_t>(animations[i].tileset),
+                               animations[i].firstFrame, animations[i].frameCount};
+    }
+    std::vector<MapBinaryAnimationFrame> frameRecords(header.animationFrameCount);
+    for (size_t i = 0; i < animationFrames.size(); ++i) {
+        frameRecords[i] = {animationFrames[i].gid, animationFrames[i].duration};
+    }
+    
+    std::vector<MapBinaryLayer> layerRecords(header.layerCount);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        layerRecords[i].name = addString(layers[i].name);
+        layerRecords[i].width = layers[i].width;
+        layerRecords[i].height = layers[i].height;
+        layerRecords[i].visible = layers[i].visible ? 1u : 0u;
+        layerRecords[i].opacity = layers[i].opacity;
+        layerRecords[i].gidOffset = offset;
+        offset = align8(offset + static_cast<uint64_t>(layers[i].width) * layers[i].height * sizeof(uint32_t));
+    }
+    
+    header.stringOffset = offset;
+    header.stringSize = strings.size();
+    
+    // 组装文件内容
+    std::vector<unsigned char> buffer(static_cast<size_t>(offset + strings.size()), 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (!tilesetRecords.empty()) {
+        std::memcpy(buffer.data() + header.tilesetOffset, tilesetRecords.data(), tilesetRecords.size() * sizeof(MapBinaryTileset));
+    }
+    if (!layerRecords.empty()) {
+        std::memcpy(buffer.data() + header.layerOffset, layerRecords.data(), layerRecords.size() * sizeof(MapBinaryLayer));
+    }
+    for (size_t i = 0; i < collidableGids.size(); ++i) {
+        int32_t gid = collidableGids[i];
+        std::memcpy(buffer.data() + header.collidableGidOffset + i * sizeof(int32_t), &gid, sizeof(gid));
+    }
+    if (!collisionBits.empty()) {
+        std::memcpy(buffer.data() + header.collisionOffset, collisionBits.data(), collisionBits.size() * sizeof(uint64_t));
+    }
+    if (!objectRecords.empty()) {
+        std::memcpy(buffer.data() + header.objectOffset, objectRecords.data(), objectRecords.size() * sizeof(MapBinaryObject));
+    }
+    if (!animationRecords.empty()) {
+        std::memcpy(buffer.data() + header.animationOffset, animationRecords.data(), animationRecords.size() * sizeof(MapBinaryAnimation));
+    }
+    if (!frameRecords.empty()) {
+        std::memcpy(buffer.data() + header.animationFrameOffset, frameRecords.data(), frameRecords.size() * sizeof(MapBinaryAnimationFrame));
+    }
+    for (size_t i = 0; i < layers.size(); ++i) {
+        size_t count = static_cast<size_t>(layers[i].width) * layers[i].height;
+        if (count > 0) {
+            std::memcpy(buffer.data() + layerRecords[i].gidOffset, layers[i].tileData(), count * sizeof(uint32_t));
+        }
+    }
+    if (!strings.empty()) {
+        std::memcpy(buffer.data() + header.stringOffset, strings.data(), strings.size());
+    }
+    
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "无法写入二进制地图: " << filePath << std::endl;
         return false;
     }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+void MapLoader::setTextureLoading(bool enabled) {
+    textureLoading = enabled;
 }
 
-bool MapLoader::parseTilesets(const rapidjson::Value& tilesetsArray, const std::string& filePath) {
-    if (!tilesetsArray.IsArray()) return false;
+bool MapLoader::registerTileset(int firstGid, const std::string& name, const std::string& imagePath, bool usePlaceholder) {
+    Texture2D texture = {0};
     
-    for (rapidjson::SizeType i = 0; i < tilesetsArray.Size(); ++i) {
-        const rapidjson::Value& tileset = tilesetsArray[i];
-        
-        // 获取图块集基本信息
-        int firstGid = tileset["firstgid"].GetInt();
-        
-        // 检查是否有name字段，如果没有使用默认名称
-        std::string name = "tileset";
-        if (tileset.HasMember("name")) {
-            name = tileset["name"].GetString();
-        }
-        
-        // 解析图块集图片
-        if (tileset.HasMember("image")) {
-            std::string imagePath = tileset["image"].GetString();
-            
-            // 尝试加载图块集纹理
-            try {
-                Texture2D texture = ResourceManager::getInstance().loadTexture(imagePath);
-                tilesetTextures.push_back(texture);
-                tilesetFirstGids.push_back(firstGid);
-                tilesetNames.push_back(name);
-            } catch (const std::exception& e) {
-                std::cerr << "无法加载图块集图片: " << imagePath << " 错误: " << e.what() << std::endl;
-                return false;
-            }
-        }
-        // 如果是引用外部tileset文件（Tiled格式）
-        else if (tileset.HasMember("source")) {
-            std::string sourcePath = tileset["source"].GetString();
-            
-            // 构建完整的tileset图片路径
-            std::string directoryPath = filePath.substr(0, filePath.find_last_of("/\\"));
-            std::string imagePath;
+    if (textureLoading) {
+        try {
+            texture = ResourceManager::getInstance().loadTexture(imagePath);
+        } catch (const std::exception& e) {
+            std::cerr << "无法加载图块集图片: " << imagePath << " 错误: " << e.what() << std::endl;
+            if (!usePlaceholder) return false;
             
-            // 处理source路径中的../引用
-            if (sourcePath.find("../") == 0) {
-                std::string parentDir = directoryPath.substr(0, directoryPath.find_last_of("/\\"));
-                imagePath = parentDir + "/" + sourcePath.substr(3);
-            } else {
-                imagePath = directoryPath + "/" + sourcePath;
-            }
-            
-            // 尝试加载tileset图片
-            try {
-                Texture2D texture = ResourceManager::getInstance().loadTexture(imagePath);
-                tilesetTextures.push_back(texture);
-                tilesetFirstGids.push_back(firstGid);
-                tilesetNames.push_back(name);
-            } catch (const std::exception& e) {
-                std::cerr << "无法加载tileset图片: " << imagePath << " 错误: " << e.what() << std::endl;
-                // 创建占位纹理
-                Image image = GenImageColor(32, 32, GRAY);
-                Texture2D texture = LoadTextureFromImage(image);
-                UnloadImage(image);
-                
-                tilesetTextures.push_back(texture);
-                tilesetFirstGids.push_back(firstGid);
-                tilesetNames.push_back(name);
-            }
+            // 创建占位纹理
+            Image image = GenImageColor(32, 32, GRAY);
+            texture = LoadTextureFromImage(image);
+            UnloadImage(image);
         }
     }
     
+    tilesetTextures.push_back(texture);
+    tilesetFirstGids.push_back(firstGid);
+    tilesetNames.push_back(name);
+    tilesetImagePaths.push_back(imagePath);
     return true;
 }
 
-bool MapLoader::parseLayers(const rapidjson::Value& layersArray) {
-    if (!layersArray.IsArray()) return false;
+void MapLoader::addTileAnimation(int tileset, uint32_t gid, const TileAnimationFrame* frames, size_t frameCount) {
+    if (gid == 0 || frameCount == 0) return;
+    
+    TileAnimation animation;
+    animation.gid = gid & TILE_GID_MASK;
+    animation.tileset = tileset;
+    animation.firstFrame = static_cast<uint32_t>(animationFrames.size());
+    animation.frameCount = static_cast<uint32_t>(frameCount);
+    animation.duration = 0;
+    animation.currentFrame = 0;
+    for (size_t i = 0; i < frameCount; ++i) {
+        animationFrames.push_back({frames[i].gid & TILE_GID_MASK, frames[i].duration});
+        animation.duration += frames[i].duration;
+    }
+    animations.push_back(std::move(animation));
+}
+
+void MapLoader::buildTileLookup() {
+    tileLookup.clear();
+    if (tileWidth <= 0 || tileHeight <= 0) return;
+    
+    // 按 firstgid 从小到大填表，重叠区间由后面的图块集覆盖（与 Tiled 的查找规则一致）
+    std::vector<size_t> order(tilesetFirstGids.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return tilesetFirstGids[a] < tilesetFirstGids[b];
+    });
     
-    for (rapidjson::SizeType i = 0; i < layersArray.Size(); ++i) {
-        const rapidjson::Value& layerValue = layersArray[i];
+    for (size_t i : order) {
+        if (i >= tilesetTextures.size()) continue;
         
-        Layer layer;
+        const Texture2D& texture = tilesetTextures[i];
+        int columns = texture.width / tileWidth;
+        int rows = texture.height / tileHeight;
+        if (columns <= 0 || rows <= 0 || tilesetFirstGids[i] <= 0) continue;
         
-        // 解析图层基本信息
-        if (layerValue.HasMember("name")) layer.name = layerValue["name"].GetString();
-        if (layerValue.HasMember("width")) layer.width = layerValue["width"].GetInt();
-        if (layerValue.HasMember("height")) layer.height = layerValue["height"].GetInt();
-        if (layerValue.HasMember("visible")) layer.visible = layerValue["visible"].GetBool();
-        else layer.visible = true;
-        if (layerValue.HasMember("opacity")) layer.opacity = layerValue["opacity"].GetFloat();
-        else layer.opacity = 1.0f;
-        
-        // 解析图块数据
-        if (layerValue.HasMember("data") && layerValue["data"].IsArray()) {
-            const rapidjson::Value& dataArray = layerValue["data"];
-            
-            for (rapidjson::SizeType j = 0; j < dataArray.Size(); ++j) {
-                const rapidjson::Value& dataValue = dataArray[j];
-                int gid = 0;
-                
-                if (dataValue.IsInt()) {
-                    gid = dataValue.GetInt();
-                } else if (dataValue.IsInt64()) {
-                    gid = static_cast<int>(dataValue.GetInt64());
-                } else if (dataValue.IsString()) {
-                    std::string str = dataValue.GetString();
-                    gid = std::stoi(str);
-                } else {
-                    std::cerr << "警告: 无法解析图块数据类型" << std::endl;
-                    continue;
-                }
-                
-                if (gid == 0) continue;
-                
-                // 处理 Tiled 的翻转标志位
-                const int FLIPPED_HORIZONTALLY_FLAG = 0x80000000;
-                const int FLIPPED_VERTICALLY_FLAG = 0x40000000;
-                const int FLIPPED_DIAGONALLY_FLAG = 0x20000000;
-                const int ROTATED_HEXAGONAL_120_FLAG = 0x10000000;
-                
-                int realGid = gid & ~(FLIPPED_HORIZONTALLY_FLAG | FLIPPED_VERTICALLY_FLAG | FLIPPED_DIAGONALLY_FLAG | ROTATED_HEXAGONAL_120_FLAG);
-                
-                if (realGid == 0) continue;
-                
-                int x = j % layer.width;
-                int y = j / layer.width;
-                
-                Tile tile;
-                tile.id = static_cast<int>(j);
-                tile.gid = realGid;
-                tile.position = {static_cast<float>(x * tileWidth), static_cast<float>(y * tileHeight)};
-                tile.rect = {tile.position.x, tile.position.y, static_cast<float>(tileWidth), static_cast<float>(tileHeight)};
-                tile.isCollidable = (realGid > 100);
-                
-                layer.tiles.push_back(tile);
-            }
+        size_t firstGid = static_cast<size_t>(tilesetFirstGids[i]);
+        size_t tileCount = static_cast<size_t>(columns) * rows;
+        if (tileLookup.size() < firstGid + tileCount) {
+            tileLookup.resize(firstGid + tileCount, TileDrawInfo{{0}, {0, 0, 0, 0}});
         }
         
-        layers.push_back(layer);
+        for (size_t local = 0; local < tileCount; ++local) {
+            TileDrawInfo& info = tileLookup[firstGid + local];
+            info.texture = texture;
+            info.source = {static_cast<float>((local % columns) * tileWidth),
+                           static_cast<float>((local / columns) * tileHeight),
+                           static_cast<float>(tileWidth), static_cast<float>(tileHeight)};
+        }
+    }
+}
+
+void MapLoader::resolveAnimations() {
+    gidAnimation.clear();
+    tilesetClocks.assign(tilesetFirstGids.size(), 0.0);
+    if (animations.empty()) return;
+    
+    // 帧的源矩形取自未重定向的查找表，动画图块本身也可能是别的动画的某一帧
+    animationFrameInfo.resize(animationFrames.size());
+    for (size_t i = 0; i < animationFrames.size(); ++i) {
+        uint32_t gid = animationFrames[i].gid;
+        animationFrameInfo[i] = gid < tileLookup.size() ? tileLookup[gid] : TileDrawInfo{{0}, {0, 0, 0, 0}};
     }
     
-    return true;
+    for (size_t i = 0; i < animations.size(); ++i) {
+        TileAnimation& animation = animations[i];
+        if (animation.gid >= gidAnimation.size()) gidAnimation.resize(animation.gid + 1, -1);
+        gidAnimation[animation.gid] = static_cast<int>(i);
+        
+        animation.currentFrame = 0;
+        applyAnimationFrame(animation);
+    }
+    
+    std::cout << "图块动画: " << animations.size() << " 种, " << animationFrames.size() << " 帧" << std::endl;
 }
 
-// TMX格式解析器 - 使用字符串解析
-bool MapLoader::loadTMX(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "无法打开TMX文件: " << filePath << std::endl;
-        return false;
+void MapLoader::applyAnimationFrame(const TileAnimation& animation) {
+    const TileDrawInfo& frame = animationFrameInfo[animation.firstFrame + animation.currentFrame];
+    if (animation.gid < tileLookup.size() && frame.texture.id != 0) {
+        tileLookup[animation.gid] = frame;
     }
+}
+
+void MapLoader::updateAnimations(float deltaTime) {
+    if (animations.empty() || deltaTime <= 0.0f) return;
     
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
+    double step = static_cast<double>(deltaTime) * 1000.0;
+    for (auto& clock : tilesetClocks) {
+        clock += step;
+    }
     
-    return parseTMXContent(content, filePath);
+    for (auto& animation : animations) {
+        if (animation.duration == 0 || animation.frameCount < 2) continue;
+        if (animation.tileset < 0 || static_cast<size_t>(animation.tileset) >= tilesetClocks.size()) continue;
+        
+        // 当前时刻落在第几帧
+        double time = std::fmod(tilesetClocks[animation.tileset], static_cast<double>(animation.duration));
+        uint32_t frame = 0;
+        double frameEnd = animationFrames[animation.firstFrame].duration;
+        while (frame + 1 < animation.frameCount && time >= frameEnd) {
+            ++frame;
+            frameEnd += animationFrames[animation.firstFrame + frame].duration;
+        }
+        if (frame == animation.currentFrame) continue;
+        
+        // 逐图块绘制的图层直接读查找表；已烘焙的区块只重烘含有该图块的那些
+        animation.currentFrame = frame;
+        applyAnimationFrame(animation);
+        for (const auto& ref : animation.chunks) {
+            if (ref.first >= layers.size()) continue;
+            std::vector<TileChunk>& chunks = layers[ref.first].chunks;
+            if (ref.second < chunks.size()) chunks[ref.second].dirty = true;
+        }
+    }
 }
 
-bool MapLoader::loadTSX(const std::string& filePath, int firstGid) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "无法打开TSX文件: " << filePath << std::endl;
-        return false;
+void MapLoader::buildCollidableLookup() {
+    gidCollides.assign(tileLookup.size(), false);
+    for (int gid : collidableGids) {
+        if (gid <= 0) continue;
+        if (static_cast<size_t>(gid) >= gidCollides.size()) gidCollides.resize(gid + 1, false);
+        gidCollides[gid] = true;
+    }
+}
+
+void MapLoader::buildCollisionGrid() {
+    buildCollidableLookup();
+    
+    collisionBits.assign((static_cast<size_t>(width) * height + 63) / 64, 0);
+    
+    // 无限地图的区块在驻留时才写入碰撞位
+    if (collidableGids.empty() || infinite) return;
+    
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            updateCollisionCell(x, y);
+        }
+    }
+}
+
+void MapLoader::updateCollisionCell(int x, int y) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    
+    // 碰撞由图块属性决定，隐藏的碰撞图层同样生效
+    bool solid = false;
+    for (const auto& layer : layers) {
+        uint32_t gid = layer.getGid(x, y) & TILE_GID_MASK;
+        if (gid != 0 && gid < gidCollides.size() && gidCollides[gid]) {
+            solid = true;
+            break;
+        }
     }
     
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
+    size_t index = static_cast<size_t>(y) * width + x;
+    if (solid) collisionBits[index >> 6] |= (uint64_t(1) << (index & 63));
+    else collisionBits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+}
+
+bool MapLoader::isSolidCell(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return false;
     
-    return parseTSXContent(content, firstGid, filePath);
+    size_t index = static_cast<size_t>(y) * width + x;
+    return (collisionBits[index >> 6] >> (index & 63)) & 1;
 }
 
-bool MapLoader::parseTMXContent(const std::string& content, const std::string& filePath) {
-    // 简单的字符串解析来提取地图属性
-    size_t mapPos = content.find("<map");
-    if (mapPos == std::string::npos) return false;
+void MapLoader::drawTile(uint32_t gid, Vector2 position) const {
+    uint32_t realGid = gid & TILE_GID_MASK;
+    if (realGid == 0 || realGid >= tileLookup.size()) return;
+    
+    const TileDrawInfo& info = tileLookup[realGid];
+    if (info.texture.id == 0) return;
+    
+    uint32_t flags = gid >> 29;
+    if (flags == 0) {
+        DrawTextureRec(info.texture, info.source, position, WHITE);
+        return;
+    }
     
-    // 提取宽度、高度、图块大小
-    size_t widthPos = content.find("width=\"", mapPos);
-    size_t heightPos = content.find("height=\"", mapPos);
-    size_t tilewidthPos = content.find("tilewidth=\"", mapPos);
-    size_t tileheightPos = content.find("tileheight=\"", mapPos);
+    const TileOrientation& orientation = TILE_ORIENTATIONS[flags];
+    Rectangle source = info.source;
+    if (orientation.flipX) source.width = -source.width;
     
-    if (widthPos != std::string::npos && heightPos != std::string::npos && 
-        tilewidthPos != std::string::npos && tileheightPos != std::string::npos) {
+    float halfW = info.source.width * 0.5f;
+    float halfH = info.source.height * 0.5f;
+    Rectangle dest = {position.x + halfW, position.y + halfH, info.source.width, info.source.height};
+    DrawTexturePro(info.texture, source, dest, {halfW, halfH}, orientation.rotation, WHITE);
+}
+
+void MapLoader::buildChunks() {
+    for (auto& layer : layers) {
+        releaseChunks(layer);
         
-        size_t widthEnd = content.find("\"", widthPos + 7);
-        size_t heightEnd = content.find("\"", heightPos + 8);
-        size_t tilewidthEnd = content.find("\"", tilewidthPos + 11);
-        size_t tileheightEnd = content.find("\"", tileheightPos + 12);
+        // 流式图层只有视野附近的数据，逐图块绘制
+        if (layer.width <= 0 || layer.height <= 0 || layer.streamed) continue;
         
-        width = std::stoi(content.substr(widthPos + 7, widthEnd - widthPos - 7));
-        height = std::stoi(content.substr(heightPos + 8, heightEnd - heightPos - 8));
-        tileWidth = std::stoi(content.substr(tilewidthPos + 11, tilewidthEnd - tilewidthPos - 11));
-        tileHeight = std::stoi(content.substr(tileheightPos + 12, tileheightEnd - tileheightPos - 12));
+        layer.chunksX = (layer.width + CHUNK_TILES - 1) / CHUNK_TILES;
+        layer.chunksY = (layer.height + CHUNK_TILES - 1) / CHUNK_TILES;
+        layer.chunks.resize(static_cast<size_t>(layer.chunksX) * layer.chunksY);
         
-        std::cout << "TMX地图尺寸: " << width << "x" << height << " 图块大小: " << tileWidth << "x" << tileHeight << std::endl;
-    } else {
-        return false;
+        for (int cy = 0; cy < layer.chunksY; ++cy) {
+            for (int cx = 0; cx < layer.chunksX; ++cx) {
+                TileChunk& chunk = layer.chunks[cy * layer.chunksX + cx];
+                chunk.chunkX = cx;
+                chunk.chunkY = cy;
+                chunk.texture = {0};
+                chunk.dirty = true;
+            }
+        }
     }
-    
-    // 解析tileset
-    size_t tilesetPos = content.find("<tileset");
-    while (tilesetPos != std::string::npos) {
-        size_t nextTagPos = content.find(">", tilesetPos);
-        size_t sourcePos = content.find("source=\"", tilesetPos);
-        size_t firstgidPos = content.find("firstgid=\"", tilesetPos);
-        
-        int firstGid = 1;
-        if (firstgidPos != std::string::npos && (nextTagPos == std::string::npos || firstgidPos < nextTagPos)) {
-            size_t firstgidEnd = content.find("\"", firstgidPos + 10);
-            firstGid = std::stoi(content.substr(firstgidPos + 10, firstgidEnd - firstgidPos - 10));
+}
+
+void MapLoader::releaseChunks(Layer& layer) {
+    for (auto& chunk : layer.chunks) {
+        if (chunk.texture.id != 0) {
+            UnloadRenderTexture(chunk.texture);
         }
+    }
+    layer.chunks.clear();
+    layer.chunksX = 0;
+    layer.chunksY = 0;
+}
 
-        // 检查是否是外部 TSX 文件
-        if (sourcePos != std::string::npos && (nextTagPos == std::string::npos || sourcePos < nextTagPos)) {
-            size_t sourceEnd = content.find("\"", sourcePos + 8);
-            std::string source = content.substr(sourcePos + 8, sourceEnd - sourcePos - 8);
-            
-            std::string directoryPath = filePath.substr(0, filePath.find_last_of("/\\"));
-            std::string tsxPath = directoryPath + "/" + source;
-            
-            if (!loadTSX(tsxPath, firstGid)) {
-                std::cerr << "无法加载外部 TSX 文件: " << tsxPath << std::endl;
-            }
-        } else {
-            // 嵌入式 tileset，寻找 <image> 标签
-            size_t imageTagPos = content.find("<image", tilesetPos);
-            size_t tilesetEndPos = content.find("</tileset>", tilesetPos);
+void MapLoader::collectAnimatedChunks() {
+    for (auto& animation : animations) {
+        animation.chunks.clear();
+    }
+    if (animations.empty() || gidAnimation.empty()) return;
+    
+    // 按区块扫描一遍，同一区块内重复出现的动画图块只记一次
+    std::vector<uint32_t> lastChunk(animations.size(), UINT32_MAX);
+    uint32_t serial = 0;
+    for (uint32_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = layers[l];
+        for (uint32_t c = 0; c < layer.chunks.size(); ++c, ++serial) {
+            const TileChunk& chunk = layer.chunks[c];
+            int x0 = chunk.chunkX * CHUNK_TILES;
+            int y0 = chunk.chunkY * CHUNK_TILES;
+            int x1 = std::min(x0 + CHUNK_TILES, layer.width);
+            int y1 = std::min(y0 + CHUNK_TILES, layer.height);
             
-            if (imageTagPos != std::string::npos && (tilesetEndPos == std::string::npos || imageTagPos < tilesetEndPos)) {
-                size_t imageSourcePos = content.find("source=\"", imageTagPos);
-                if (imageSourcePos != std::string::npos) {
-                    size_t imageSourceEnd = content.find("\"", imageSourcePos + 8);
-                    std::string imageSource = content.substr(imageSourcePos + 8, imageSourceEnd - imageSourcePos - 8);
-                    
-                    std::string directoryPath = filePath.substr(0, filePath.find_last_of("/\\"));
-                    std::string imagePath = directoryPath + "/" + imageSource;
+            for (int y = y0; y < y1; ++y) {
+                const uint32_t* row = layer.tileData() + static_cast<size_t>(y) * layer.width;
+                for (int x = x0; x < x1; ++x) {
+                    uint32_t gid = row[x] & TILE_GID_MASK;
+                    if (gid >= gidAnimation.size() || gidAnimation[gid] < 0) continue;
                     
-                    try {
-                        Texture2D texture = ResourceManager::getInstance().loadTexture(imagePath);
-                        tilesetTextures.push_back(texture);
-                        tilesetFirstGids.push_back(firstGid);
-                        
-                        // 提取名称
-                        std::string name = "embedded_tileset";
-                        size_t namePos = content.find("name=\"", tilesetPos);
-                        if (namePos != std::string::npos && namePos < nextTagPos) {
-                            size_t nameEnd = content.find("\"", namePos + 6);
-                            name = content.substr(namePos + 6, nameEnd - namePos - 6);
-                        }
-                        tilesetNames.push_back(name);
-                        std::cout << "加载嵌入式图块集: " << name << " 图片: " << imagePath << std::endl;
-                    } catch (...) {
-                        std::cerr << "无法加载嵌入式图块集图片: " << imagePath << std::endl;
-                    }
+                    int index = gidAnimation[gid];
+                    if (lastChunk[index] == serial) continue;
+                    lastChunk[index] = serial;
+                    animations[index].chunks.emplace_back(l, c);
                 }
             }
         }
-        
-        tilesetPos = content.find("<tileset", tilesetPos + 1);
+    }
+}
+
+void MapLoader::addAnimatedChunk(TileAnimation& animation, uint32_t layerIndex, uint32_t chunkIndex) {
+    std::pair<uint32_t, uint32_t> ref(layerIndex, chunkIndex);
+    if (std::find(animation.chunks.begin(), animation.chunks.end(), ref) == animation.chunks.end()) {
+        animation.chunks.push_back(ref);
+    }
+}
+
+bool MapLoader::bakeChunk(const Layer& layer, TileChunk& chunk) {
+    int x0 = chunk.chunkX * CHUNK_TILES;
+    int y0 = chunk.chunkY * CHUNK_TILES;
+    // 边缘区块可能不足 CHUNK_TILES 个图块
+    int x1 = std::min(x0 + CHUNK_TILES, layer.width);
+    int y1 = std::min(y0 + CHUNK_TILES, layer.height);
+    
+    if (chunk.texture.id == 0) {
+        chunk.texture = LoadRenderTexture((x1 - x0) * tileWidth, (y1 - y0) * tileHeight);
+        if (chunk.texture.id == 0) return false;
     }
     
-    // 解析图层
-    size_t layerPos = content.find("<layer");
-    while (layerPos != std::string::npos) {
-        Layer layer;
-        layer.visible = true;
-        layer.opacity = 1.0f;
+    BeginTextureMode(chunk.texture);
+    ClearBackground(BLANK);
+    for (int y = y0; y < y1; ++y) {
+        const uint32_t* row = layer.tileData() + static_cast<size_t>(y) * layer.width;
+        for (int x = x0; x < x1; ++x) {
+            drawTile(row[x], {static_cast<float>((x - x0) * tileWidth), static_cast<float>((y - y0) * tileHeight)});
+        }
+    }
+    EndTextureMode();
+    
+    chunk.dirty = false;
+    return true;
+}
+
+void MapLoader::bakeDirtyChunks() {
+    bakeDirtyRegion(0, 0, width, height);
+}
+
+void MapLoader::bakeDirtyChunks(const Camera2D& camera) {
+    if (tileWidth <= 0 || tileHeight <= 0) return;
+    
+    Rectangle bounds = getCameraBounds(camera);
+    int x0 = static_cast<int>(std::floor(bounds.x / tileWidth));
+    int y0 = static_cast<int>(std::floor(bounds.y / tileHeight));
+    int x1 = static_cast<int>(std::floor((bounds.x + bounds.width) / tileWidth)) + 1;
+    int y1 = static_cast<int>(std::floor((bounds.y + bounds.height) / tileHeight)) + 1;
+    
+    bakeDirtyRegion(x0, y0, x1, y1);
+}
+
+void MapLoader::bakeDirtyRegion(int x0, int y0, int x1, int y1) {
+    for (auto& layer : layers) {
+        if (!layer.visible || layer.chunks.empty()) continue;
         
-        // 提取图层属性
-        size_t namePos = content.find("name=\"", layerPos);
-        size_t widthPos = content.find("width=\"", layerPos);
-        size_t heightPos = content.find("height=\"", layerPos);
+        int lx0 = std::max(x0, 0);
+        int ly0 = std::max(y0, 0);
+        int lx1 = std::min(x1, layer.width);
+        int ly1 = std::min(y1, layer.height);
+        if (lx0 >= lx1 || ly0 >= ly1) continue;
         
-        if (namePos != std::string::npos) {
-            size_t nameEnd = content.find("\"", namePos + 6);
-            layer.name = content.substr(namePos + 6, nameEnd - namePos - 6);
+        for (int cy = ly0 / CHUNK_TILES; cy <= (ly1 - 1) / CHUNK_TILES; ++cy) {
+            for (int cx = lx0 / CHUNK_TILES; cx <= (lx1 - 1) / CHUNK_TILES; ++cx) {
+                TileChunk& chunk = layer.chunks[cy * layer.chunksX + cx];
+                if (chunk.dirty && !bakeChunk(layer, chunk)) {
+                    // 平台不支持帧缓冲（如软件渲染），关闭区块缓存，退回逐图块绘制
+                    std::cerr << "无法创建区块纹理，关闭地图区块缓存" << std::endl;
+                    for (auto& l : layers) {
+                        releaseChunks(l);
+                    }
+                    return;
+                }
+            }
         }
+    }
+}
+
+void MapLoader::draw() {
+    drawRegion(0, 0, width, height);
+}
+
+Rectangle MapLoader::getCameraBounds(const Camera2D& camera) const {
+    // 取屏幕四角在世界坐标中的包围盒（相机可能旋转）
+    float screenW = static_cast<float>(GetScreenWidth());
+    float screenH = static_cast<float>(GetScreenHeight());
+    Vector2 corners[4] = {
+        GetScreenToWorld2D({0.0f, 0.0f}, camera),
+        GetScreenToWorld2D({screenW, 0.0f}, camera),
+        GetScreenToWorld2D({0.0f, screenH}, camera),
+        GetScreenToWorld2D({screenW, screenH}, camera)
+    };
+    
+    float minX = corners[0].x, maxX = corners[0].x;
+    float minY = corners[0].y, maxY = corners[0].y;
+    for (const auto& corner : corners) {
+        minX = std::min(minX, corner.x);
+        maxX = std::max(maxX, corner.x);
+        minY = std::min(minY, corner.y);
+        maxY = std::max(maxY, corner.y);
+    }
+    
+    return Rectangle{minX, minY, maxX - minX, maxY - minY};
+}
+
+void MapLoader::draw(const Camera2D& camera) {
+    if (tileWidth <= 0 || tileHeight <= 0) return;
+    
+    Rectangle bounds = getCameraBounds(camera);
+    int x0 = static_cast<int>(std::floor(bounds.x / tileWidth));
+    int y0 = static_cast<int>(std::floor(bounds.y / tileHeight));
+    int x1 = static_cast<int>(std::floor((bounds.x + bounds.width) / tileWidth)) + 1;
+    int y1 = static_cast<int>(std::floor((bounds.y + bounds.height) / tileHeight)) + 1;
+    
+    drawRegion(x0, y0, x1, y1);
+}
+
+void MapLoader::drawRegion(int x0, int y0, int x1, int y1) const {
+    for (const auto& layer : layers) {
+        if (!layer.visible) continue;
+        
+        int lx0 = std::max(x0, 0);
+        int ly0 = std::max(y0, 0);
+        int lx1 = std::min(x1, layer.width);
+        int ly1 = std::min(y1, layer.height);
+        if (lx0 >= lx1 || ly0 >= ly1) continue;
         
-        if (widthPos != std::string::npos) {
-            size_t widthEnd = content.find("\"", widthPos + 7);
-            layer.width = std::stoi(content.substr(widthPos + 7, widthEnd - widthPos - 7));
+        // 流式图层逐图块查询驻留区块
+        if (layer.streamed) {
+            for (int y = ly0; y < ly1; ++y) {
+                for (int x = lx0; x < lx1; ++x) {
+                    drawTile(layer.getGid(x, y), {static_cast<float>(x * tileWidth), static_cast<float>(y * tileHeight)});
+                }
+            }
+            continue;
         }
         
-        if (heightPos != std::string::npos) {
-            size_t heightEnd = content.find("\"", heightPos + 8);
-            layer.height = std::stoi(content.substr(heightPos + 8, heightEnd - heightPos - 8));
+        // 没有区块缓存时退回逐图块绘制
+        if (layer.chunks.empty()) {
+            for (int y = ly0; y < ly1; ++y) {
+                const uint32_t* row = layer.tileData() + static_cast<size_t>(y) * layer.width;
+                for (int x = lx0; x < lx1; ++x) {
+                    drawTile(row[x], {static_cast<float>(x * tileWidth), static_cast<float>(y * tileHeight)});
+                }
+            }
+            continue;
         }
         
-        // 查找数据部分
-        size_t dataPos = content.find("<data", layerPos);
-        size_t dataEnd = content.find("</data>", layerPos);
+        int cx0 = lx0 / CHUNK_TILES;
+        int cy0 = ly0 / CHUNK_TILES;
+        int cx1 = (lx1 - 1) / CHUNK_TILES;
+        int cy1 = (ly1 - 1) / CHUNK_TILES;
         
-        if (dataPos != std::string::npos && dataEnd != std::string::npos) {
-            std::string dataContent = content.substr(dataPos, dataEnd - dataPos);
-            
-            // 提取CSV内容
-            size_t csvStart = dataContent.find(">");
-            if (csvStart != std::string::npos) {
-                std::string csvData = dataContent.substr(csvStart + 1);
-                
-                // 解析CSV
-                std::stringstream ss(csvData);
-                std::string token;
-                int index = 0;
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const TileChunk& chunk = layer.chunks[cy * layer.chunksX + cx];
                 
-                while (std::getline(ss, token, ',')) {
-                    token.erase(0, token.find_first_not_of(" \t\n\r"));
-                    token.erase(token.find_last_not_of(" \t\n\r") + 1);
-                    
-                    if (!token.empty()) {
-                        try {
-                            // 处理可能的翻转标志位
-                            unsigned long long gidValue = std::stoull(token);
-                            
-                            // 处理 Tiled 的翻转标志位
-                            const unsigned long long FLIPPED_HORIZONTALLY_FLAG = 0x80000000;
-                            const unsigned long long FLIPPED_VERTICALLY_FLAG = 0x40000000;
-                            const unsigned long long FLIPPED_DIAGONALLY_FLAG = 0x20000000;
-                            const unsigned long long ROTATED_HEXAGONAL_120_FLAG = 0x10000000;
-                            
-                            unsigned long long realGid = gidValue & ~(FLIPPED_HORIZONTALLY_FLAG | FLIPPED_VERTICALLY_FLAG | FLIPPED_DIAGONALLY_FLAG | ROTATED_HEXAGONAL_120_FLAG);
-                            
-                            if (realGid > 0 && realGid <= INT_MAX) {
-                                int gid = static_cast<int>(realGid);
-                                int x = index % layer.width;
-                                int y = index / layer.width;
-                                
-                                Tile tile;
-                                tile.id = index;
-                                tile.gid = gid;
-                                tile.position = {static_cast<float>(x * tileWidth), static_cast<float>(y * tileHeight)};
-                                tile.rect = {tile.position.x, tile.position.y, static_cast<float>(tileWidth), static_cast<float>(tileHeight)};
-                                tile.isCollidable = (gid > 100);
-                                
-                                layer.tiles.push_back(tile);
-                            }
-                        } catch (const std::exception& e) {
-                            std::cerr << "解析图块数据错误: " << token << " - " << e.what() << std::endl;
+                if (chunk.dirty || chunk.texture.id == 0) {
+                    // 尚未烘焙的区块本帧逐图块绘制
+                    int tx0 = cx * CHUNK_TILES;
+                    int ty0 = cy * CHUNK_TILES;
+                    int tx1 = std::min(tx0 + CHUNK_TILES, layer.width);
+                    int ty1 = std::min(ty0 + CHUNK_TILES, layer.height);
+                    for (int y = ty0; y < ty1; ++y) {
+                        for (int x = tx0; x < tx1; ++x) {
+                            drawTile(layer.tileData()[static_cast<size_t>(y) * layer.width + x],
+                                     {static_cast<float>(x * tileWidth), static_cast<float>(y * tileHeight)});
                         }
                     }
-                    
-                    index++;
+                    continue;
                 }
+                
+                // RenderTexture 在 OpenGL 中是上下颠倒的，源矩形高度取负值翻转
+                const Texture2D& texture = chunk.texture.texture;
+                Rectangle sourceRect = {0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height)};
+                Vector2 position = {static_cast<float>(cx * CHUNK_TILES * tileWidth),
+                                    static_cast<float>(cy * CHUNK_TILES * tileHeight)};
+                DrawTextureRec(texture, sourceRect, position, WHITE);
             }
         }
+    }
+}
+
+bool MapLoader::setTile(const std::string& layerName, int x, int y, uint32_t gid) {
+    for (auto& layer : layers) {
+        if (layer.name != layerName) continue;
+        
+        if (x < 0 || y < 0 || x >= layer.width || y >= layer.height) return false;
+        
+        // 流式图层只能修改已驻留的区块，淘汰后修改会丢失
+        if (layer.streamed) {
+            const StreamChunk* found = layer.findStreamChunk(x, y);
+            if (!found || !found->resident) return false;
+            
+            StreamChunk& chunk = const_cast<StreamChunk&>(*found);
+            chunk.gids[static_cast<size_t>(y - chunk.y) * chunk.width + (x - chunk.x)] = gid;
+            updateCollisionCell(x, y);
+            return true;
+        }
+        
+        if (layer.tileData()[static_cast<size_t>(y) * layer.width + x] == gid) return true;
         
-        layers.push_back(layer);
-        layerPos = content.find("<layer", layerPos + 1);
+        applyTileChange(layer, x, y, gid);
+        return true;
     }
     
-    std::cout << "成功加载TMX地图: " << filePath << std::endl;
-    return true;
+    return false;
 }
 
-bool MapLoader::parseTSXContent(const std::string& content, int firstGid, const std::string& filePath) {
-    // 提取tileset名称
-    std::string tilesetName = "tileset";
-    size_t namePos = content.find("name=\"");
-    if (namePos != std::string::npos) {
-        size_t nameEnd = content.find("\"", namePos + 6);
-        if (nameEnd != std::string::npos) {
-            tilesetName = content.substr(namePos + 6, nameEnd - namePos - 6);
-        }
+void MapLoader::applyTileChange(Layer& layer, int x, int y, uint32_t gid) {
+    // 内存映射的图层只读，第一次修改时复制一份
+    if (layer.mappedGids) {
+        layer.gids.assign(layer.mappedGids, layer.mappedGids + static_cast<size_t>(layer.width) * layer.height);
+        layer.mappedGids = nullptr;
     }
     
-    // 提取图片路径
-    size_t imagePos = content.find("<image");
-    if (imagePos != std::string::npos) {
-        size_t sourceStart = content.find("source=\"", imagePos);
-        size_t sourceEnd = content.find("\"", sourceStart + 8);
+    layer.gids[static_cast<size_t>(y) * layer.width + x] = gid;
+    updateCollisionCell(x, y);
+    
+    if (!layer.chunks.empty()) {
+        size_t chunkIndex = static_cast<size_t>(y / CHUNK_TILES) * layer.chunksX + (x / CHUNK_TILES);
+        layer.chunks[chunkIndex].dirty = true;
         
-        if (sourceStart != std::string::npos && sourceEnd != std::string::npos) {
-            std::string source = content.substr(sourceStart + 8, sourceEnd - sourceStart - 8);
-            
-            // 构建完整图片路径
-            std::string directoryPath = filePath.substr(0, filePath.find_last_of("/\\"));
-            std::string imagePath;
-            
-            if (source.find("../") == 0) {
-                std::string parentDir = directoryPath.substr(0, directoryPath.find_last_of("/\\"));
-                imagePath = parentDir + "/" + source.substr(3);
-            } else {
-                imagePath = directoryPath + "/" + source;
-            }
-            
-            // 加载纹理
-            try {
-                Texture2D texture = ResourceManager::getInstance().loadTexture(imagePath);
-                tilesetTextures.push_back(texture);
-                tilesetFirstGids.push_back(firstGid);
-                tilesetNames.push_back(tilesetName);
-                
-                std::cout << "加载TSX图块集: " << tilesetName << " 图片: " << imagePath << std::endl;
-                return true;
-            } catch (const std::exception& e) {
-                std::cerr << "无法加载TSX图片: " << imagePath << " 错误: " << e.what() << std::endl;
-                return false;
-            }
+        // 放下的是动画图块时，该区块也要跟着帧切换重烘
+        uint32_t realGid = gid & TILE_GID_MASK;
+        if (realGid < gidAnimation.size() && gidAnimation[realGid] >= 0) {
+            addAnimatedChunk(animations[gidAnimation[realGid]], static_cast<uint32_t>(&layer - layers.data()),
+                             static_cast<uint32_t>(chunkIndex));
+        }
+    }
+}
+
+bool MapLoader::checkCollision(const Rectangle& rect) const {
+    if (tileWidth <= 0 || tileHeight <= 0 || rect.width <= 0 || rect.height <= 0) return false;
+    
+    // 只检查矩形覆盖到的格子（右/下边界为开区间）
+    int x0 = static_cast<int>(std::floor(rect.x / tileWidth));
+    int y0 = static_cast<int>(std::floor(rect.y / tileHeight));
+    int x1 = static_cast<int>(std::ceil((rect.x + rect.width) / tileWidth)) - 1;
+    int y1 = static_cast<int>(std::ceil((rect.y + rect.height) / tileHeight)) - 1;
+    
+    for (int y = std::max(y0, 0); y <= std::min(y1, height - 1); ++y) {
+        for (int x = std::max(x0, 0); x <= std::min(x1, width - 1); ++x) {
+            if (isSolidCell(x, y)) return true;
         }
     }
     
-    std::cerr << "TSX文件格式错误: 缺少image元素" << std::endl;
     return false;
 }
 
-void MapLoader::draw() {
-    for (const auto& layer : layers) {
-        if (!layer.visible) continue;
-        
-        for (const auto& tile : layer.tiles) {
-            int tilesetIndex = -1;
-            int tilesetFirstGid = 0;
-            
-            for (size_t i = 0; i < tilesetFirstGids.size(); ++i) {
-                if (tilesetFirstGids[i] <= tile.gid && 
-                    (tilesetIndex == -1 || tilesetFirstGids[i] > tilesetFirstGid)) {
-                    tilesetIndex = static_cast<int>(i);
-                    tilesetFirstGid = tilesetFirstGids[i];
-                }
+MoveResult MapLoader::moveAndSlide(const Rectangle& rect, Vector2 delta) const {
+    MoveResult result = {{rect.x, rect.y}, false, false};
+    if (tileWidth <= 0 || tileHeight <= 0) {
+        result.position.x += delta.x;
+        result.position.y += delta.y;
+        return result;
+    }
+    
+    const float tw = static_cast<float>(tileWidth);
+    const float th = static_cast<float>(tileHeight);
+    
+    // 判断某一列/行在给定跨度内是否有阻挡格
+    auto columnBlocked = [&](int col, float top, float bottom) {
+        int r0 = static_cast<int>(std::floor(top / th));
+        int r1 = static_cast<int>(std::ceil(bottom / th)) - 1;
+        for (int row = r0; row <= r1; ++row) {
+            if (isSolidCell(col, row)) return true;
+        }
+        return false;
+    };
+    auto rowBlocked = [&](int row, float left, float right) {
+        int c0 = static_cast<int>(std::floor(left / tw));
+        int c1 = static_cast<int>(std::ceil(right / tw)) - 1;
+        for (int col = c0; col <= c1; ++col) {
+            if (isSolidCell(col, row)) return true;
+        }
+        return false;
+    };
+    
+    // X 轴：依次检查前沿将要进入的每一列，不会因速度过快穿墙
+    float dx = delta.x;
+    if (dx > 0.0f) {
+        float lead = result.position.x + rect.width;
+        int c0 = static_cast<int>(std::ceil(lead / tw));
+        int c1 = static_cast<int>(std::ceil((lead + dx) / tw)) - 1;
+        for (int col = c0; col <= c1; ++col) {
+            if (columnBlocked(col, result.position.y, result.position.y + rect.height)) {
+                dx = col * tw - lead;
+                result.hitX = true;
+                break;
             }
-            
-            if (tilesetIndex != -1 && tilesetIndex < tilesetTextures.size()) {
-                int localGid = tile.gid - tilesetFirstGid;
-                Texture2D texture = tilesetTextures[tilesetIndex];
-                
-                if (tileWidth > 0 && tileHeight > 0 && texture.width > 0 && texture.height > 0) {
-                    int tilesPerRow = texture.width / tileWidth;
-                    
-                    if (tilesPerRow > 0) {
-                        int tilesetX = (localGid % tilesPerRow) * tileWidth;
-                        int tilesetY = (localGid / tilesPerRow) * tileHeight;
-                        
-                        if (tilesetX >= 0 && tilesetX + tileWidth <= texture.width &&
-                            tilesetY >= 0 && tilesetY + tileHeight <= texture.height) {
-                            
-                            Rectangle sourceRect = {static_cast<float>(tilesetX), static_cast<float>(tilesetY), 
-                                                   static_cast<float>(tileWidth), static_cast<float>(tileHeight)};
-                            
-                            DrawTextureRec(texture, sourceRect, tile.position, WHITE);
-                        }
-                    }
-                }
+        }
+    } else if (dx < 0.0f) {
+        float lead = result.position.x;
+        int c0 = static_cast<int>(std::floor(lead / tw)) - 1;
+        int c1 = static_cast<int>(std::floor((lead + dx) / tw));
+        for (int col = c0; col >= c1; --col) {
+            if (columnBlocked(col, result.position.y, result.position.y + rect.height)) {
+                dx = (col + 1) * tw - lead;
+                result.hitX = true;
+                break;
             }
         }
     }
-}
-
-bool MapLoader::checkCollision(const Rectangle& rect) const {
-    for (const auto& layer : layers) {
-        if (!layer.visible) continue;
-        
-        for (const auto& tile : layer.tiles) {
-            if (tile.isCollidable) {
-                if (CheckCollisionRecs(rect, tile.rect)) {
-                    return true;
-                }
+    result.position.x += dx;
+    
+    // Y 轴：使用已经移动过的 X 坐标，实现沿墙滑动
+    float dy = delta.y;
+    if (dy > 0.0f) {
+        float lead = result.position.y + rect.height;
+        int r0 = static_cast<int>(std::ceil(lead / th));
+        int r1 = static_cast<int>(std::ceil((lead + dy) / th)) - 1;
+        for (int row = r0; row <= r1; ++row) {
+            if (rowBlocked(row, result.position.x, result.position.x + rect.width)) {
+                dy = row * th - lead;
+                result.hitY = true;
+                break;
+            }
+        }
+    } else if (dy < 0.0f) {
+        float lead = result.position.y;
+        int r0 = static_cast<int>(std::floor(lead / th)) - 1;
+        int r1 = static_cast<int>(std::floor((lead + dy) / th));
+        for (int row = r0; row >= r1; --row) {
+            if (rowBlocked(row, result.position.x, result.position.x + rect.width)) {
+                dy = (row + 1) * th - lead;
+                result.hitY = true;
+                break;
             }
         }
     }
+    result.position.y += dy;
     
-    return false;
+    return result;
 }
 
 int MapLoader::getMapWidth() const {
@@ -535,6 +2063,10 @@ int MapLoader::getTileSize() const {
     return tileWidth;
 }
 
+int MapLoader::getTileHeight() const {
+    return tileHeight;
+}
+
 const std::vector<Layer>& MapLoader::getLayers() const {
     return layers;
 }
@@ -547,3 +2079,91 @@ const Layer* MapLoader::getLayer(const std::string& name) const {
     }
     return nullptr;
 }
+
+const std::vector<MapObject>& MapLoader::getObjects() const {
+    return objects;
+}
+
+void MapLoader::queryObjects(const Rectangle& area, std::vector<const MapObject*>& results) const {
+    std::vector<int> indices;
+    objectIndex.queryRect(area, indices);
+    for (int index : indices) results.push_back(&objects[index]);
+}
+
+void MapLoader::queryObjects(const Rectangle& area, MapObjectKind kind, std::vector<const MapObject*>& results) const {
+    std::vector<int> indices;
+    objectIndex.queryRect(area, indices);
+    for (int index : indices) {
+        if (objects[index].kind == kind) results.push_back(&objects[index]);
+    }
+}
+
+void MapLoader::queryObjectsAt(Vector2 point, std::vector<const MapObject*>& results) const {
+    std::vector<int> indices;
+    objectIndex.queryPoint(point, indices);
+    for (int index : indices) results.push_back(&objects[index]);
+}
+
+bool MapLoader::findSpawnPosition(const Rectangle& searchArea, Vector2 size, Vector2& position) const {
+    constexpr int MAX_ATTEMPTS = 16;
+    
+    float mapPixelWidth = static_cast<float>(getMapWidth());
+    float mapPixelHeight = static_cast<float>(getMapHeight());
+    
+    // 候选位置需完整落在地图内且不压到墙
+    auto accept = [&](float x, float y) {
+        if (x < 0.0f || y < 0.0f || x + size.x > mapPixelWidth || y + size.y > mapPixelHeight) return false;
+        return !checkCollision(Rectangle{x, y, size.x, size.y});
+    };
+    
+    // 出生点取自刷新流，同一世界种子得到相同的出生位置
+    Pcg32& rng = RandomService::getInstance().stream(RandomStream::SPAWNER);
+    
+    // 随机取 [minValue, maxValue] 内的一点
+    auto randomIn = [&rng](float minValue, float maxValue) {
+        if (maxValue <= minValue) return minValue;
+        return rng.nextFloat(minValue, maxValue);
+    };
+    
+    std::vector<const MapObject*> zones;
+    queryObjects(searchArea, MapObjectKind::SPAWN_ZONE, zones);
+    
+    if (!zones.empty()) {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+            const MapObject* zone = zones[rng.nextInt(0, static_cast<int>(zones.size()) - 1)];
+            
+            // 点状出生点以该点为中心，区域出生点在区域内随机
+            float x, y;
+            if (zone->isPoint()) {
+                x = zone->bounds.x - size.x * 0.5f;
+                y = zone->bounds.y - size.y * 0.5f;
+            } else {
+                x = randomIn(zone->bounds.x, zone->bounds.x + zone->bounds.width - size.x);
+                y = randomIn(zone->bounds.y, zone->bounds.y + zone->bounds.height - size.y);
+            }
+            
+            if (accept(x, y)) {
+                position = {x, y};
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // 附近没有出生区域：在搜索范围与地图的交集内随机取点
+    float minX = std::max(searchArea.x, 0.0f);
+    float minY = std::max(searchArea.y, 0.0f);
+    float maxX = std::min(searchArea.x + searchArea.width, mapPixelWidth) - size.x;
+    float maxY = std::min(searchArea.y + searchArea.height, mapPixelHeight) - size.y;
+    if (maxX < minX || maxY < minY) return false;
+    
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        float x = randomIn(minX, maxX);
+        float y = randomIn(minY, maxY);
+        if (accept(x, y)) {
+            position = {x, y};
+            return true;
+        }
+    }
+    return false;
+}
@@ -3,47 +3,226 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <utility>
 #include <raylib.h>
-#include <rapidjson/document.h>
-#include <rapidjson/istreamwrapper.h>
 #include <fstream>
 #include <sstream>
 #include <regex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include "MappedFile.hpp"
+#include "TileDataDecoder.hpp"
+#include "ChunkStreamer.hpp"
+#include "MapObjectIndex.hpp"
+#include "FileWatcher.hpp"
 
-// 图块结构
-struct Tile {
-    int id;
-    int gid;
-    bool isCollidable;
-    Vector2 position;
-    Rectangle rect;
+class XmlReader;
+
+// Tiled 图块翻转标志位（保存在 gid 的高 4 位）
+constexpr uint32_t FLIPPED_HORIZONTALLY_FLAG = 0x80000000u;
+constexpr uint32_t FLIPPED_VERTICALLY_FLAG = 0x40000000u;
+constexpr uint32_t FLIPPED_DIAGONALLY_FLAG = 0x20000000u;
+constexpr uint32_t ROTATED_HEXAGONAL_120_FLAG = 0x10000000u;
+constexpr uint32_t TILE_GID_MASK = 0x0FFFFFFFu;
+
+// gid 查找表项：加载时按图块集预先算好纹理与源矩形
+struct TileDrawInfo {
+    Texture2D texture;   // 所属图块集纹理，id 为 0 表示无效 gid
+    Rectangle source;    // 在图块集中的源矩形
+};
+
+// 图块动画帧（Tiled <animation> 中的 <frame>）
+struct TileAnimationFrame {
+    uint32_t gid;        // 该帧显示的图块
+    uint32_t duration;   // 持续时间（毫秒）
+};
+
+// 图块动画：同一图块集的动画共用一个时钟
+// 帧切换时只改写查找表中该 gid 的源矩形，并把含有它的已烘焙区块标脏
+struct TileAnimation {
+    uint32_t gid;                     // 被动画的图块
+    int tileset;                      // 所属图块集（决定使用哪个时钟）
+    uint32_t firstFrame;              // 在帧表中的起点
+    uint32_t frameCount;
+    uint32_t duration;                // 一轮总时长（毫秒）
+    uint32_t currentFrame;
+    std::vector<std::pair<uint32_t, uint32_t>> chunks;  // 含有该图块的 (图层, 区块) 下标
+};
+
+// 扫掠移动结果
+struct MoveResult {
+    Vector2 position;    // 移动后的左上角位置
+    bool hitX;           // 水平方向被阻挡
+    bool hitY;           // 垂直方向被阻挡
+};
+
+// 图块区块：静态图层按固定大小切分，预先烘焙到 RenderTexture
+struct TileChunk {
+    int chunkX;                       // 区块坐标（以区块为单位）
+    int chunkY;
+    RenderTexture2D texture;          // 烘焙结果，id 为 0 表示尚未创建
+    bool dirty;                       // 需要重新烘焙
+};
+
+// 无限地图的数据区块（Tiled <chunk>），按与相机的距离流式解码
+struct StreamChunk {
+    int x = 0;                        // 左上角图块坐标（已平移到地图原点）
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    size_t dataOffset = 0;            // 编码数据在源文件中的位置
+    size_t dataLength = 0;
+    std::vector<uint32_t> gids;       // 已解码数据，未驻留时为空
+    bool resident = false;
+    bool pending = false;             // 已提交给后台线程
+    uint64_t lastUsedFrame = 0;       // 最近一次位于保留范围内的帧
 };
 
 // 图层结构
 struct Layer {
     std::string name;
-    int width;
-    int height;
-    std::vector<Tile> tiles;
-    bool visible;
-    float opacity;
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> gids;       // width*height 的稠密数组，保留翻转标志位，0 表示空
+    const uint32_t* mappedGids = nullptr; // 二进制地图直接指向内存映射，第一次修改时才复制到 gids
+    bool visible = true;
+    float opacity = 1.0f;
+    
+    // 无限地图：数据按区块流式加载，gids 为空
+    bool streamed = false;
+    TileEncoding streamEncoding = TileEncoding::CSV;
+    TileCompression streamCompression = TileCompression::NONE;
+    int streamChunkWidth = 0;         // 区块尺寸（图块数）
+    int streamChunkHeight = 0;
+    int streamGridX = 0;              // 区块网格尺寸
+    int streamGridY = 0;
+    std::vector<int> streamGrid;      // 网格 -> streamChunks 下标，-1 表示该处没有数据
+    std::vector<StreamChunk> streamChunks;
+    
+    // 图块数据起点（width*height 个 gid），流式图层没有连续数据
+    const uint32_t* tileData() const { return mappedGids ? mappedGids : gids.data(); }
+    
+    // 流式图层中包含 (x, y) 的区块，没有时返回 nullptr
+    const StreamChunk* findStreamChunk(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height || streamChunkWidth <= 0 || streamChunkHeight <= 0) return nullptr;
+        int index = streamGrid[(y / streamChunkHeight) * streamGridX + (x / streamChunkWidth)];
+        return index < 0 ? nullptr : &streamChunks[index];
+    }
+    
+    // 获取图块 gid（含翻转标志位），越界或区块未驻留返回 0
+    uint32_t getGid(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+        if (streamed) {
+            const StreamChunk* chunk = findStreamChunk(x, y);
+            if (!chunk || !chunk->resident) return 0;
+            return chunk->gids[static_cast<size_t>(y - chunk->y) * chunk->width + (x - chunk->x)];
+        }
+        return tileData()[static_cast<size_t>(y) * width + x];
+    }
+    
+    // 区块缓存
+    int chunksX = 0;
+    int chunksY = 0;
+    std::vector<TileChunk> chunks;
+};
+
+// 异步加载状态
+enum class MapLoadState {
+    IDLE,        // 未开始
+    LOADING,     // 工作线程解析地图、解码图块集图片
+    UPLOADING,   // 主线程逐帧上传纹理
+    READY,       // 加载完成
+    FAILED       // 所有候选路径都加载失败
 };
 
 // 地图解析器类
 class MapLoader {
 public:
-    // 构造函数
+    // 每个区块的边长（图块数）
+    static constexpr int CHUNK_TILES = 16;
+    
+    // 无限地图预加载范围：视野外扩的图块数
+    static constexpr int STREAM_MARGIN_TILES = 16;
+    
+    // 构造函数和析构函数
     MapLoader();
+    ~MapLoader();
     
-    // 加载地图
+    // 区块纹理由 MapLoader 持有，禁止拷贝
+    MapLoader(const MapLoader&) = delete;
+    MapLoader& operator=(const MapLoader&) = delete;
+    
+    // 加载地图（.tmx / .json / 预编译的 .mbin）
     bool loadMap(const std::string& filePath);
     
+    // 是否加载图块集纹理，离线工具关闭后无需图形上下文即可解析地图
+    void setTextureLoading(bool enabled);
+    
+    // 异步加载：依次尝试候选路径，解析地图和解码图片都在工作线程完成
+    bool startAsyncLoad(const std::vector<std::string>& candidatePaths);
+    
+    // 每帧在主线程调用，最多上传 maxUploads 张纹理，返回当前状态
+    MapLoadState updateAsyncLoad(int maxUploads = 1);
+    
+    // 异步加载进度 [0, 1]
+    float getLoadProgress() const;
+    
+    // 实际加载成功的路径
+    const std::string& getLoadedPath() const;
+    
+    // 无限地图：按相机视野（外扩 STREAM_MARGIN_TILES）调度区块解码与淘汰，每帧在主线程调用
+    void updateStreaming(const Camera2D& camera);
+    void updateStreaming(const Rectangle& keepArea);
+    
+    // 已解码区块的内存预算（字节），超出时淘汰最久未用的区块
+    void setStreamingBudget(size_t bytes);
+    size_t getResidentChunkBytes() const;
+    
+    // 是否为 Tiled 无限地图
+    bool isInfinite() const;
+    
+    // 热重载：监视已加载的 .tmx/.json 及其引用的 .tsx，保存后在后台重新解析，
+    // 与当前地图逐图层比较 gid，只更新变化的碰撞格子和区块
+    bool enableHotReload();
+    
+    // 每帧在主线程调用，返回 true 表示本帧应用了一次重载
+    bool updateHotReload();
+    
+    // 最近一次重载中碰撞发生变化的图块范围（闭区间），没有变化返回 false
+    bool getReloadCollisionBounds(int& x0, int& y0, int& x1, int& y1) const;
+    
+    // 保存为预编译二进制格式（.mbin）
+    bool saveBinary(const std::string& filePath) const;
+    
+    // 烘焙所有脏区块（需在 BeginMode2D 之外调用，BeginTextureMode 会重置相机矩阵）
+    void bakeDirtyChunks();
+    
+    // 只烘焙与相机视野相交的脏区块，视野外的留到进入视野时再烘焙
+    void bakeDirtyChunks(const Camera2D& camera);
+    
+    // 推进各图块集的动画时钟，每帧在主线程调用；开销只与动画种类数有关，与地图大小无关
+    void updateAnimations(float deltaTime);
+    
     // 绘制地图
     void draw();
     
-    // 检查碰撞
+    // 只绘制与相机视野相交的图块范围
+    void draw(const Camera2D& camera);
+    
+    // 修改图块，所在区块会在下一次 bakeDirtyChunks() 时重新烘焙
+    bool setTile(const std::string& layerName, int x, int y, uint32_t gid);
+    
+    // 检查碰撞（只查询矩形覆盖到的格子）
     bool checkCollision(const Rectangle& rect) const;
     
+    // 检查格子是否阻挡，地图外视为可通行（边界由 checkBoundaries 处理）
+    bool isSolidCell(int x, int y) const;
+    
+    // 扫掠 AABB：先沿 X 后沿 Y 移动 delta，撞墙时贴墙停下并沿另一轴滑动
+    MoveResult moveAndSlide(const Rectangle& rect, Vector2 delta) const;
+    
     // 获取地图宽度（像素）
     int getMapWidth() const;
     
@@ -53,29 +232,112 @@ public:
     // 获取图块大小
     int getTileSize() const;
     
+    // 获取图块高度（getTileSize 返回的是宽度）
+    int getTileHeight() const;
+    
     // 获取所有图层
     const std::vector<Layer>& getLayers() const;
     
     // 获取指定名称的图层
     const Layer* getLayer(const std::string& name) const;
     
+    // 对象层中的所有对象（出生区域、触发器、兴趣点等）
+    const std::vector<MapObject>& getObjects() const;
+    
+    // 与矩形相交的对象（追加到 results）
+    void queryObjects(const Rectangle& area, std::vector<const MapObject*>& results) const;
+    
+    // 与矩形相交且用途为 kind 的对象（追加到 results）
+    void queryObjects(const Rectangle& area, MapObjectKind kind, std::vector<const MapObject*>& results) const;
+    
+    // 包含该点的对象（追加到 results）
+    void queryObjectsAt(Vector2 point, std::vector<const MapObject*>& results) const;
+    
+    // 在 searchArea 附近的出生区域里找一个放得下 size 且不与墙体重叠的位置
+    // 范围内没有出生区域时退回在 searchArea 内随机取点；找不到返回 false
+    bool findSpawnPosition(const Rectangle& searchArea, Vector2 size, Vector2& position) const;
+    
 private:
     // 解析地图数据
     bool parseMapData(const std::string& jsonData);
     
-    // 解析图层数据
-    bool parseLayers(const rapidjson::Value& layersArray);
+    // 按扩展名解析地图文件并生成碰撞数据，不访问 GPU，可在工作线程调用
+    bool parseMapFile(const std::string& filePath);
+    
+    // 清空上一次解析留下的地图数据（图层、图块集、动画、碰撞和对象），不访问 GPU
+    // 已烘焙的区块纹理需先在主线程释放
+    void resetMapData();
+    
+    // JSON格式支持
+    bool loadJSON(const std::string& filePath);
+    
+    // 工作线程入口
+    void asyncLoadWorker(std::vector<std::string> candidatePaths);
+    
+    // 无限地图：读取 <data> 下的 <chunk> 索引（不解码），全部图层读完后统一平移到原点
+    void parseStreamChunks(XmlReader& reader, Layer& layer);
+    
+    // 读取 <objectgroup> 中的对象
+    void parseObjectGroup(XmlReader& reader);
+    void finalizeStreamedLayers();
+    void onChunkResident(Layer& layer, StreamChunk& chunk);
+    void evictChunk(StreamChunk& chunk);
+    
+    // 热重载：工作线程解析到独立的 MapLoader，主线程比较后把差异应用到当前地图
+    void reloadWorker(std::string filePath);
+    bool applyReload(MapLoader& source);
+    
+    // 修改非流式图层的一个图块，并更新碰撞位和所在区块
+    void applyTileChange(Layer& layer, int x, int y, uint32_t gid);
     
-    // 解析图块集数据
-    bool parseTilesets(const rapidjson::Value& tilesetsArray, const std::string& mapFilePath);
+    // 相机视野在世界坐标中的包围盒
+    Rectangle getCameraBounds(const Camera2D& camera) const;
+    
+    // 预编译二进制格式，图层数据直接使用内存映射
+    bool loadBinary(const std::string& filePath);
+    
+    // 登记图块集；关闭纹理加载时只记录图片路径
+    bool registerTileset(int firstGid, const std::string& name, const std::string& imagePath, bool usePlaceholder);
+    
+    // 登记图块集中的一段动画，帧的 gid 为全局 gid
+    void addTileAnimation(int tileset, uint32_t gid, const TileAnimationFrame* frames, size_t frameCount);
     
     // TMX格式支持
     bool loadTMX(const std::string& filePath);
     bool loadTSX(const std::string& filePath, int firstGid);
     
-    // 辅助函数：解析TMX文件内容
-    bool parseTMXContent(const std::string& content, const std::string& filePath);
-    bool parseTSXContent(const std::string& content, int firstGid, const std::string& filePath);
+    // 辅助函数：从 <tileset> / <layer> 开始标签读到对应的结束标签
+    bool parseTilesetElement(XmlReader& reader, int firstGid, const std::string& directory,
+                             const std::string& defaultName);
+    bool parseLayerElement(XmlReader& reader, std::vector<unsigned char>& decodeScratch);
+    
+    // 构建 gid -> 纹理/源矩形查找表
+    void buildTileLookup();
+    
+    // 查找表建好后记下每一帧的源矩形，并把动画图块重定向到当前帧
+    void resolveAnimations();
+    void applyAnimationFrame(const TileAnimation& animation);
+    
+    // 区块建好后记录每种动画图块出现在哪些区块中
+    void collectAnimatedChunks();
+    void addAnimatedChunk(TileAnimation& animation, uint32_t layerIndex, uint32_t chunkIndex);
+    
+    // 碰撞网格
+    void buildCollidableLookup();
+    void buildCollisionGrid();
+    void updateCollisionCell(int x, int y);
+    
+    // 区块缓存
+    void buildChunks();
+    bool bakeChunk(const Layer& layer, TileChunk& chunk);
+    void bakeDirtyRegion(int x0, int y0, int x1, int y1);
+    void releaseChunks(Layer& layer);
+    
+    // 绘制图块范围 [x0, x1) x [y0, y1)
+    void drawRegion(int x0, int y0, int x1, int y1) const;
+    
+    // 绘制单个图块
+    void drawTile(uint32_t gid, Vector2 position) const;
     
     // 地图属性
     int width;          // 地图宽度（图块数）
@@ -92,6 +354,60 @@ private:
     std::vector<Texture2D> tilesetTextures;
     std::vector<int> tilesetFirstGids;
     std::vector<std::string> tilesetNames;
+    std::vector<std::string> tilesetImagePaths;
+    bool textureLoading;
+    
+    // 以去掉翻转标志位的 gid 为下标的查找表
+    std::vector<TileDrawInfo> tileLookup;
+    
+    // 图块动画：动画表与帧表紧凑存放，时钟按图块集划分（毫秒）
+    std::vector<TileAnimation> animations;
+    std::vector<TileAnimationFrame> animationFrames;
+    std::vector<TileDrawInfo> animationFrameInfo;   // 与 animationFrames 下标对应
+    std::vector<int> gidAnimation;                  // gid -> animations 下标，-1 表示不是动画图块
+    std::vector<double> tilesetClocks;
+    
+    // 碰撞数据：图块集中标记为 collides 的 gid，以及按格子打包的位图（width*height 位）
+    std::vector<int> collidableGids;
+    std::vector<bool> gidCollides;
+    std::vector<uint64_t> collisionBits;
+    
+    // 对象层数据及其网格索引
+    std::vector<MapObject> objects;
+    MapObjectIndex objectIndex;
+    
+    // 二进制地图的内存映射，图层的 mappedGids 指向这里
+    MappedFile mappedFile;
+    
+    // 异步加载：工作线程写完数据后才把状态切到 UPLOADING，主线程据此接管
+    std::thread loadThread;
+    std::atomic<MapLoadState> loadState;
+    std::atomic<float> loadProgress;
+    std::vector<Image> pendingImages;   // 与 tilesetTextures 下标对应，等待上传
+    size_t uploadedImages;
+    std::string loadedPath;
+    
+    // 无限地图流式加载（源文件保持映射在 mappedFile 中）
+    bool infinite;
+    int originTileX;                    // 最左上区块的图块坐标，地图整体平移了这么多
+    int originTileY;
+    ChunkStreamer chunkStreamer;
+    size_t streamingBudget;
+    size_t residentChunkBytes;
+    uint64_t streamFrame;
+    
+    // 热重载
+    std::vector<std::string> tilesetSourcePaths;   // 引用的外部 .tsx
+    FileWatcher fileWatcher;
+    bool hotReloadEnabled;
+    std::thread reloadThread;
+    std::atomic<bool> reloadDone;
+    bool reloadRunning;
+    bool reloadQueued;                              // 解析期间又有修改，结束后再来一次
+    bool reloadParsed;
+    std::unique_ptr<MapLoader> reloadSource;
+    bool reloadCollisionChanged;
+    int reloadX0, reloadY0, reloadX1, reloadY1;
 };
 
 #endif // MAPLOADER_HPP
@@ -0,0 +1,138 @@
+#include "MapObjectIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+
+MapObjectKind MapObject::kindFromType(const std::string& type, bool isPoint) {
+    std::string lower = type;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "spawn" || lower == "spawn_zone" || lower == "spawnzone") return MapObjectKind::SPAWN_ZONE;
+    if (lower == "trigger") return MapObjectKind::TRIGGER;
+    if (lower == "poi" || lower == "point_of_interest") return MapObjectKind::POINT_OF_INTEREST;
+
+    // 未标注类型的点对象多用作标记
+    if (lower.empty() && isPoint) return MapObjectKind::POINT_OF_INTEREST;
+    return MapObjectKind::OTHER;
+}
+
+// 闭区间相交，保证宽高为 0 的点对象也能被矩形查询命中
+static bool overlaps(const Rectangle& a, const Rectangle& b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+           a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+MapObjectIndex::MapObjectIndex()
+    : objects(nullptr), cellSize(DEFAULT_CELL_SIZE), originX(0.0f), originY(0.0f),
+      gridWidth(0), gridHeight(0), queryStamp(0) {
+}
+
+void MapObjectIndex::clear() {
+    objects = nullptr;
+    gridWidth = 0;
+    gridHeight = 0;
+    cellStart.clear();
+    cellItems.clear();
+    visitedStamp.clear();
+    queryStamp = 0;
+}
+
+void MapObjectIndex::build(const std::vector<MapObject>& source, float size) {
+    clear();
+    if (source.empty() || size <= 0.0f) return;
+
+    objects = &source;
+    cellSize = size;
+
+    // 网格覆盖所有对象的包围盒
+    float minX = source[0].bounds.x, minY = source[0].bounds.y;
+    float maxX = minX, maxY = minY;
+    for (const auto& object : source) {
+        minX = std::min(minX, object.bounds.x);
+        minY = std::min(minY, object.bounds.y);
+        maxX = std::max(maxX, object.bounds.x + object.bounds.width);
+        maxY = std::max(maxY, object.bounds.y + object.bounds.height);
+    }
+
+    originX = minX;
+    originY = minY;
+    gridWidth = static_cast<int>((maxX - minX) / cellSize) + 1;
+    gridHeight = static_cast<int>((maxY - minY) / cellSize) + 1;
+
+    // 两遍：先统计每个格子的对象数，再按前缀和填入
+    size_t cellCount = static_cast<size_t>(gridWidth) * gridHeight;
+    cellStart.assign(cellCount + 1, 0);
+
+    for (const auto& object : source) {
+        int x0, y0, x1, y1;
+        cellRange(object.bounds, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                cellStart[static_cast<size_t>(y) * gridWidth + x + 1]++;
+            }
+        }
+    }
+    for (size_t i = 1; i <= cellCount; ++i) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    cellItems.resize(cellStart[cellCount]);
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < source.size(); ++i) {
+        int x0, y0, x1, y1;
+        cellRange(source[i].bounds, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                cellItems[cursor[static_cast<size_t>(y) * gridWidth + x]++] = static_cast<int>(i);
+            }
+        }
+    }
+
+    visitedStamp.assign(source.size(), 0);
+}
+
+bool MapObjectIndex::cellRange(const Rectangle& area, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = static_cast<int>(std::floor((area.x - originX) / cellSize));
+    y0 = static_cast<int>(std::floor((area.y - originY) / cellSize));
+    x1 = static_cast<int>(std::floor((area.x + area.width - originX) / cellSize));
+    y1 = static_cast<int>(std::floor((area.y + area.height - originY) / cellSize));
+
+    if (x1 < 0 || y1 < 0 || x0 >= gridWidth || y0 >= gridHeight) return false;
+
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, gridWidth - 1);
+    y1 = std::min(y1, gridHeight - 1);
+    return true;
+}
+
+void MapObjectIndex::queryRect(const Rectangle& area, std::vector<int>& results) const {
+    if (!objects || cellStart.empty()) return;
+
+    int x0, y0, x1, y1;
+    if (!cellRange(area, x0, y0, x1, y1)) return;
+
+    // 计数器回绕时清零，避免旧标记误判
+    if (++queryStamp == 0) {
+        std::fill(visitedStamp.begin(), visitedStamp.end(), 0u);
+        queryStamp = 1;
+    }
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            size_t cell = static_cast<size_t>(y) * gridWidth + x;
+            for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                int index = cellItems[i];
+                if (visitedStamp[index] == queryStamp) continue;
+                visitedStamp[index] = queryStamp;
+
+                if (overlaps((*objects)[index].bounds, area)) results.push_back(index);
+            }
+        }
+    }
+}
+
+void MapObjectIndex::queryPoint(Vector2 point, std::vector<int>& results) const {
+    queryRect(Rectangle{point.x, point.y, 0.0f, 0.0f}, results);
+}
@@ -0,0 +1,68 @@
+#ifndef MAPOBJECTINDEX_HPP
+#define MAPOBJECTINDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <raylib.h>
+
+// 对象层中对象的用途（由 Tiled 对象的 type/class 决定）
+enum class MapObjectKind {
+    SPAWN_ZONE,          // 猫咪出生区域："spawn" / "spawn_zone"
+    TRIGGER,             // 触发区域："trigger"
+    POINT_OF_INTEREST,   // 兴趣点："poi"，未标注类型的点对象也归为此类
+    OTHER
+};
+
+// 对象层中的一个对象，多边形/折线/椭圆按包围盒处理，点对象宽高为 0
+struct MapObject {
+    std::string name;
+    std::string type;
+    MapObjectKind kind = MapObjectKind::OTHER;
+    Rectangle bounds = {0.0f, 0.0f, 0.0f, 0.0f};   // 世界坐标（像素）
+
+    bool isPoint() const { return bounds.width <= 0.0f && bounds.height <= 0.0f; }
+
+    // 根据 type 字符串推断用途
+    static MapObjectKind kindFromType(const std::string& type, bool isPoint);
+};
+
+// 对象的均匀网格索引
+// 对象只在加载时建立一次，按格子连续存放（类似 CSR），查询只访问与范围重叠的格子
+class MapObjectIndex {
+public:
+    // 默认格子边长（像素）
+    static constexpr float DEFAULT_CELL_SIZE = 256.0f;
+
+    MapObjectIndex();
+
+    // 重新建立索引，objects 在索引使用期间需保持不变
+    void build(const std::vector<MapObject>& objects, float cellSize = DEFAULT_CELL_SIZE);
+
+    void clear();
+
+    // 与矩形相交的对象下标（追加到 results，不重复）
+    void queryRect(const Rectangle& area, std::vector<int>& results) const;
+
+    // 包含该点的对象下标（追加到 results，不重复）
+    void queryPoint(Vector2 point, std::vector<int>& results) const;
+
+private:
+    // 计算矩形覆盖的格子范围，完全在索引外时返回 false
+    bool cellRange(const Rectangle& area, int& x0, int& y0, int& x1, int& y1) const;
+
+    const std::vector<MapObject>* objects;
+    float cellSize;
+    float originX;                    // 网格左上角（世界坐标）
+    float originY;
+    int gridWidth;
+    int gridHeight;
+    std::vector<uint32_t> cellStart;  // 每个格子在 cellItems 中的起点，长度为格子数 + 1
+    std::vector<int> cellItems;       // 按格子排列的对象下标
+
+    // 跨格子的对象只返回一次：每次查询递增 queryStamp，对象访问时记录
+    mutable std::vector<uint32_t> visitedStamp;
+    mutable uint32_t queryStamp;
+};
+
+#endif // MAPOBJECTINDEX_HPP
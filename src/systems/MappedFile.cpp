@@ -0,0 +1,73 @@
+#include "MappedFile.hpp"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__) || defined(__EMSCRIPTEN__)
+#define MAPPEDFILE_USE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filePath) {
+    close();
+    
+#ifdef MAPPEDFILE_USE_MMAP
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // 映射建立后即可关闭描述符
+    if (address != MAP_FAILED) {
+        data_ = static_cast<const unsigned char*>(address);
+        size_ = static_cast<size_t>(info.st_size);
+        mapped = true;
+        return true;
+    }
+#endif
+    
+    // 退回普通读取
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return false;
+    
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (length <= 0) return false;
+    
+    fallback.resize(static_cast<size_t>(length));
+    if (!file.read(reinterpret_cast<char*>(fallback.data()), length)) {
+        fallback.clear();
+        return false;
+    }
+    
+    data_ = fallback.data();
+    size_ = fallback.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef MAPPEDFILE_USE_MMAP
+    if (mapped && data_) {
+        munmap(const_cast<unsigned char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped = false;
+    fallback.clear();
+    fallback.shrink_to_fit();
+}
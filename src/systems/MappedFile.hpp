@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// 只读内存映射文件
+// POSIX 平台使用 mmap(MAP_PRIVATE)，其他平台退回一次性读入内存
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    // 映射区域由对象独占，禁止拷贝
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    // 打开并映射文件，已打开的文件会先被关闭
+    bool open(const std::string& filePath);
+    void close();
+    
+    bool isOpen() const { return data_ != nullptr; }
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+private:
+    const unsigned char* data_;
+    size_t size_;
+    bool mapped;                          // true 表示 data_ 来自 mmap，需要 munmap
+    std::vector<unsigned char> fallback;  // 不支持 mmap 时的文件内容
+};
+
+#endif // MAPPEDFILE_HPP
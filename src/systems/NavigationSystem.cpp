@@ -0,0 +1,482 @@
+#include "NavigationSystem.hpp"
+#include "MapLoader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// 每个目标的路径树最多记录的格子数，超过后不再写入
+static constexpr size_t MAX_CACHED_CELLS_PER_GOAL = 8192;
+
+static constexpr float DIAGONAL_COST = 1.41421356f;
+
+NavigationSystem::NavigationSystem()
+    : map(nullptr), agentSize({0.0f, 0.0f}), gridWidth(0), gridHeight(0),
+      tileWidth(0), tileHeight(0), nextId(1), frame(0),
+      frameBudget(DEFAULT_FRAME_BUDGET), stepsLastFrame(0) {
+}
+
+void NavigationSystem::build(const MapLoader& source, Vector2 size) {
+    map = &source;
+    agentSize = size;
+    tileWidth = source.getTileSize();
+    tileHeight = source.getTileHeight();
+    gridWidth = tileWidth > 0 ? source.getMapWidth() / tileWidth : 0;
+    gridHeight = tileHeight > 0 ? source.getMapHeight() / tileHeight : 0;
+
+    walkable.assign(static_cast<size_t>(std::max(gridWidth, 0)) * std::max(gridHeight, 0), 0);
+    if (gridWidth > 0 && gridHeight > 0) {
+        refreshCells(0, 0, gridWidth - 1, gridHeight - 1);
+    }
+
+    std::cout << "寻路网格: " << gridWidth << "x" << gridHeight << " 代理尺寸: "
+              << agentSize.x << "x" << agentSize.y << std::endl;
+}
+
+void NavigationSystem::refreshCells(int x0, int y0, int x1, int y1) {
+    if (!map || !isReady()) return;
+
+    // 代理比格子大时，墙体变化会影响周围几格的可通行性
+    int padX = static_cast<int>(std::ceil(agentSize.x * 0.5f / tileWidth));
+    int padY = static_cast<int>(std::ceil(agentSize.y * 0.5f / tileHeight));
+    x0 = std::max(x0 - padX, 0);
+    y0 = std::max(y0 - padY, 0);
+    x1 = std::min(x1 + padX, gridWidth - 1);
+    y1 = std::min(y1 + padY, gridHeight - 1);
+
+    // 代理矩形以格子中心对齐，不与墙重叠才算可通行
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            Vector2 center = cellCenter(cellIndex(x, y));
+            Rectangle rect = {center.x - agentSize.x * 0.5f, center.y - agentSize.y * 0.5f, agentSize.x, agentSize.y};
+            walkable[cellIndex(x, y)] = map->checkCollision(rect) ? 0 : 1;
+        }
+    }
+
+    // 旧路径可能穿过新出现的墙：清空缓存，进行中的搜索从头开始
+    cache.clear();
+    for (auto& search : queue) {
+        search.started = false;
+        search.steps = 0;
+        search.open.clear();
+        search.nodes.clear();
+    }
+}
+
+bool NavigationSystem::isWalkable(int x, int y) const {
+    return walkableAt(x, y);
+}
+
+bool NavigationSystem::walkableAt(int x, int y) const {
+    if (x < 0 || y < 0 || x >= gridWidth || y >= gridHeight) return false;
+    return walkable[cellIndex(x, y)] != 0;
+}
+
+int NavigationSystem::worldToCell(Vector2 point) const {
+    int x = static_cast<int>(std::floor(point.x / tileWidth));
+    int y = static_cast<int>(std::floor(point.y / tileHeight));
+    x = std::clamp(x, 0, gridWidth - 1);
+    y = std::clamp(y, 0, gridHeight - 1);
+    return cellIndex(x, y);
+}
+
+int NavigationSystem::nearestWalkable(int cell) const {
+    int cx = cell % gridWidth;
+    int cy = cell / gridWidth;
+    if (walkableAt(cx, cy)) return cell;
+
+    // 代理比图块大时，贴墙站立的位置所在格子可能不可通行，就近找一个
+    constexpr int MAX_RADIUS = 3;
+    for (int radius = 1; radius <= MAX_RADIUS; ++radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (std::abs(dx) != radius && std::abs(dy) != radius) continue;
+                if (walkableAt(cx + dx, cy + dy)) return cellIndex(cx + dx, cy + dy);
+            }
+        }
+    }
+    return -1;
+}
+
+Vector2 NavigationSystem::cellCenter(int cell) const {
+    return {(static_cast<float>(cell % gridWidth) + 0.5f) * tileWidth,
+            (static_cast<float>(cell / gridWidth) + 0.5f) * tileHeight};
+}
+
+float NavigationSystem::heuristic(int a, int b) const {
+    // 八方向距离（octile）
+    int dx = std::abs(a % gridWidth - b % gridWidth);
+    int dy = std::abs(a / gridWidth - b / gridWidth);
+    return static_cast<float>(std::max(dx, dy)) + (DIAGONAL_COST - 1.0f) * static_cast<float>(std::min(dx, dy));
+}
+
+NavigationSystem::RequestId NavigationSystem::requestPath(Vector2 from, Vector2 to) {
+    RequestId id = nextId++;
+    if (nextId == 0) nextId = 1;
+
+    int start = isReady() ? nearestWalkable(worldToCell(from)) : -1;
+    int goal = isReady() ? nearestWalkable(worldToCell(to)) : -1;
+    if (start < 0 || goal < 0) {
+        results[id] = Result{PathStatus::FAILED, {}};
+        return id;
+    }
+
+    // 命中路径缓存时不用排队
+    Result result{PathStatus::FOUND, {}};
+    if (lookupCache(start, goal, result.waypoints)) {
+        results[id] = std::move(result);
+        return id;
+    }
+
+    Search search;
+    search.id = id;
+    search.start = start;
+    search.goal = goal;
+    search.steps = 0;
+    search.started = false;
+    queue.push_back(std::move(search));
+    return id;
+}
+
+PathStatus NavigationSystem::getStatus(RequestId id) const {
+    auto it = results.find(id);
+    if (it != results.end()) return it->second.status;
+
+    for (const auto& search : queue) {
+        if (search.id == id) return PathStatus::PENDING;
+    }
+    return PathStatus::NONE;
+}
+
+bool NavigationSystem::takePath(RequestId id, std::vector<Vector2>& waypoints) {
+    auto it = results.find(id);
+    if (it == results.end() || it->second.status != PathStatus::FOUND) return false;
+
+    waypoints = std::move(it->second.waypoints);
+    results.erase(it);
+    return true;
+}
+
+void NavigationSystem::cancel(RequestId id) {
+    if (id == 0) return;
+    results.erase(id);
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [id](const Search& search) { return search.id == id; }),
+                queue.end());
+}
+
+void NavigationSystem::update() {
+    frame++;
+
+    // 所有请求共用本帧预算，按提交顺序推进；没做完的留在队首下帧继续
+    int budget = frameBudget;
+    while (budget > 0 && !queue.empty()) {
+        Search& search = queue.front();
+
+        // 排队期间可能已有同目标的搜索完成，先查缓存
+        if (!search.started) {
+            Result result{PathStatus::FOUND, {}};
+            if (lookupCache(search.start, search.goal, result.waypoints)) {
+                results[search.id] = std::move(result);
+                queue.pop_front();
+                continue;
+            }
+        }
+
+        if (stepSearch(search, budget)) {
+            queue.pop_front();
+        }
+    }
+    stepsLastFrame = frameBudget - budget;
+}
+
+void NavigationSystem::pushOpen(Search& search, int cell, float g, int parent) {
+    auto it = search.nodes.find(cell);
+    if (it != search.nodes.end()) {
+        if (it->second.closed || g >= it->second.g) return;
+        it->second.g = g;
+        it->second.parent = parent;
+    } else {
+        search.nodes.emplace(cell, Node{g, parent, false});
+    }
+
+    // 惰性删除：同一格子可能在堆里出现多次，出堆时跳过过期项
+    search.open.push_back(OpenEntry{g + heuristic(cell, search.goal), cell});
+    std::push_heap(search.open.begin(), search.open.end(),
+                   [](const OpenEntry& a, const OpenEntry& b) { return a.f > b.f; });
+}
+
+bool NavigationSystem::stepSearch(Search& search, int& budget) {
+    auto greater = [](const OpenEntry& a, const OpenEntry& b) { return a.f > b.f; };
+
+    if (!search.started) {
+        search.started = true;
+        pushOpen(search, search.start, 0.0f, -1);
+    }
+
+    while (budget > 0) {
+        if (search.open.empty()) {
+            finishSearch(search, false);
+            return true;
+        }
+
+        std::pop_heap(search.open.begin(), search.open.end(), greater);
+        OpenEntry entry = search.open.back();
+        search.open.pop_back();
+
+        Node& node = search.nodes[entry.cell];
+        if (node.closed) continue;
+        node.closed = true;
+
+        if (entry.cell == search.goal) {
+            finishSearch(search, true);
+            return true;
+        }
+
+        int steps = 1;
+        expandNode(search, entry.cell, steps);
+        budget -= steps;
+        search.steps += steps;
+
+        if (search.steps > MAX_SEARCH_STEPS) {
+            finishSearch(search, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+void NavigationSystem::expandNode(Search& search, int cell, int& steps) {
+    const Node node = search.nodes[cell];
+    int x = cell % gridWidth;
+    int y = cell / gridWidth;
+
+    // 剪枝后的邻居方向（不切墙角的 JPS 规则）
+    int directions[8][2];
+    int count = 0;
+    auto add = [&](int dx, int dy) {
+        directions[count][0] = dx;
+        directions[count][1] = dy;
+        count++;
+    };
+
+    if (node.parent < 0) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+                if (dx != 0 && dy != 0 && !(walkableAt(x + dx, y) && walkableAt(x, y + dy))) continue;
+                add(dx, dy);
+            }
+        }
+    } else {
+        int px = node.parent % gridWidth;
+        int py = node.parent / gridWidth;
+        int dx = (x > px) - (x < px);
+        int dy = (y > py) - (y < py);
+
+        if (dx != 0 && dy != 0) {
+            bool horizontal = walkableAt(x + dx, y);
+            bool vertical = walkableAt(x, y + dy);
+            if (vertical) add(0, dy);
+            if (horizontal) add(dx, 0);
+            if (horizontal && vertical) add(dx, dy);
+        } else if (dx != 0) {
+            bool next = walkableAt(x + dx, y);
+            bool down = walkableAt(x, y + 1);
+            bool up = walkableAt(x, y - 1);
+            if (next) {
+                add(dx, 0);
+                if (down) add(dx, 1);
+                if (up) add(dx, -1);
+            }
+            if (down) add(0, 1);
+            if (up) add(0, -1);
+        } else {
+            bool next = walkableAt(x, y + dy);
+            bool right = walkableAt(x + 1, y);
+            bool left = walkableAt(x - 1, y);
+            if (next) {
+                add(0, dy);
+                if (right) add(1, dy);
+                if (left) add(-1, dy);
+            }
+            if (right) add(1, 0);
+            if (left) add(-1, 0);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int jumpPoint = jump(x + directions[i][0], y + directions[i][1],
+                             directions[i][0], directions[i][1], search.goal, steps);
+        if (jumpPoint < 0) continue;
+
+        // 跳跃段是直线或对角线，代价就是两点的八方向距离
+        pushOpen(search, jumpPoint, node.g + heuristic(cell, jumpPoint), cell);
+    }
+}
+
+int NavigationSystem::jumpStraight(int x, int y, int dx, int dy, int goal, int& steps) const {
+    while (true) {
+        if (!walkableAt(x, y)) return -1;
+        steps++;
+
+        int cell = cellIndex(x, y);
+        if (cell == goal) return cell;
+
+        // 侧面原本被挡、现在敞开：出现强制邻居
+        if (dx != 0) {
+            if ((walkableAt(x, y - 1) && !walkableAt(x - dx, y - 1)) ||
+                (walkableAt(x, y + 1) && !walkableAt(x - dx, y + 1))) {
+                return cell;
+            }
+        } else {
+            if ((walkableAt(x - 1, y) && !walkableAt(x - 1, y - dy)) ||
+                (walkableAt(x + 1, y) && !walkableAt(x + 1, y - dy))) {
+                return cell;
+            }
+        }
+
+        x += dx;
+        y += dy;
+    }
+}
+
+int NavigationSystem::jump(int x, int y, int dx, int dy, int goal, int& steps) const {
+    if (dx == 0 || dy == 0) return jumpStraight(x, y, dx, dy, goal, steps);
+
+    while (true) {
+        if (!walkableAt(x, y)) return -1;
+        steps++;
+
+        int cell = cellIndex(x, y);
+        if (cell == goal) return cell;
+
+        // 对角移动时，水平或垂直方向能跳到跳点，当前格就是跳点
+        if (jumpStraight(x + dx, y, dx, 0, goal, steps) >= 0 ||
+            jumpStraight(x, y + dy, 0, dy, goal, steps) >= 0) {
+            return cell;
+        }
+
+        // 不切墙角：两侧都通才能继续斜走
+        if (!(walkableAt(x + dx, y) && walkableAt(x, y + dy))) return -1;
+
+        x += dx;
+        y += dy;
+    }
+}
+
+void NavigationSystem::finishSearch(Search& search, bool found) {
+    if (!found) {
+        results[search.id] = Result{PathStatus::FAILED, {}};
+        return;
+    }
+
+    // 回溯跳点，再把跳点之间的直线/对角线段展开成逐格路径
+    std::vector<int> jumpPoints;
+    for (int cell = search.goal; cell >= 0; cell = search.nodes[cell].parent) {
+        jumpPoints.push_back(cell);
+    }
+    std::reverse(jumpPoints.begin(), jumpPoints.end());
+
+    std::vector<int> cells;
+    cells.push_back(jumpPoints.front());
+    for (size_t i = 1; i < jumpPoints.size(); ++i) {
+        int x = jumpPoints[i - 1] % gridWidth;
+        int y = jumpPoints[i - 1] / gridWidth;
+        int tx = jumpPoints[i] % gridWidth;
+        int ty = jumpPoints[i] / gridWidth;
+        int dx = (tx > x) - (tx < x);
+        int dy = (ty > y) - (ty < y);
+        while (x != tx || y != ty) {
+            x += dx;
+            y += dy;
+            cells.push_back(cellIndex(x, y));
+        }
+    }
+
+    storeInCache(search.goal, cells);
+
+    Result result{PathStatus::FOUND, {}};
+    cellsToWaypoints(cells, result.waypoints);
+    results[search.id] = std::move(result);
+}
+
+bool NavigationSystem::lookupCache(int start, int goal, std::vector<Vector2>& waypoints) {
+    auto it = std::find_if(cache.begin(), cache.end(),
+                           [goal](const GoalCache& entry) { return entry.goal == goal; });
+    if (it == cache.end()) return false;
+
+    std::vector<int> cells;
+    cells.push_back(start);
+
+    if (start != goal && it->next.find(start) == it->next.end()) {
+        // 起点不在树上时，允许先走一步到相邻的树上格子
+        int sx = start % gridWidth;
+        int sy = start / gridWidth;
+        int entry = -1;
+        for (int dy = -1; dy <= 1 && entry < 0; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+                if (!walkableAt(sx + dx, sy + dy)) continue;
+                if (dx != 0 && dy != 0 && !(walkableAt(sx + dx, sy) && walkableAt(sx, sy + dy))) continue;
+
+                int neighbor = cellIndex(sx + dx, sy + dy);
+                if (neighbor == goal || it->next.count(neighbor)) {
+                    entry = neighbor;
+                    break;
+                }
+            }
+        }
+        if (entry < 0) return false;
+        cells.push_back(entry);
+    }
+
+    // 沿路径树走到目标
+    size_t guard = it->next.size() + 2;
+    while (cells.back() != goal) {
+        auto next = it->next.find(cells.back());
+        if (next == it->next.end() || guard-- == 0) return false;
+        cells.push_back(next->second);
+    }
+
+    it->lastUsed = frame;
+    cellsToWaypoints(cells, waypoints);
+    return true;
+}
+
+void NavigationSystem::storeInCache(int goal, const std::vector<int>& cells) {
+    auto it = std::find_if(cache.begin(), cache.end(),
+                           [goal](const GoalCache& entry) { return entry.goal == goal; });
+    if (it == cache.end()) {
+        // 淘汰最久未用的目标
+        if (cache.size() >= MAX_CACHED_GOALS) {
+            auto oldest = std::min_element(cache.begin(), cache.end(),
+                                           [](const GoalCache& a, const GoalCache& b) { return a.lastUsed < b.lastUsed; });
+            cache.erase(oldest);
+        }
+        cache.push_back(GoalCache{goal, frame, {}});
+        it = cache.end() - 1;
+    }
+    it->lastUsed = frame;
+
+    // 遇到已在树上的格子就停下：后面的路已经能走到目标，保持树结构不变
+    for (size_t i = 0; i + 1 < cells.size(); ++i) {
+        if (it->next.size() >= MAX_CACHED_CELLS_PER_GOAL) break;
+        if (!it->next.emplace(cells[i], cells[i + 1]).second) break;
+    }
+}
+
+void NavigationSystem::cellsToWaypoints(const std::vector<int>& cells, std::vector<Vector2>& waypoints) const {
+    waypoints.clear();
+
+    // 只保留拐点和终点，起点不输出
+    for (size_t i = 1; i < cells.size(); ++i) {
+        if (i + 1 < cells.size()) {
+            int dx1 = cells[i] % gridWidth - cells[i - 1] % gridWidth;
+            int dy1 = cells[i] / gridWidth - cells[i - 1] / gridWidth;
+            int dx2 = cells[i + 1] % gridWidth - cells[i] % gridWidth;
+            int dy2 = cells[i + 1] / gridWidth - cells[i] / gridWidth;
+            if (dx1 == dx2 && dy1 == dy2) continue;
+        }
+        waypoints.push_back(cellCenter(cells[i]));
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef NAVIGATIONSYSTEM_HPP
+#define NAVIGATIONSYSTEM_HPP
+
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <unordered_map>
+#include <cstdint>
+#include <raylib.h>
+
+class MapLoader;
+
+// 寻路请求状态
+enum class PathStatus {
+    NONE,       // 无效或已取走的请求
+    PENDING,    // 排队或搜索中（可能跨多帧）
+    FOUND,
+    FAILED
+};
+
+// 网格寻路服务：基于 MapLoader 的碰撞数据做跳点搜索（JPS，8 方向，不切墙角）
+// 所有请求共享每帧的搜索预算，超出预算的请求留到后续帧继续；
+// 同一目标的结果按格子缓存成路径树，之后从树上任一格子（或其邻格）出发的请求直接复用
+// （复用的路径不保证最短，换来成群的猫追同一个猫薄荷时几乎不用再搜索）
+class NavigationSystem {
+public:
+    using RequestId = uint32_t;     // 0 表示无效请求
+
+    // 每帧默认搜索预算（出堆节点数 + 跳跃扫描的格子数）
+    static constexpr int DEFAULT_FRAME_BUDGET = 4000;
+
+    // 单个请求的搜索上限，超过视为不可达
+    static constexpr int MAX_SEARCH_STEPS = 200000;
+
+    // 最多缓存的目标数
+    static constexpr size_t MAX_CACHED_GOALS = 16;
+
+    NavigationSystem();
+
+    // 按代理尺寸从碰撞数据生成可通行网格：格子中心放得下 agentSize 的矩形才可通行
+    void build(const MapLoader& map, Vector2 agentSize);
+
+    // 地图碰撞变化后重新计算一块区域（图块坐标，闭区间，内部按代理尺寸外扩），同时清空路径缓存
+    void refreshCells(int x0, int y0, int x1, int y1);
+
+    // 提交请求，from/to 为世界坐标（代理中心）；命中缓存时立即完成
+    RequestId requestPath(Vector2 from, Vector2 to);
+
+    // 查询状态
+    PathStatus getStatus(RequestId id) const;
+
+    // 取走已完成的路径（世界坐标的拐点，不含起点），取走后请求失效
+    bool takePath(RequestId id, std::vector<Vector2>& waypoints);
+
+    // 取消请求（排队中、搜索中或已完成未取走都可以）
+    void cancel(RequestId id);
+
+    // 每帧调用一次，用本帧预算推进排队的请求
+    void update();
+
+    void setFrameBudget(int steps) { frameBudget = steps; }
+
+    // 统计
+    int getStepsLastFrame() const { return stepsLastFrame; }
+    size_t getPendingCount() const { return queue.size(); }
+
+    bool isReady() const { return gridWidth > 0 && gridHeight > 0; }
+    bool isWalkable(int x, int y) const;
+
+private:
+    // 搜索节点（只记录被触及的格子）
+    struct Node {
+        float g;
+        int parent;               // 父跳点的格子下标，起点为 -1
+        bool closed;
+    };
+
+    // 二叉堆中的开放节点
+    struct OpenEntry {
+        float f;
+        int cell;
+    };
+
+    // 进行中的搜索，可跨帧暂停
+    struct Search {
+        RequestId id;
+        int start;
+        int goal;
+        int steps;
+        bool started;
+        std::vector<OpenEntry> open;
+        std::unordered_map<int, Node> nodes;
+    };
+
+    // 已完成的请求
+    struct Result {
+        PathStatus status;
+        std::vector<Vector2> waypoints;
+    };
+
+    // 某个目标的路径树：格子 -> 朝目标的下一个格子
+    struct GoalCache {
+        int goal;
+        uint64_t lastUsed;
+        std::unordered_map<int, int> next;
+    };
+
+    int cellIndex(int x, int y) const { return y * gridWidth + x; }
+    bool walkableAt(int x, int y) const;
+    int worldToCell(Vector2 point) const;
+    int nearestWalkable(int cell) const;
+    Vector2 cellCenter(int cell) const;
+    float heuristic(int a, int b) const;
+
+    // 推进一个搜索，返回 true 表示已结束（成功或失败）
+    bool stepSearch(Search& search, int& budget);
+    void expandNode(Search& search, int cell, int& steps);
+    int jump(int x, int y, int dx, int dy, int goal, int& steps) const;
+    int jumpStraight(int x, int y, int dx, int dy, int goal, int& steps) const;
+    void pushOpen(Search& search, int cell, float g, int parent);
+
+    // 结果处理与缓存
+    void finishSearch(Search& search, bool found);
+    bool lookupCache(int start, int goal, std::vector<Vector2>& waypoints);
+    void storeInCache(int goal, const std::vector<int>& cells);
+    void cellsToWaypoints(const std::vector<int>& cells, std::vector<Vector2>& waypoints) const;
+
+    const MapLoader* map;
+    Vector2 agentSize;
+    int gridWidth;
+    int gridHeight;
+    int tileWidth;
+    int tileHeight;
+    std::vector<uint8_t> walkable;
+
+    std::deque<Search> queue;
+    std::unordered_map<RequestId, Result> results;
+    std::vector<GoalCache> cache;
+    RequestId nextId;
+    uint64_t frame;
+    int frameBudget;
+    int stepsLastFrame;
+};
+
+#endif // NAVIGATIONSYSTEM_HPP
@@ -0,0 +1,117 @@
+#include "SpatialHash.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize)
+    : cellSize(cellSize), inverseCellSize(1.0f / cellSize), bucketMask(0), currentStamp(0) {
+}
+
+void SpatialHash::clear() {
+    ids.clear();
+    pending.clear();
+    entries.clear();
+    bucketStart.clear();
+    bucketMask = 0;
+}
+
+int SpatialHash::cellCoord(float value) const {
+    return static_cast<int>(std::floor(value * inverseCellSize));
+}
+
+uint32_t SpatialHash::bucketOf(int cellX, int cellY) const {
+    uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u;
+    return hash & bucketMask;
+}
+
+void SpatialHash::insert(uint32_t id, const Rectangle& rect) {
+    if (id >= bounds.size()) {
+        bounds.resize(id + 1);
+        visitStamp.resize(id + 1, 0);
+    }
+    bounds[id] = rect;
+    ids.push_back(id);
+
+    int x0 = cellCoord(rect.x);
+    int y0 = cellCoord(rect.y);
+    int x1 = cellCoord(rect.x + rect.width);
+    int y1 = cellCoord(rect.y + rect.height);
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            pending.push_back({x, y, id});
+        }
+    }
+}
+
+void SpatialHash::build() {
+    // 桶数取登记数两倍以上的 2 的幂，平均每桶不到一个格子
+    uint32_t bucketCount = 16;
+    while (bucketCount < pending.size() * 2) bucketCount <<= 1;
+    bucketMask = bucketCount - 1;
+
+    // 计数排序：先数每个桶的登记数，前缀和得到起点，再分发
+    bucketStart.assign(bucketCount + 1, 0);
+    for (const CellEntry& entry : pending) {
+        bucketStart[bucketOf(entry.cellX, entry.cellY) + 1]++;
+    }
+    for (uint32_t i = 0; i < bucketCount; i++) {
+        bucketStart[i + 1] += bucketStart[i];
+    }
+
+    entries.resize(pending.size());
+    cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+    for (const CellEntry& entry : pending) {
+        entries[cursor[bucketOf(entry.cellX, entry.cellY)]++] = entry.id;
+    }
+    pending.clear();
+}
+
+template <typename Test>
+void SpatialHash::query(const Rectangle& area, std::vector<uint32_t>& out, Test test) const {
+    if (ids.empty() || bucketStart.empty()) return;
+
+    // 新的查询编号，回绕时清零重来
+    if (++currentStamp == 0) {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        currentStamp = 1;
+    }
+
+    auto visit = [&](uint32_t id) {
+        if (visitStamp[id] == currentStamp) return;
+        visitStamp[id] = currentStamp;
+        if (test(bounds[id])) out.push_back(id);
+    };
+
+    int x0 = cellCoord(area.x);
+    int y0 = cellCoord(area.y);
+    int x1 = cellCoord(area.x + area.width);
+    int y1 = cellCoord(area.y + area.height);
+
+    // 范围覆盖的格子比桶还多时，直接扫所有实体更快
+    int64_t cellCount = static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1);
+    if (cellCount > static_cast<int64_t>(bucketMask) + 1) {
+        for (uint32_t id : ids) visit(id);
+        return;
+    }
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            uint32_t bucket = bucketOf(x, y);
+            for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; i++) {
+                visit(entries[i]);
+            }
+        }
+    }
+}
+
+void SpatialHash::queryRect(const Rectangle& area, std::vector<uint32_t>& out) const {
+    query(area, out, [&area](const Rectangle& rect) {
+        return CheckCollisionRecs(rect, area);
+    });
+}
+
+void SpatialHash::queryRadius(Vector2 center, float radius, std::vector<uint32_t>& out) const {
+    Rectangle area = {center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f};
+    query(area, out, [center, radius](const Rectangle& rect) {
+        return CheckCollisionCircleRec(center, radius, rect);
+    });
+}
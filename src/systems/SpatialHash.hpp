@@ -0,0 +1,64 @@
+#ifndef SPATIALHASH_HPP
+#define SPATIALHASH_HPP
+
+#include <raylib.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 均匀网格空间哈希：每帧清空后重新插入所有实体，再做矩形和圆形范围查询
+// 实体按包围盒覆盖的格子登记（一个实体可能登记在多个格子），格子坐标哈希到桶；
+// build 时按桶做一次计数排序，查询只访问范围内格子对应的桶
+// id 需是较小的连续整数（如数组下标），查询结果去重并做精确的包围盒测试
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 128.0f);
+
+    // 清空所有实体（保留内存）
+    void clear();
+
+    // 登记实体，插入完毕后调用 build
+    void insert(uint32_t id, const Rectangle& bounds);
+    void build();
+
+    // 包围盒与 area 相交的实体，追加到 out
+    void queryRect(const Rectangle& area, std::vector<uint32_t>& out) const;
+
+    // 包围盒与圆相交的实体，追加到 out
+    void queryRadius(Vector2 center, float radius, std::vector<uint32_t>& out) const;
+
+    size_t size() const { return ids.size(); }
+    float getCellSize() const { return cellSize; }
+
+private:
+    struct CellEntry {
+        int cellX;
+        int cellY;
+        uint32_t id;
+    };
+
+    int cellCoord(float value) const;
+    uint32_t bucketOf(int cellX, int cellY) const;
+
+    // 遍历与 area 重叠的格子中的实体（已去重），test 为 true 的追加到 out
+    template <typename Test>
+    void query(const Rectangle& area, std::vector<uint32_t>& out, Test test) const;
+
+    float cellSize;
+    float inverseCellSize;
+
+    std::vector<uint32_t> ids;              // 插入顺序
+    std::vector<Rectangle> bounds;          // 按 id 索引
+    std::vector<CellEntry> pending;         // insert 登记的 (格子, id)
+
+    uint32_t bucketMask;
+    std::vector<uint32_t> bucketStart;      // 每个桶在 entries 中的起点，多一个哨兵
+    std::vector<uint32_t> entries;          // 按桶排好的 id
+    std::vector<uint32_t> cursor;           // build 分发时每个桶的写入位置
+
+    // 查询去重：id 被访问过的查询编号
+    mutable std::vector<uint32_t> visitStamp;
+    mutable uint32_t currentStamp;
+};
+
+#endif // SPATIALHASH_HPP
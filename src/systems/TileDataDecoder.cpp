@@ -0,0 +1,188 @@
+#include "TileDataDecoder.hpp"
+#include "XmlReader.hpp"
+#include <array>
+#include <cstring>
+
+// raylib 内部已经编译了一份 sinfl，这里重命名后再实例化一份，避免与 libraylib 的符号冲突
+// （系统安装的 raylib 不一定开启 SUPPORT_COMPRESSION_API，也不会安装 sinfl.h）
+#define sinflate meowmon_sinflate
+#define zsinflate meowmon_zsinflate
+#define SINFL_IMPLEMENTATION
+#include "sinfl.h"
+#undef SINFL_IMPLEMENTATION
+#undef zsinflate
+#undef sinflate
+
+#ifdef MEOWMON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// base64 字符 -> 6 位取值，0x40 表示空白（跳过），0xFF 表示非法字符
+// 解码可能同时跑在多个线程上，查找表用局部静态常量初始化（线程安全）
+static const unsigned char* base64Table() {
+    static const std::array<unsigned char, 256> table = [] {
+        std::array<unsigned char, 256> t;
+        t.fill(0xFF);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (unsigned char i = 0; i < 64; ++i) t[static_cast<unsigned char>(alphabet[i])] = i;
+        t[static_cast<unsigned char>(' ')] = 0x40;
+        t[static_cast<unsigned char>('\t')] = 0x40;
+        t[static_cast<unsigned char>('\n')] = 0x40;
+        t[static_cast<unsigned char>('\r')] = 0x40;
+        return t;
+    }();
+    return table.data();
+}
+
+static bool isLittleEndianHost() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+bool TileDataDecoder::parseCompression(std::string_view name, TileCompression& compression) {
+    if (name.empty()) compression = TileCompression::NONE;
+    else if (name == "zlib") compression = TileCompression::ZLIB;
+    else if (name == "gzip") compression = TileCompression::GZIP;
+    else if (name == "zstd") compression = TileCompression::ZSTD;
+    else return false;
+    return true;
+}
+
+bool TileDataDecoder::isSupported(TileCompression compression) {
+#ifdef MEOWMON_HAVE_ZSTD
+    (void)compression;
+    return true;
+#else
+    return compression != TileCompression::ZSTD;
+#endif
+}
+
+size_t TileDataDecoder::decodeCsv(std::string_view text, uint32_t* gids, size_t count) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    size_t index = 0;
+    
+    // 翻转标志位原样保留在高 4 位
+    while (p < end && index < count) {
+        unsigned long long value = 0;
+        if (XmlReader::parseUnsigned(p, end, value)) {
+            gids[index++] = static_cast<uint32_t>(value);
+        } else {
+            ++p; // 逗号、空白
+        }
+    }
+    
+    return index;
+}
+
+long long TileDataDecoder::decodeBase64(std::string_view text, unsigned char* out, size_t capacity) {
+    const unsigned char* table = base64Table();
+    size_t written = 0;
+    uint32_t accumulator = 0;
+    int bits = 0;
+    
+    for (char c : text) {
+        if (c == '=') break;
+        
+        unsigned char value = table[static_cast<unsigned char>(c)];
+        if (value == 0x40) continue;
+        if (value == 0xFF) return -1;
+        
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (written >= capacity) return -1;
+            out[written++] = static_cast<unsigned char>((accumulator >> bits) & 0xFF);
+        }
+    }
+    
+    return static_cast<long long>(written);
+}
+
+long long TileDataDecoder::inflateZlib(const unsigned char* in, size_t size, unsigned char* out, size_t capacity) {
+    // 2 字节头 + deflate 数据 + 4 字节 adler32，zsinflate 会校验 adler32
+    if (size < 6 || (in[0] & 0x0F) != 8 || ((in[0] << 8) | in[1]) % 31 != 0) return -1;
+    int n = meowmon_zsinflate(out, static_cast<int>(capacity), in, static_cast<int>(size));
+    return n;
+}
+
+long long TileDataDecoder::inflateGzip(const unsigned char* in, size_t size, unsigned char* out, size_t capacity) {
+    // RFC 1952：10 字节固定头，之后是可选字段，末尾 8 字节为 CRC32 和原始长度
+    if (size < 18 || in[0] != 0x1F || in[1] != 0x8B || in[2] != 8) return -1;
+    
+    const unsigned char flags = in[3];
+    size_t pos = 10;
+    if (flags & 0x04) {                                   // FEXTRA
+        if (pos + 2 > size) return -1;
+        pos += 2 + (in[pos] | (in[pos + 1] << 8));
+    }
+    if (flags & 0x08) {                                   // FNAME
+        while (pos < size && in[pos] != 0) ++pos;
+        ++pos;
+    }
+    if (flags & 0x10) {                                   // FCOMMENT
+        while (pos < size && in[pos] != 0) ++pos;
+        ++pos;
+    }
+    if (flags & 0x02) pos += 2;                           // FHCRC
+    if (pos + 8 > size) return -1;
+    
+    int n = meowmon_sinflate(out, static_cast<int>(capacity), in + pos, static_cast<int>(size - pos - 8));
+    
+    // 用尾部记录的原始长度（ISIZE）做一次完整性检查
+    const unsigned char* trailer = in + size - 4;
+    uint32_t originalSize = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<uint32_t>(trailer[3]) << 24);
+    if (n < 0 || static_cast<uint32_t>(n) != originalSize) return -1;
+    return n;
+}
+
+long long TileDataDecoder::decompressZstd(const unsigned char* in, size_t size, unsigned char* out, size_t capacity) {
+#ifdef MEOWMON_HAVE_ZSTD
+    size_t n = ZSTD_decompress(out, capacity, in, size);
+    if (ZSTD_isError(n)) return -1;
+    return static_cast<long long>(n);
+#else
+    (void)in; (void)size; (void)out; (void)capacity;
+    return -1;
+#endif
+}
+
+bool TileDataDecoder::decodeLayerData(std::string_view base64, TileCompression compression,
+                                      uint32_t* gids, size_t count, std::vector<unsigned char>& scratch) {
+    const size_t expectedBytes = count * sizeof(uint32_t);
+    unsigned char* target = reinterpret_cast<unsigned char*>(gids);
+    long long written = -1;
+    
+    if (compression == TileCompression::NONE) {
+        // 未压缩：base64 直接解码到 gid 缓冲区
+        written = decodeBase64(base64, target, expectedBytes);
+    } else {
+        scratch.resize(base64.size() / 4 * 3 + 3);
+        long long compressedSize = decodeBase64(base64, scratch.data(), scratch.size());
+        if (compressedSize < 0) return false;
+        
+        const unsigned char* in = scratch.data();
+        size_t size = static_cast<size_t>(compressedSize);
+        switch (compression) {
+            case TileCompression::ZLIB: written = inflateZlib(in, size, target, expectedBytes); break;
+            case TileCompression::GZIP: written = inflateGzip(in, size, target, expectedBytes); break;
+            case TileCompression::ZSTD: written = decompressZstd(in, size, target, expectedBytes); break;
+            default: break;
+        }
+    }
+    
+    if (written != static_cast<long long>(expectedBytes)) return false;
+    
+    // Tiled 按小端存储，大端主机需要逐个交换字节
+    if (!isLittleEndianHost()) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t v = gids[i];
+            gids[i] = (v >> 24) | ((v >> 8) & 0x0000FF00u) | ((v << 8) & 0x00FF0000u) | (v << 24);
+        }
+    }
+    
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef TILEDATADECODER_HPP
+#define TILEDATADECODER_HPP
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 图层数据压缩方式（对应 Tiled 的 compression 属性）
+enum class TileCompression {
+    NONE,
+    ZLIB,
+    GZIP,
+    ZSTD
+};
+
+// 图层数据编码方式（对应 Tiled 的 encoding 属性）
+enum class TileEncoding {
+    XML,         // 未编码，每个图块一个 <tile gid="..."/>
+    CSV,
+    BASE64
+};
+
+// Tiled base64 图层数据解码：base64 -> (解压) -> 小端 uint32 gid
+// 解码结果直接写入调用方提供的 gid 缓冲区，不经过中间字符串
+class TileDataDecoder {
+public:
+    // 解析 compression 属性，空串表示不压缩；未知取值返回 false
+    static bool parseCompression(std::string_view name, TileCompression& compression);
+    
+    // 当前构建是否支持该压缩方式（zstd 需在编译时找到 libzstd）
+    static bool isSupported(TileCompression compression);
+    
+    // 解析 CSV 文本到 gids，最多写入 count 个，返回实际写入数量
+    static size_t decodeCsv(std::string_view text, uint32_t* gids, size_t count);
+    
+    // 解码 base64 文本（忽略空白字符），返回写入的字节数，出错返回 -1
+    static long long decodeBase64(std::string_view text, unsigned char* out, size_t capacity);
+    
+    // 解码一整块图层数据到 gids[0, count)
+    // scratch 用于存放压缩数据，可在多个图层之间复用以减少分配
+    static bool decodeLayerData(std::string_view base64, TileCompression compression,
+                                uint32_t* gids, size_t count, std::vector<unsigned char>& scratch);
+    
+private:
+    // 解压到 out，返回写入的字节数，出错返回 -1
+    static long long inflateZlib(const unsigned char* in, size_t size, unsigned char* out, size_t capacity);
+    static long long inflateGzip(const unsigned char* in, size_t size, unsigned char* out, size_t capacity);
+    static long long decompressZstd(const unsigned char* in, size_t size, unsigned char* out, size_t capacity);
+};
+
+#endif // TILEDATADECODER_HPP
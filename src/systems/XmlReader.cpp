@@ -0,0 +1,291 @@
+#include "XmlReader.hpp"
+#include <cstdlib>
+#include <cstring>
+
+XmlReader::XmlReader(const char* data, size_t size)
+    : begin(data), cursor(data), end(data + size), pendingEndElement(false) {
+}
+
+XmlReader::XmlReader(std::string_view data)
+    : XmlReader(data.data(), data.size()) {
+}
+
+static bool isXmlWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+XmlReader::Token XmlReader::fail(const std::string& message) {
+    error = message + " (偏移 " + std::to_string(cursor - begin) + ")";
+    cursor = end;
+    return Token::ERROR;
+}
+
+void XmlReader::skipWhitespace() {
+    while (cursor < end && isXmlWhitespace(*cursor)) ++cursor;
+}
+
+XmlReader::Token XmlReader::next() {
+    // 自闭合元素补发结束记号，元素名保持不变
+    if (pendingEndElement) {
+        pendingEndElement = false;
+        attributes.clear();
+        return Token::END_ELEMENT;
+    }
+    
+    while (cursor < end) {
+        if (*cursor != '<') {
+            // 文本：一直读到下一个标签
+            const char* start = cursor;
+            bool whitespaceOnly = true;
+            while (cursor < end && *cursor != '<') {
+                if (!isXmlWhitespace(*cursor)) whitespaceOnly = false;
+                ++cursor;
+            }
+            if (whitespaceOnly) continue;
+            
+            textContent = std::string_view(start, cursor - start);
+            return Token::TEXT;
+        }
+        
+        if (cursor + 1 >= end) return fail("标签不完整");
+        
+        char kind = cursor[1];
+        if (kind == '/') {
+            if (!parseEndTag()) return fail("结束标签格式错误");
+            return Token::END_ELEMENT;
+        }
+        
+        if (kind == '!' && end - cursor >= 9 && std::memcmp(cursor, "<![CDATA[", 9) == 0) {
+            const char* start = cursor + 9;
+            const char* close = start;
+            while (close + 2 < end && !(close[0] == ']' && close[1] == ']' && close[2] == '>')) ++close;
+            if (close + 2 >= end) return fail("CDATA 未闭合");
+            textContent = std::string_view(start, close - start);
+            cursor = close + 3;
+            return Token::TEXT;
+        }
+        
+        if (kind == '?' || kind == '!') {
+            if (!skipSpecial()) return fail("声明或注释未闭合");
+            continue;
+        }
+        
+        if (!parseStartTag()) return fail("开始标签格式错误");
+        return Token::START_ELEMENT;
+    }
+    
+    return Token::END_OF_DOCUMENT;
+}
+
+bool XmlReader::skipSpecial() {
+    // 注释 <!-- ... -->
+    if (end - cursor >= 4 && std::memcmp(cursor, "<!--", 4) == 0) {
+        const char* p = cursor + 4;
+        while (p + 2 < end && !(p[0] == '-' && p[1] == '-' && p[2] == '>')) ++p;
+        if (p + 2 >= end) return false;
+        cursor = p + 3;
+        return true;
+    }
+    
+    // <?xml ...?>、<!DOCTYPE ...> 等直接跳到 '>'
+    const char* p = cursor + 2;
+    while (p < end && *p != '>') ++p;
+    if (p >= end) return false;
+    cursor = p + 1;
+    return true;
+}
+
+bool XmlReader::parseStartTag() {
+    attributes.clear();
+    ++cursor; // '<'
+    
+    const char* nameStart = cursor;
+    while (cursor < end && !isXmlWhitespace(*cursor) && *cursor != '/' && *cursor != '>') ++cursor;
+    if (cursor == nameStart) return false;
+    elementName = std::string_view(nameStart, cursor - nameStart);
+    
+    while (true) {
+        skipWhitespace();
+        if (cursor >= end) return false;
+        
+        if (*cursor == '>') {
+            ++cursor;
+            return true;
+        }
+        if (*cursor == '/') {
+            if (cursor + 1 >= end || cursor[1] != '>') return false;
+            cursor += 2;
+            pendingEndElement = true;
+            return true;
+        }
+        
+        // 属性名
+        const char* keyStart = cursor;
+        while (cursor < end && !isXmlWhitespace(*cursor) && *cursor != '=' && *cursor != '>' && *cursor != '/') ++cursor;
+        std::string_view key(keyStart, cursor - keyStart);
+        if (key.empty()) return false;
+        
+        skipWhitespace();
+        if (cursor >= end || *cursor != '=') return false;
+        ++cursor;
+        skipWhitespace();
+        
+        // 属性值（单引号或双引号）
+        if (cursor >= end || (*cursor != '"' && *cursor != '\'')) return false;
+        char quote = *cursor++;
+        const char* valueStart = cursor;
+        while (cursor < end && *cursor != quote) ++cursor;
+        if (cursor >= end) return false;
+        
+        attributes.push_back({key, std::string_view(valueStart, cursor - valueStart)});
+        ++cursor;
+    }
+}
+
+bool XmlReader::parseEndTag() {
+    attributes.clear();
+    cursor += 2; // "</"
+    
+    const char* nameStart = cursor;
+    while (cursor < end && !isXmlWhitespace(*cursor) && *cursor != '>') ++cursor;
+    elementName = std::string_view(nameStart, cursor - nameStart);
+    
+    skipWhitespace();
+    if (cursor >= end || *cursor != '>') return false;
+    ++cursor;
+    return !elementName.empty();
+}
+
+void XmlReader::skipElement() {
+    int depth = 1;
+    while (depth > 0) {
+        Token token = next();
+        if (token == Token::START_ELEMENT) depth++;
+        else if (token == Token::END_ELEMENT) depth--;
+        else if (token == Token::END_OF_DOCUMENT || token == Token::ERROR) break;
+    }
+}
+
+bool XmlReader::hasAttribute(std::string_view key) const {
+    for (const auto& attr : attributes) {
+        if (attr.key == key) return true;
+    }
+    return false;
+}
+
+std::string_view XmlReader::rawAttribute(std::string_view key) const {
+    for (const auto& attr : attributes) {
+        if (attr.key == key) return attr.value;
+    }
+    return std::string_view();
+}
+
+std::string XmlReader::attribute(std::string_view key, const std::string& defaultValue) const {
+    for (const auto& attr : attributes) {
+        if (attr.key == key) return decodeEntities(attr.value);
+    }
+    return defaultValue;
+}
+
+int XmlReader::intAttribute(std::string_view key, int defaultValue) const {
+    std::string_view raw = rawAttribute(key);
+    if (raw.empty()) return defaultValue;
+    
+    const char* p = raw.data();
+    const char* last = p + raw.size();
+    bool negative = (*p == '-');
+    if (negative || *p == '+') ++p;
+    
+    unsigned long long value = 0;
+    if (!parseUnsigned(p, last, value)) return defaultValue;
+    return negative ? -static_cast<int>(value) : static_cast<int>(value);
+}
+
+unsigned int XmlReader::uintAttribute(std::string_view key, unsigned int defaultValue) const {
+    std::string_view raw = rawAttribute(key);
+    const char* p = raw.data();
+    unsigned long long value = 0;
+    if (raw.empty() || !parseUnsigned(p, p + raw.size(), value)) return defaultValue;
+    return static_cast<unsigned int>(value);
+}
+
+float XmlReader::floatAttribute(std::string_view key, float defaultValue) const {
+    std::string_view raw = rawAttribute(key);
+    if (raw.empty()) return defaultValue;
+    
+    // 浮点属性很少（opacity、offset），拷贝一次交给 strtof
+    std::string value(raw);
+    char* parsedEnd = nullptr;
+    float result = std::strtof(value.c_str(), &parsedEnd);
+    return (parsedEnd == value.c_str()) ? defaultValue : result;
+}
+
+bool XmlReader::boolAttribute(std::string_view key, bool defaultValue) const {
+    std::string_view raw = rawAttribute(key);
+    if (raw.empty()) return defaultValue;
+    return raw == "true" || raw == "1";
+}
+
+bool XmlReader::parseUnsigned(const char*& p, const char* end, unsigned long long& value) {
+    value = 0;
+    const char* start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<unsigned long long>(*p - '0');
+        ++p;
+    }
+    return p != start;
+}
+
+std::string XmlReader::decodeEntities(std::string_view value) {
+    if (value.find('&') == std::string_view::npos) return std::string(value);
+    
+    std::string result;
+    result.reserve(value.size());
+    
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '&') {
+            result += value[i];
+            continue;
+        }
+        
+        size_t semicolon = value.find(';', i);
+        if (semicolon == std::string_view::npos) {
+            result += value.substr(i);
+            break;
+        }
+        
+        std::string_view entity = value.substr(i + 1, semicolon - i - 1);
+        if (entity == "amp") result += '&';
+        else if (entity == "lt") result += '<';
+        else if (entity == "gt") result += '>';
+        else if (entity == "quot") result += '"';
+        else if (entity == "apos") result += '\'';
+        else if (!entity.empty() && entity[0] == '#') {
+            // 数字字符引用，按 UTF-8 编码输出
+            unsigned long code = (entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X'))
+                ? std::strtoul(std::string(entity.substr(2)).c_str(), nullptr, 16)
+                : std::strtoul(std::string(entity.substr(1)).c_str(), nullptr, 10);
+            if (code < 0x80) {
+                result += static_cast<char>(code);
+            } else if (code < 0x800) {
+                result += static_cast<char>(0xC0 | (code >> 6));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                result += static_cast<char>(0xE0 | (code >> 12));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                result += static_cast<char>(0xF0 | (code >> 18));
+                result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        } else {
+            // 未知实体原样保留
+            result += value.substr(i, semicolon - i + 1);
+        }
+        i = semicolon;
+    }
+    
+    return result;
+}
@@ -0,0 +1,78 @@
+#ifndef XMLREADER_HPP
+#define XMLREADER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// 单遍流式 XML 读取器（拉模式）
+// 只支持 Tiled 导出文件用到的子集：元素、属性、文本、注释、<?xml?> 声明
+// 名称、属性值和文本都直接指向输入缓冲区，不做拷贝，缓冲区需在读取期间保持有效
+class XmlReader {
+public:
+    enum class Token {
+        START_ELEMENT,   // <name ...> 或 <name .../>
+        END_ELEMENT,     // </name>，自闭合元素也会产生一次
+        TEXT,            // 元素之间的非空白文本
+        END_OF_DOCUMENT,
+        ERROR
+    };
+
+    XmlReader(const char* data, size_t size);
+    explicit XmlReader(std::string_view data);
+
+    // 读取下一个记号
+    Token next();
+
+    // 当前元素名（START_ELEMENT / END_ELEMENT）
+    std::string_view name() const { return elementName; }
+
+    // 当前文本（TEXT），未做实体解码
+    std::string_view text() const { return textContent; }
+
+    // 当前开始标签的属性
+    bool hasAttribute(std::string_view key) const;
+    std::string_view rawAttribute(std::string_view key) const;
+    std::string attribute(std::string_view key, const std::string& defaultValue = "") const;
+    int intAttribute(std::string_view key, int defaultValue = 0) const;
+    unsigned int uintAttribute(std::string_view key, unsigned int defaultValue = 0) const;
+    float floatAttribute(std::string_view key, float defaultValue = 0.0f) const;
+    bool boolAttribute(std::string_view key, bool defaultValue = false) const;
+
+    // 跳过当前开始标签对应的整棵子树（调用后位于其 END_ELEMENT 之后）
+    void skipElement();
+
+    // 错误信息
+    const std::string& getError() const { return error; }
+
+    // 解码 &amp; &lt; &gt; &quot; &apos; 及数字字符引用
+    static std::string decodeEntities(std::string_view value);
+
+    // 手写的无符号整数解析，p 前进到数字之后；没有数字时返回 false
+    static bool parseUnsigned(const char*& p, const char* end, unsigned long long& value);
+
+private:
+    struct Attribute {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    bool parseStartTag();
+    bool parseEndTag();
+    bool skipSpecial();
+    void skipWhitespace();
+    Token fail(const std::string& message);
+
+    const char* begin;
+    const char* cursor;
+    const char* end;
+
+    std::string_view elementName;
+    std::string_view textContent;
+    std::vector<Attribute> attributes;
+    bool pendingEndElement;   // 自闭合元素需要补发 END_ELEMENT
+    std::string error;
+};
+
+#endif // XMLREADER_HPP
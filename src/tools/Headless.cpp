@@ -0,0 +1,326 @@
+// meowmon_headless：不创建窗口，按固定步长跑玩家 / 猫咪 / 猫薄荷模拟，输出每秒模拟步数
+// 用来在没有显示器的机器上压测 AI 改动
+// 用法：meowmon_headless [选项]
+//   --ticks N          模拟步数（默认 12000，即 120Hz 下 100 秒）
+//   --cats N           保持在场的猫咪数量（默认 64）
+//   --seed N           世界种子（默认 1）
+//   --threads N        参与更新的线程数，1 为单线程，0 为 CPU 核数（默认）
+//   --map 路径         碰撞地图，none 表示无墙的空地（默认尝试游戏地图）
+//   --script 路径      玩家脚本，不指定时玩家随机游走
+//   --behavior 路径    猫咪行为树（默认内置行为）
+//   --species 路径     品种表（默认内置品种）
+//   --verbose          保留游戏日志
+//
+// 玩家脚本每行一条命令，# 开头为注释，执行完后从头循环：
+//   move <秒> <dx> <dy>    按方向走一段时间，0 0 表示站着不动
+//   throw <dx> <dy>        向玩家位置加偏移处抛出猫薄荷，冷却中忽略
+
+#include "entities/Player.hpp"
+#include "entities/CatSpecies.hpp"
+#include "systems/MapLoader.hpp"
+#include "systems/NavigationSystem.hpp"
+#include "systems/CatSystem.hpp"
+#include "systems/BehaviorTree.hpp"
+#include "core/Random.hpp"
+#include "core/FixedTimestep.hpp"
+#include "core/JobSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 没有地图时的空地尺寸，以及与游戏窗口一致的视野
+static constexpr int OPEN_FIELD_SIZE = 3200;
+static constexpr float VIEW_WIDTH = 800.0f;
+static constexpr float VIEW_HEIGHT = 600.0f;
+
+struct PlayerCommand {
+    enum Type { MOVE, THROW } type;
+    float duration;
+    Vector2 vector;
+};
+
+struct HeadlessOptions {
+    long long ticks = 12000;
+    int cats = 64;
+    uint64_t seed = 1;
+    int threads = 0;
+    std::string mapPath;
+    std::string scriptPath;
+    std::string behaviorPath;
+    std::string speciesPath;
+    bool verbose = false;
+};
+
+static bool parseOptions(int argc, char* argv[], HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--verbose") == 0) {
+            options.verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "未知参数或缺少取值: " << arg << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--ticks") == 0) options.ticks = std::strtoll(value, nullptr, 10);
+        else if (std::strcmp(arg, "--cats") == 0) options.cats = std::atoi(value);
+        else if (std::strcmp(arg, "--seed") == 0) options.seed = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(arg, "--threads") == 0) options.threads = std::atoi(value);
+        else if (std::strcmp(arg, "--map") == 0) options.mapPath = value;
+        else if (std::strcmp(arg, "--script") == 0) options.scriptPath = value;
+        else if (std::strcmp(arg, "--behavior") == 0) options.behaviorPath = value;
+        else if (std::strcmp(arg, "--species") == 0) options.speciesPath = value;
+        else {
+            std::cerr << "未知参数: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.ticks <= 0 || options.cats < 0 || options.threads < 0) {
+        std::cerr << "--ticks 必须为正数，--cats 和 --threads 不能为负" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool loadScript(const std::string& path, std::vector<PlayerCommand>& commands) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "无法打开玩家脚本: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string command;
+        if (!(stream >> command) || command[0] == '#') continue;
+
+        PlayerCommand parsed = {PlayerCommand::MOVE, 0.0f, {0.0f, 0.0f}};
+        bool ok = false;
+        if (command == "move") {
+            ok = static_cast<bool>(stream >> parsed.duration >> parsed.vector.x >> parsed.vector.y) && parsed.duration > 0.0f;
+        } else if (command == "throw") {
+            parsed.type = PlayerCommand::THROW;
+            ok = static_cast<bool>(stream >> parsed.vector.x >> parsed.vector.y);
+        }
+        if (!ok) {
+            std::cerr << path << ":" << lineNumber << ": 无法解析: " << line << std::endl;
+            return false;
+        }
+        commands.push_back(parsed);
+    }
+    if (commands.empty()) {
+        std::cerr << "玩家脚本为空: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 脚本化的玩家输入：有脚本时按脚本循环执行，否则随机游走并不时抛出猫薄荷
+class PlayerDriver {
+public:
+    PlayerDriver(std::vector<PlayerCommand> commands, Pcg32 rng)
+        : commands(std::move(commands)), rng(rng), nextCommand(0), timer(0.0f) {}
+
+    void step(Player& player, float stepTime) {
+        timer -= stepTime;
+        if (commands.empty()) {
+            randomWalk(player);
+            return;
+        }
+        // 一步内连续执行抛出命令，直到遇到下一段移动
+        for (size_t guard = 0; timer <= 0.0f && guard < commands.size(); guard++) {
+            const PlayerCommand& command = commands[nextCommand];
+            nextCommand = (nextCommand + 1) % commands.size();
+            if (command.type == PlayerCommand::MOVE) {
+                player.setMoveDirection(command.vector);
+                timer += command.duration;
+            } else {
+                Vector2 position = player.getPosition();
+                player.throwCatnipAt({position.x + command.vector.x, position.y + command.vector.y});
+            }
+        }
+    }
+
+private:
+    void randomWalk(Player& player) {
+        if (timer > 0.0f) return;
+        timer = rng.nextFloat(0.5f, 2.0f);
+
+        // 两成概率停下，否则朝随机方向走；能抛时一半概率向附近抛出猫薄荷
+        if (rng.nextInt(0, 99) < 20) {
+            player.setMoveDirection({0.0f, 0.0f});
+        } else {
+            player.setMoveDirection({rng.nextFloat(-1.0f, 1.0f), rng.nextFloat(-1.0f, 1.0f)});
+        }
+        if (player.getCatnipCooldown() <= 0.0f && rng.nextInt(0, 1) == 0) {
+            Vector2 position = player.getPosition();
+            player.throwCatnipAt({position.x + rng.nextFloat(-200.0f, 200.0f), position.y + rng.nextFloat(-200.0f, 200.0f)});
+        }
+    }
+
+    std::vector<PlayerCommand> commands;
+    Pcg32 rng;
+    size_t nextCommand;
+    float timer;
+};
+
+int main(int argc, char* argv[]) {
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    RandomService& random = RandomService::getInstance();
+    random.setWorldSeed(options.seed);
+    Pcg32& spawnRng = random.stream(RandomStream::SPAWNER);
+
+    std::vector<PlayerCommand> commands;
+    if (!options.scriptPath.empty() && !loadScript(options.scriptPath, commands)) return 1;
+
+    if (!options.speciesPath.empty() && !CatSpecies::loadFromFile(options.speciesPath)) {
+        std::cerr << CatSpecies::getError() << std::endl;
+        return 1;
+    }
+    BehaviorTree behavior;
+    if (!options.behaviorPath.empty() && !behavior.loadFromFile(options.behaviorPath)) {
+        std::cerr << behavior.getError() << std::endl;
+        return 1;
+    }
+
+    // 地图只用于碰撞和寻路，不加载图块集纹理
+    std::unique_ptr<MapLoader> map;
+    std::vector<std::string> mapPaths;
+    if (options.mapPath.empty()) mapPaths = {"assets/maps/grass block.tmx", "../assets/maps/grass block.tmx"};
+    else if (options.mapPath != "none") mapPaths = {options.mapPath};
+    for (const std::string& path : mapPaths) {
+        auto candidate = std::make_unique<MapLoader>();
+        candidate->setTextureLoading(false);
+        if (candidate->loadMap(path)) {
+            std::cout << "地图: " << path << std::endl;
+            map = std::move(candidate);
+            break;
+        }
+    }
+    if (!map) {
+        if (!options.mapPath.empty() && options.mapPath != "none") {
+            std::cerr << "地图加载失败: " << options.mapPath << std::endl;
+            return 1;
+        }
+        std::cout << "地图: 无（" << OPEN_FIELD_SIZE << "x" << OPEN_FIELD_SIZE << " 空地）" << std::endl;
+    }
+    const int mapWidth = map ? map->getMapWidth() : OPEN_FIELD_SIZE;
+    const int mapHeight = map ? map->getMapHeight() : OPEN_FIELD_SIZE;
+
+    // 线程池和寻路服务需比猫咪晚析构
+    std::unique_ptr<JobSystem> jobs;
+    if (options.threads != 1) jobs = std::make_unique<JobSystem>(options.threads == 0 ? 0u : static_cast<unsigned>(options.threads - 1));
+    std::unique_ptr<NavigationSystem> navigation;
+    if (map) {
+        navigation = std::make_unique<NavigationSystem>();
+        navigation->build(*map, {CatSystem::CAT_WIDTH, CatSystem::CAT_HEIGHT});
+    }
+
+    Player player("Headless", {mapWidth / 2.0f, mapHeight / 2.0f});
+    player.setCollisionMap(map.get());
+    PlayerDriver driver(commands, random.split(RandomStream::PLAYER));
+
+    size_t capacity = std::max(CatSystem::DEFAULT_CAPACITY, static_cast<size_t>(options.cats));
+    CatSystem cats(capacity);
+    cats.setTextureLoading(false);
+    cats.setVerbose(options.verbose);
+    cats.setCollisionMap(map.get());
+    cats.setNavigation(navigation.get());
+    cats.setJobSystem(jobs.get());
+    cats.setBehavior(options.behaviorPath.empty() ? nullptr : &behavior);
+
+    std::cout << "模拟: " << options.ticks << " 步, " << options.cats << " 只猫, 种子 " << options.seed
+              << ", " << (jobs ? jobs->getThreadCount() : 1u) << " 个线程, 玩家"
+              << (commands.empty() ? "随机游走" : "按脚本 " + options.scriptPath) << std::endl;
+
+    // 模拟期间关闭游戏日志（生成、抛出、状态切换），只输出统计
+    if (!options.verbose) std::cout.setstate(std::ios::failbit);
+
+    FixedTimestep simClock;
+    const float stepTime = simClock.getStep();
+    std::vector<CatHandle> capturedCats;
+    long long captures = 0;
+    long long spawned = 0;
+    long long catSteps = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 0; tick < options.ticks; tick++) {
+        driver.step(player, stepTime);
+        player.update(stepTime);
+        player.checkBoundaries(mapWidth, mapHeight);
+
+        if (navigation) navigation->update();
+
+        CatWorldSnapshot world;
+        world.playerPosition = player.getPosition();
+        world.playerRect = player.getRect();
+        world.viewRect = {world.playerPosition.x - VIEW_WIDTH / 2.0f, world.playerPosition.y - VIEW_HEIGHT / 2.0f,
+                          VIEW_WIDTH, VIEW_HEIGHT};
+        world.catnipPosition = player.getCatnipPosition();
+        world.hasCatnip = player.isCatnipActive();
+        world.capturedCount = player.getCapturedCount();
+        world.mapWidth = mapWidth;
+        world.mapHeight = mapHeight;
+        cats.update(stepTime, world);
+        catSteps += static_cast<long long>(cats.size());
+
+        // 与游戏相同：沉迷中碰到玩家的猫被抓住并立即回收
+        for (const CatEvent& event : cats.getEvents()) {
+            if (event.type != CatEventType::CAPTURE) continue;
+            Cat cat = cats.get(event.cat);
+            if (!cat.isCaughtStatus()) {
+                cat.setCaught(true);
+                player.incrementCapturedCount();
+                capturedCats.push_back(cat.getHandle());
+                captures++;
+            }
+        }
+        for (CatHandle handle : capturedCats) {
+            cats.release(handle);
+        }
+        capturedCats.clear();
+
+        // 补足猫咪：第一步一次生成全部，之后每步最多一只，与游戏的刷新节奏一致
+        size_t active = cats.countActive();
+        size_t toSpawn = tick == 0 ? static_cast<size_t>(options.cats) : 1;
+        for (size_t i = 0; i < toSpawn && active < static_cast<size_t>(options.cats); i++) {
+            CatType type = static_cast<CatType>(spawnRng.nextInt(0, static_cast<int>(CatSpecies::getCount()) - 1));
+            Vector2 playerPosition = player.getPosition();
+            Rectangle spawnArea = {playerPosition.x - 600.0f, playerPosition.y - 450.0f, 1200.0f, 900.0f};
+            Vector2 position;
+            if (map) {
+                if (!map->findSpawnPosition(spawnArea, {CatSystem::CAT_WIDTH, CatSystem::CAT_HEIGHT}, position)) break;
+            } else {
+                position = {spawnRng.nextFloat(spawnArea.x, spawnArea.x + spawnArea.width),
+                            spawnRng.nextFloat(spawnArea.y, spawnArea.y + spawnArea.height)};
+            }
+            if (cats.spawn("Cat", position, type).isNull()) break;
+            active++;
+            spawned++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout.clear();
+    double simulatedSeconds = options.ticks * static_cast<double>(stepTime);
+    std::cout << "耗时: " << seconds << " 秒 (模拟 " << simulatedSeconds << " 秒)" << std::endl;
+    std::cout << "每秒模拟步数: " << options.ticks / seconds << " (实时倍率 " << simulatedSeconds / seconds << "x)" << std::endl;
+    std::cout << "每步平均: " << seconds * 1000.0 / options.ticks << " 毫秒, 平均 "
+              << static_cast<double>(catSteps) / options.ticks << " 只猫" << std::endl;
+    std::cout << "抓到: " << captures << " 只, 生成: " << spawned << " 只" << std::endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+// meowmon_mapbake：把 Tiled 地图（.tmx / .json）预编译成二进制格式（.mbin）
+// 用法：meowmon_mapbake <输入地图> [输出文件]
+// 不创建窗口，也不加载图块集纹理，只记录图片路径
+
+#include "systems/MapLoader.hpp"
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "用法: " << argv[0] << " <map.tmx|map.json> [output.mbin]" << std::endl;
+        return 1;
+    }
+    
+    std::string inputPath = argv[1];
+    std::string outputPath;
+    if (argc >= 3) {
+        outputPath = argv[2];
+    } else {
+        size_t dot = inputPath.find_last_of('.');
+        size_t slash = inputPath.find_last_of("/\\");
+        bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+        outputPath = (hasExtension ? inputPath.substr(0, dot) : inputPath) + ".mbin";
+    }
+    
+    SetTraceLogLevel(LOG_WARNING);
+    
+    MapLoader mapLoader;
+    mapLoader.setTextureLoading(false);
+    if (!mapLoader.loadMap(inputPath)) {
+        std::cerr << "地图加载失败: " << inputPath << std::endl;
+        return 1;
+    }
+    
+    if (!mapLoader.saveBinary(outputPath)) {
+        std::cerr << "写入失败: " << outputPath << std::endl;
+        return 1;
+    }
+    
+    std::cout << "已生成: " << outputPath << " (" << mapLoader.getLayers().size() << " 个图层)" << std::endl;
+    return 0;
+}